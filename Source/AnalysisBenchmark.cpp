@@ -0,0 +1,355 @@
+/*
+  ==============================================================================
+
+    AnalysisBenchmark.cpp
+    Created: 18 Oct 2026 5:03:44am
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#include "AnalysisBenchmark.h"
+#include "FeatureExtractor.h"
+#include "MeterKernels.h"
+#include <vector>
+
+namespace
+{
+	const double sampleRate = 48000.0;
+
+	// An onset counts as found if it's flagged within this window around the event.
+	const double earliestDetection = -0.01, latestDetection = 0.15;
+
+	// Within 2% of the true tempo counts as locked; a half- or double-time lock doesn't.
+	const double tempoTolerance = 0.02;
+
+	// Known content of a test signal: when its events are and where its beats fall.
+	struct TestSignal
+	{
+		String name, kind;
+		AudioBuffer<float> audio;
+		std::vector<double> onsets;		// Seconds
+		std::vector<double> beats;		// Seconds, empty for a signal with no tempo
+	};
+
+	// What the extractor said after each hop.
+	struct FrameRecord
+	{
+		double time;			// End of the hop, seconds
+		bool onset;
+		double tempo, beatPosition;
+		float tempoConfidence;
+	};
+
+	//==============================================================================
+	void addClick(AudioBuffer<float>& audio, double time, float gain, Random& random)
+	{
+		// A short burst of noise and a 2 kHz tone under a fast decay, like a rim shot.
+		auto start = (int)(time * sampleRate);
+		auto length = (int)(0.03 * sampleRate);
+
+		for (int i = 0; i < length && start + i < audio.getNumSamples(); ++i)
+		{
+			auto t = i / sampleRate;
+			auto envelope = (float)std::exp(-t * 150.0);
+			auto sample = gain * envelope * (0.6f * (float)std::sin(MathConstants<double>::twoPi * 2000.0 * t)
+											 + 0.4f * (random.nextFloat() * 2.0f - 1.0f));
+
+			for (int ch = 0; ch < audio.getNumChannels(); ++ch)
+				audio.addSample(ch, start + i, sample);
+		}
+	}
+
+	// Clicks on every beat, accented on the bar, with the tempo going from
+	// startBpm to endBpm in a straight line over the signal.
+	TestSignal makeClickTrack(double seconds, double startBpm, double endBpm)
+	{
+		TestSignal signal;
+		signal.kind = "click";
+		signal.name = startBpm == endBpm ? "Click " + String(startBpm, 1) + " BPM"
+										 : "Tempo ramp " + String(startBpm, 1) + " to " + String(endBpm, 1) + " BPM";
+		signal.audio.setSize(2, (int)(seconds * sampleRate));
+		signal.audio.clear();
+
+		Random random(0x67726f6f);
+		auto beat = 0;
+
+		for (auto time = 0.25; time < seconds - 0.05; ++beat)
+		{
+			addClick(signal.audio, time, beat % 4 == 0 ? 0.8f : 0.5f, random);
+			signal.onsets.push_back(time);
+			signal.beats.push_back(time);
+
+			time += 60.0 / jmap(time / seconds, startBpm, endBpm);
+		}
+
+		return signal;
+	}
+
+	// A log sweep from 20 Hz to 20 kHz at a steady level: no onsets and no tempo.
+	TestSignal makeSweep(double seconds)
+	{
+		TestSignal signal;
+		signal.kind = "sweep";
+		signal.name = "Sine sweep 20 Hz to 20 kHz";
+		signal.audio.setSize(2, (int)(seconds * sampleRate));
+
+		const auto startHz = 20.0, endHz = 20000.0;
+		auto rate = std::log(endHz / startHz) / seconds;
+		auto fadeSamples = (int)(0.05 * sampleRate);
+
+		for (int i = 0; i < signal.audio.getNumSamples(); ++i)
+		{
+			// Phase is the integral of the instantaneous frequency.
+			auto t = i / sampleRate;
+			auto phase = MathConstants<double>::twoPi * startHz * (std::exp(rate * t) - 1.0) / rate;
+			auto fade = jmin(1.0f, (float)i / fadeSamples);
+			auto sample = 0.5f * fade * (float)std::sin(phase);
+
+			for (int ch = 0; ch < signal.audio.getNumChannels(); ++ch)
+				signal.audio.setSample(ch, i, sample);
+		}
+
+		return signal;
+	}
+
+	// 50 ms bursts of white noise at irregular times, for onset latency without a beat to lean on.
+	TestSignal makeNoiseBursts(double seconds)
+	{
+		TestSignal signal;
+		signal.kind = "noise";
+		signal.name = "Noise bursts";
+		signal.audio.setSize(2, (int)(seconds * sampleRate));
+		signal.audio.clear();
+
+		Random random(0x62757273);
+		auto burstLength = (int)(0.05 * sampleRate);
+
+		for (auto time = 0.5; time < seconds - 0.1; time += 0.4 + 0.6 * random.nextDouble())
+		{
+			auto start = (int)(time * sampleRate);
+			auto gain = 0.2f + 0.6f * random.nextFloat();
+
+			for (int i = 0; i < burstLength && start + i < signal.audio.getNumSamples(); ++i)
+			{
+				auto sample = gain * (random.nextFloat() * 2.0f - 1.0f);
+
+				for (int ch = 0; ch < signal.audio.getNumChannels(); ++ch)
+					signal.audio.setSample(ch, start + i, sample);
+			}
+
+			signal.onsets.push_back(time);
+		}
+
+		return signal;
+	}
+
+	//==============================================================================
+	var describeOnsets(const TestSignal& signal, const std::vector<FrameRecord>& frames)
+	{
+		std::vector<double> detections;
+
+		for (auto& frame : frames)
+			if (frame.onset)
+				detections.push_back(frame.time);
+
+		// Each event takes the first unused detection in its window.
+		std::vector<bool> used(detections.size(), false);
+		auto numFound = 0;
+		auto totalLatency = 0.0, maxLatency = 0.0;
+
+		for (auto event : signal.onsets)
+		{
+			for (size_t i = 0; i < detections.size(); ++i)
+			{
+				auto latency = detections[i] - event;
+
+				if (used[i] || latency < earliestDetection)
+					continue;
+
+				if (latency > latestDetection)
+					break;
+
+				used[i] = true;
+				++numFound;
+				totalLatency += latency;
+				maxLatency = jmax(maxLatency, latency);
+				break;
+			}
+		}
+
+		auto* result = new DynamicObject();
+		result->setProperty("expected", (int)signal.onsets.size());
+		result->setProperty("detected", (int)detections.size());
+		result->setProperty("missed", (int)signal.onsets.size() - numFound);
+		result->setProperty("false", (int)detections.size() - numFound);
+		result->setProperty("meanLatencyMs", numFound > 0 ? var(1000.0 * totalLatency / numFound) : var());
+		result->setProperty("maxLatencyMs", numFound > 0 ? var(1000.0 * maxLatency) : var());
+		return var(result);
+	}
+
+	var describeTempo(const TestSignal& signal, const std::vector<FrameRecord>& frames)
+	{
+		auto* result = new DynamicObject();
+
+		if (signal.beats.size() < 2)
+		{
+			// Nothing to find; a confident tempo here is a false lock.
+			auto maxConfidence = 0.0f;
+
+			for (auto& frame : frames)
+				maxConfidence = jmax(maxConfidence, frame.tempoConfidence);
+
+			result->setProperty("maxConfidence", maxConfidence);
+			return var(result);
+		}
+
+		auto& beats = signal.beats;
+		size_t beat = 0;
+
+		// The last frame that was off the true tempo: the tracker has been locked since.
+		auto lockTime = beats.front();
+		auto numInSpan = 0, numWithin = 0;
+		auto totalError = 0.0;
+
+		for (auto& frame : frames)
+		{
+			if (frame.time < beats.front() || frame.time >= beats.back())
+				continue;
+
+			while (frame.time >= beats[beat + 1])
+				++beat;
+
+			auto period = beats[beat + 1] - beats[beat];
+			auto trueTempo = 60.0 / period;
+			auto within = std::abs(frame.tempo - trueTempo) <= tempoTolerance * trueTempo;
+
+			if (!within)
+				lockTime = frame.time;
+
+			// Only the second half is scored, once the tracker has had a fair chance.
+			if (frame.time >= 0.5 * (beats.front() + beats.back()))
+			{
+				++numInSpan;
+				numWithin += within ? 1 : 0;
+				totalError += std::abs(frame.tempo - trueTempo);
+			}
+		}
+
+		// Phase error while locked, in milliseconds, wrapped to half a beat either way.
+		beat = 0;
+		auto numPhased = 0;
+		auto totalPhaseError = 0.0;
+
+		for (auto& frame : frames)
+		{
+			if (frame.time <= lockTime || frame.time >= beats.back())
+				continue;
+
+			while (frame.time >= beats[beat + 1])
+				++beat;
+
+			auto period = beats[beat + 1] - beats[beat];
+			auto truePhase = (frame.time - beats[beat]) / period;
+			auto error = frame.beatPosition - std::floor(frame.beatPosition) - truePhase;
+			error -= std::round(error);
+
+			totalPhaseError += std::abs(error) * period;
+			++numPhased;
+		}
+
+		result->setProperty("startBpm", 60.0 / (beats[1] - beats[0]));
+		result->setProperty("endBpm", 60.0 / (beats[beats.size() - 1] - beats[beats.size() - 2]));
+		result->setProperty("meanAbsErrorBpm", numInSpan > 0 ? var(totalError / numInSpan) : var());
+		result->setProperty("withinTolerance", numInSpan > 0 ? var((double)numWithin / numInSpan) : var());
+		result->setProperty("lockSeconds", lockTime < beats.back() - 1.0 ? var(lockTime - beats.front()) : var());
+		result->setProperty("meanPhaseErrorMs", numPhased > 0 ? var(1000.0 * totalPhaseError / numPhased) : var());
+		return var(result);
+	}
+
+	//==============================================================================
+	var runSignal(const TestSignal& signal, int blockSize)
+	{
+		FeatureExtractor extractor;
+		extractor.prepare(sampleRate, signal.audio.getNumChannels());
+
+		std::vector<FrameRecord> frames;
+		frames.reserve((size_t)(signal.audio.getNumSamples() / FeatureExtractor::hopSize + 1));
+
+		FeatureExtractor::FrameCallback onFrame = [&frames](const AnalysisFrame& frame)
+		{
+			frames.push_back({ frame.samplePosition / frame.sampleRate, frame.onset,
+							   frame.tempo, frame.beatPosition, frame.tempoConfidence });
+		};
+
+		// Blocks arrive as they would from a deck; only the analysis itself is timed.
+		AudioBuffer<float> block(signal.audio.getNumChannels(), blockSize);
+		int64 ticks = 0;
+
+		for (int done = 0; done < signal.audio.getNumSamples(); done += blockSize)
+		{
+			auto numSamples = jmin(blockSize, signal.audio.getNumSamples() - done);
+
+			for (int ch = 0; ch < block.getNumChannels(); ++ch)
+				block.copyFrom(ch, 0, signal.audio, ch, done, numSamples);
+
+			auto start = Time::getHighResolutionTicks();
+			extractor.process(block, numSamples, onFrame);
+			ticks += Time::getHighResolutionTicks() - start;
+		}
+
+		auto audioSeconds = signal.audio.getNumSamples() / sampleRate;
+		auto cpuSeconds = Time::highResolutionTicksToSeconds(ticks);
+
+		auto* result = new DynamicObject();
+		result->setProperty("name", signal.name);
+		result->setProperty("kind", signal.kind);
+		result->setProperty("seconds", audioSeconds);
+		result->setProperty("cpuMsPerSecond", 1000.0 * cpuSeconds / audioSeconds);
+		result->setProperty("realtimeFactor", cpuSeconds > 0.0 ? var(audioSeconds / cpuSeconds) : var());
+		result->setProperty("onsets", describeOnsets(signal, frames));
+		result->setProperty("tempo", describeTempo(signal, frames));
+		return var(result);
+	}
+}
+
+//==============================================================================
+int AnalysisBenchmark::runFromCommandLine(const String& commandLine, std::ostream& out)
+{
+	auto args = StringArray::fromTokens(commandLine, true);
+	auto secondsIndex = args.indexOf("--seconds") + 1;
+	auto blockSizeIndex = args.indexOf("--block-size") + 1;
+
+	auto seconds = secondsIndex > 0 ? args[secondsIndex].getDoubleValue() : 60.0;
+	auto blockSize = blockSizeIndex > 0 ? args[blockSizeIndex].getIntValue() : 512;
+
+	if (seconds < 10.0 || blockSize < 16 || blockSize > 8192)
+	{
+		out << "Usage: Groov --benchmark-analysis [--seconds <at least 10>] [--block-size <16 to 8192>]" << std::endl;
+		return 1;
+	}
+
+	out << JSON::toString(run(seconds, blockSize)) << std::endl;
+	return 0;
+}
+
+var AnalysisBenchmark::run(double secondsPerSignal, int blockSize)
+{
+	Array<var> results;
+
+	for (auto bpm : { 90.0, 120.0, 128.0, 140.0, 174.0 })
+		results.add(runSignal(makeClickTrack(secondsPerSignal, bpm, bpm), blockSize));
+
+	results.add(runSignal(makeClickTrack(secondsPerSignal, 120.0, 132.0), blockSize));
+	results.add(runSignal(makeSweep(secondsPerSignal), blockSize));
+	results.add(runSignal(makeNoiseBursts(secondsPerSignal), blockSize));
+
+	auto* report = new DynamicObject();
+	report->setProperty("version", ProjectInfo::versionString);
+	report->setProperty("kernels", MeterKernels::get().name);
+	report->setProperty("sampleRate", sampleRate);
+	report->setProperty("blockSize", blockSize);
+	report->setProperty("hopSize", (int)FeatureExtractor::hopSize);
+	report->setProperty("signals", results);
+	return var(report);
+}
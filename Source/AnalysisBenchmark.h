@@ -0,0 +1,39 @@
+/*
+  ==============================================================================
+
+    AnalysisBenchmark.h
+    Created: 18 Oct 2026 5:03:44am
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <ostream>
+
+//==============================================================================
+/**
+	Runs synthetic test signals through the live analysis and checks it against
+	what they're known to contain: click tracks at fixed tempos, a tempo ramp,
+	a swept sine and noise bursts.
+
+	Each signal goes through the FeatureExtractor that GroovAnalyser's thread
+	runs, in device-sized blocks, as fast as it will go. For each one the report
+	gives the onset detection latency (from the event to the end of the hop that
+	flags it) with missed and false detections, the tempo error, how long the
+	tracker takes to lock and its beat phase error once it has, and the
+	processing time per second of audio.
+
+	The report is JSON, so runs on different builds and machines can be
+	compared. Run it with "Groov --benchmark-analysis [--seconds <n>]
+	[--block-size <n>]".
+*/
+struct AnalysisBenchmark
+{
+	/** Writes the report to out and returns 0, or prints usage and returns 1. */
+	static int runFromCommandLine(const String& commandLine, std::ostream& out);
+
+	static var run(double secondsPerSignal, int blockSize);
+};
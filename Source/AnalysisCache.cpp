@@ -0,0 +1,358 @@
+/*
+  ==============================================================================
+
+    AnalysisCache.cpp
+    Created: 17 Oct 2026 2:51:30pm
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#include "AnalysisCache.h"
+#include <type_traits>
+
+namespace
+{
+	const char cacheMagic[8] = { 'G', 'R', 'O', 'O', 'V', 'C', 'A', 'C' };
+	const char* cacheExtension = ".groovanalysis";
+
+	enum { hashSize = 32, chunkAlignment = 16 };
+
+	struct FileHeader
+	{
+		char magic[8];
+		uint32 formatVersion;
+		uint32 headerSize;				// Catches a struct layout change that forgot to bump the version
+		uint8 contentHash[hashSize];
+
+		double sampleRate, lengthInSeconds, tempo, envelopeRate;
+		int32 beatsPerBar, numBands, key;
+		float keyConfidence;
+		TrackAnalysis::Loudness loudness;
+
+		uint32 numChunks;
+		uint32 chunkTableOffset;
+	};
+
+	struct ChunkEntry
+	{
+		char id[4];
+		uint32 elementSize;
+		uint64 offset;
+		uint64 numElements;
+	};
+
+	static_assert(std::is_trivially_copyable<FileHeader>::value, "The header is written and mapped as raw bytes");
+
+	// A chunk waiting to be written: where its elements are and how big they are.
+	struct PendingChunk
+	{
+		const char* id;
+		uint32 elementSize;
+		const void* data;
+		uint64 numElements;
+	};
+
+	template <typename ElementType>
+	PendingChunk chunk(const char* id, const TrackSeries<ElementType>& series)
+	{
+		static_assert(std::is_trivially_copyable<ElementType>::value, "Chunks are written and mapped as raw bytes");
+		return { id, (uint32)sizeof(ElementType), series.data(), (uint64)series.size() };
+	}
+
+	uint64 alignUp(uint64 offset)
+	{
+		return (offset + chunkAlignment - 1) & ~(uint64)(chunkAlignment - 1);
+	}
+
+	// Points a series into the mapped file, after checking the chunk really fits.
+	template <typename ElementType>
+	bool mapChunk(const MemoryMappedFile& file, const ChunkEntry* table, uint32 numChunks,
+				  const char* id, TrackSeries<ElementType>& series, bool required)
+	{
+		auto* base = static_cast<const char*>(file.getData());
+		auto fileSize = (uint64)file.getSize();
+
+		for (uint32 i = 0; i < numChunks; ++i)
+		{
+			auto& entry = table[i];
+
+			if (std::memcmp(entry.id, id, 4) != 0)
+				continue;
+
+			if (entry.elementSize != sizeof(ElementType)
+				|| entry.offset % alignof(ElementType) != 0
+				|| entry.offset > fileSize
+				|| entry.numElements > (fileSize - entry.offset) / sizeof(ElementType))
+				return false;
+
+			series.referTo(reinterpret_cast<const ElementType*>(base + entry.offset), (size_t)entry.numElements);
+			return true;
+		}
+
+		return !required;
+	}
+
+	// Mapped indices are only as trustworthy as the file: each has to land inside its target series.
+	bool waveformLevelsFit(const TrackAnalysis& analysis)
+	{
+		auto numPoints = (int64)analysis.waveform.size();
+
+		for (auto& level : analysis.waveformLevels)
+			if (level.samplesPerPoint <= 0 || level.firstPoint < 0 || level.numPoints <= 0
+				|| (int64)level.firstPoint + level.numPoints > numPoints)
+				return false;
+
+		return true;
+	}
+
+	bool downbeatsFit(const TrackAnalysis& analysis)
+	{
+		auto numBeats = (int32)analysis.beats.size();
+
+		for (auto downbeat : analysis.downbeats)
+			if (downbeat < 0 || downbeat >= numBeats)
+				return false;
+
+		return true;
+	}
+}
+
+//==============================================================================
+AnalysisCache::ContentHash AnalysisCache::hashFile(const File& audioFile)
+{
+	FileInputStream input(audioFile);
+
+	if (input.failedToOpen())
+		return {};
+
+	auto* job = ThreadPoolJob::getCurrentThreadPoolJob();
+	MemoryBlock blockHashes;
+
+	// A block at a time, so a cancelled job doesn't have to read the rest of a long file first.
+	do
+	{
+		if (job != nullptr && job->shouldExit())
+			return {};
+
+		auto blockHash = SHA256(input, hashBlockSize).getRawData();
+		blockHashes.append(blockHash.getData(), blockHash.getSize());
+	}
+	while (!input.isExhausted());
+
+	return SHA256(blockHashes).getRawData();
+}
+
+File AnalysisCache::getSidecarFile(const File& audioFile)
+{
+	return audioFile.getSiblingFile(audioFile.getFileName() + cacheExtension);
+}
+
+File AnalysisCache::getSharedCacheFile(const ContentHash& hash)
+{
+	return File::getSpecialLocation(File::userApplicationDataDirectory)
+		.getChildFile("Groov")
+		.getChildFile("AnalysisCache")
+		.getChildFile(String::toHexString(hash.getData(), (int)hash.getSize(), 0) + cacheExtension);
+}
+
+std::shared_ptr<TrackAnalysis> AnalysisCache::load(const File& audioFile, const ContentHash& hash, Result& result)
+{
+	if (auto analysis = loadFrom(getSidecarFile(audioFile), hash, result))
+		return analysis;
+
+	auto sidecarResult = result;
+
+	if (auto analysis = loadFrom(getSharedCacheFile(hash), hash, result))
+		return analysis;
+
+	// The sidecar's reason is usually the more interesting one.
+	if (sidecarResult.failed())
+		result = sidecarResult;
+
+	return nullptr;
+}
+
+Result AnalysisCache::save(const TrackAnalysis& analysis, const File& audioFile, const ContentHash& hash)
+{
+	auto result = writeTo(getSidecarFile(audioFile), analysis, hash);
+
+	if (result.wasOk())
+		return result;
+
+	// Read-only music folder (a USB stick, a network share): fall back to our own folder.
+	auto sharedFile = getSharedCacheFile(hash);
+	sharedFile.getParentDirectory().createDirectory();
+
+	return writeTo(sharedFile, analysis, hash);
+}
+
+std::shared_ptr<TrackAnalysis> AnalysisCache::loadFrom(const File& cacheFile, const ContentHash& hash, Result& result)
+{
+	if (!cacheFile.existsAsFile())
+	{
+		result = Result::fail("No cached analysis");
+		return nullptr;
+	}
+
+	auto mapped = std::make_shared<MemoryMappedFile>(cacheFile, MemoryMappedFile::readOnly);
+
+	if (mapped->getData() == nullptr || mapped->getSize() < sizeof(FileHeader))
+	{
+		result = Result::fail("Couldn't map " + cacheFile.getFileName());
+		return nullptr;
+	}
+
+	auto& header = *static_cast<const FileHeader*>(mapped->getData());
+
+	if (std::memcmp(header.magic, cacheMagic, sizeof(cacheMagic)) != 0)
+	{
+		result = Result::fail(cacheFile.getFileName() + " isn't an analysis cache");
+		return nullptr;
+	}
+
+	if (header.formatVersion != formatVersion || header.headerSize != sizeof(FileHeader))
+	{
+		result = Result::fail(cacheFile.getFileName() + " has format version " + String(header.formatVersion)
+							  + ", expected " + String(formatVersion));
+		return nullptr;
+	}
+
+	if (hash.getSize() != hashSize || std::memcmp(header.contentHash, hash.getData(), hashSize) != 0)
+	{
+		result = Result::fail(cacheFile.getFileName() + " was made from a different version of the track");
+		return nullptr;
+	}
+
+	if (header.numBands != TrackAnalysis::numBands
+		|| header.chunkTableOffset % alignof(ChunkEntry) != 0
+		|| header.chunkTableOffset > mapped->getSize()
+		|| header.numChunks > (mapped->getSize() - header.chunkTableOffset) / sizeof(ChunkEntry))
+	{
+		result = Result::fail(cacheFile.getFileName() + " is damaged");
+		return nullptr;
+	}
+
+	auto analysis = std::make_shared<TrackAnalysis>();
+	analysis->sampleRate = header.sampleRate;
+	analysis->lengthInSeconds = header.lengthInSeconds;
+	analysis->tempo = header.tempo;
+	analysis->envelopeRate = header.envelopeRate;
+	analysis->beatsPerBar = header.beatsPerBar;
+	analysis->key = header.key;
+	analysis->keyConfidence = header.keyConfidence;
+	analysis->loudness = header.loudness;
+
+	auto* table = reinterpret_cast<const ChunkEntry*>(static_cast<const char*>(mapped->getData()) + header.chunkTableOffset);
+	auto numChunks = header.numChunks;
+
+	auto ok = mapChunk(*mapped, table, numChunks, "BEAT", analysis->beats, true)
+		   && mapChunk(*mapped, table, numChunks, "DOWN", analysis->downbeats, true)
+		   && mapChunk(*mapped, table, numChunks, "SECT", analysis->sections, true)
+		   && mapChunk(*mapped, table, numChunks, "ENRG", analysis->energy, true)
+		   && mapChunk(*mapped, table, numChunks, "BAND", analysis->bandEnergy, true)
+		   && mapChunk(*mapped, table, numChunks, "WAVL", analysis->waveformLevels, true)
+		   && mapChunk(*mapped, table, numChunks, "WAVE", analysis->waveform, true);
+
+	if (!ok || !waveformLevelsFit(*analysis) || !downbeatsFit(*analysis))
+	{
+		result = Result::fail(cacheFile.getFileName() + " is damaged");
+		return nullptr;
+	}
+
+	// The series point into the mapping, so it has to live as long as the analysis.
+	analysis->storage = mapped;
+
+	result = Result::ok();
+	return analysis;
+}
+
+Result AnalysisCache::writeTo(const File& cacheFile, const TrackAnalysis& analysis, const ContentHash& hash)
+{
+	const PendingChunk chunks[] =
+	{
+		chunk("BEAT", analysis.beats),
+		chunk("DOWN", analysis.downbeats),
+		chunk("SECT", analysis.sections),
+		chunk("ENRG", analysis.energy),
+		chunk("BAND", analysis.bandEnergy),
+		chunk("WAVL", analysis.waveformLevels),
+		chunk("WAVE", analysis.waveform)
+	};
+
+	const auto numChunks = (uint32)numElementsInArray(chunks);
+
+	FileHeader header {};
+	std::memcpy(header.magic, cacheMagic, sizeof(cacheMagic));
+	header.formatVersion = formatVersion;
+	header.headerSize = sizeof(FileHeader);
+	std::memcpy(header.contentHash, hash.getData(), jmin((size_t)hashSize, hash.getSize()));
+	header.sampleRate = analysis.sampleRate;
+	header.lengthInSeconds = analysis.lengthInSeconds;
+	header.tempo = analysis.tempo;
+	header.envelopeRate = analysis.envelopeRate;
+	header.beatsPerBar = analysis.beatsPerBar;
+	header.numBands = TrackAnalysis::numBands;
+	header.key = analysis.key;
+	header.keyConfidence = analysis.keyConfidence;
+	header.loudness = analysis.loudness;
+	header.numChunks = numChunks;
+	header.chunkTableOffset = (uint32)alignUp(sizeof(FileHeader));
+
+	HeapBlock<ChunkEntry> table(numChunks, true);
+	auto tableSize = sizeof(ChunkEntry) * numChunks;
+	auto offset = alignUp(header.chunkTableOffset + tableSize);
+
+	for (uint32 i = 0; i < numChunks; ++i)
+	{
+		std::memcpy(table[i].id, chunks[i].id, 4);
+		table[i].elementSize = chunks[i].elementSize;
+		table[i].offset = offset;
+		table[i].numElements = chunks[i].numElements;
+
+		offset = alignUp(offset + chunks[i].elementSize * chunks[i].numElements);
+	}
+
+	// Write next to the real file and swap it in, so a reader never maps half a cache.
+	auto tempFile = cacheFile.getSiblingFile(cacheFile.getFileName() + ".tmp");
+
+	{
+		FileOutputStream out(tempFile);
+
+		if (!out.openedOk())
+			return Result::fail("Couldn't write " + tempFile.getFullPathName());
+
+		out.setPosition(0);
+		out.truncate();
+
+		auto padTo = [&out](uint64 position)
+		{
+			auto padding = (int64)position - out.getPosition();
+			return padding <= 0 || out.writeRepeatedByte(0, (size_t)padding);
+		};
+
+		auto ok = out.write(&header, sizeof(header))
+			   && padTo(header.chunkTableOffset)
+			   && out.write(table, tableSize);
+
+		for (uint32 i = 0; ok && i < numChunks; ++i)
+			ok = padTo(table[i].offset)
+			  && out.write(chunks[i].data, (size_t)(chunks[i].elementSize * chunks[i].numElements));
+
+		out.flush();
+
+		if (!ok || out.getStatus().failed())
+		{
+			tempFile.deleteFile();
+			return Result::fail("Couldn't write " + tempFile.getFullPathName());
+		}
+	}
+
+	if (!tempFile.moveFileTo(cacheFile))
+	{
+		tempFile.deleteFile();
+		return Result::fail("Couldn't replace " + cacheFile.getFullPathName());
+	}
+
+	return Result::ok();
+}
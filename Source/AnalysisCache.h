@@ -0,0 +1,59 @@
+/*
+  ==============================================================================
+
+    AnalysisCache.h
+    Created: 17 Oct 2026 2:51:30pm
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "TrackAnalysis.h"
+
+//==============================================================================
+/**
+	Binary sidecar files holding a track's TrackAnalysis, so a track only ever
+	has to be analysed once.
+
+	A cache file is keyed by a SHA-256 of the audio file's contents and laid
+	out so it can be memory-mapped and used in place: a fixed header, a table
+	of chunks, then each chunk's array 16-byte aligned. Loading maps the file
+	and points the TrackAnalysis series straight into it, nothing is copied.
+
+	The file lives next to the track ("Track.mp3.groovanalysis"), or in the
+	user's app data folder under its hash when the track's folder is read-only.
+
+	Files are native little-endian. A file with the wrong magic, format version,
+	hash or chunk layout is rejected and the track is analysed again.
+*/
+struct AnalysisCache
+{
+	// Bump whenever the layout or the meaning of any chunk changes.
+	static constexpr uint32 formatVersion = 4;
+
+	using ContentHash = MemoryBlock;
+
+	/** SHA-256 of the SHA-256s of each hashBlockSize bytes of the file. Reads the
+		whole file, so keep it off the message thread. Called from a ThreadPoolJob,
+		it gives up between blocks once the job's told to exit, and returns an
+		empty hash, as it does if the file can't be read. */
+	static ContentHash hashFile(const File& audioFile);
+	enum { hashBlockSize = 4 * 1024 * 1024 };
+
+	/** Maps a cache for audioFile if a valid one exists. On failure returns nullptr
+		and says why in result. */
+	static std::shared_ptr<TrackAnalysis> load(const File& audioFile, const ContentHash& hash, Result& result);
+
+	/** Writes analysis to the sidecar, or to the shared cache folder if that fails. */
+	static Result save(const TrackAnalysis& analysis, const File& audioFile, const ContentHash& hash);
+
+	static File getSidecarFile(const File& audioFile);
+	static File getSharedCacheFile(const ContentHash& hash);
+
+private:
+	static std::shared_ptr<TrackAnalysis> loadFrom(const File& cacheFile, const ContentHash& hash, Result& result);
+	static Result writeTo(const File& cacheFile, const TrackAnalysis& analysis, const ContentHash& hash);
+};
@@ -0,0 +1,115 @@
+/*
+  ==============================================================================
+
+    AnalysisFifo.h
+    Created: 17 Oct 2026 10:02:11am
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+	Single-producer/single-consumer sample queue that carries audio from the
+	audio callback to the analysis thread.
+
+	The audio thread only ever calls push(), the analysis thread only ever calls
+	pop(). Both are wait-free: there are no locks and nothing is allocated after
+	prepare(). If the analysis thread falls behind, whole blocks are dropped
+	rather than blocking the callback, and getNumDroppedBlocks() says how many.
+*/
+class AnalysisFifo
+{
+public:
+	AnalysisFifo() = default;
+
+	/** Allocates room for numBlocks blocks of maxBlockSize samples. Must not be
+		called while either side is running. */
+	void prepare(int numChannels, int maxBlockSize, int numBlocks)
+	{
+		auto capacity = nextPowerOfTwo(jmax(1, maxBlockSize) * jmax(2, numBlocks));
+
+		buffer.setSize(jmax(1, numChannels), capacity);
+		buffer.clear();
+		fifo.setTotalSize(capacity);
+		fifo.reset();
+
+		droppedBlocks = 0;
+		pushedBlocks = 0;
+	}
+
+	/** Audio thread: copies a block into the queue, or drops it if there isn't room. */
+	bool push(const AudioBuffer<float>& source, int startSample, int numSamples) noexcept
+	{
+		if (source.getNumChannels() == 0 || numSamples <= 0)
+			return false;
+
+		if (fifo.getFreeSpace() < numSamples)
+		{
+			droppedBlocks.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+
+		int start1, size1, start2, size2;
+		fifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+
+		auto numSourceChannels = source.getNumChannels();
+
+		for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+		{
+			// Mono sources are duplicated so the consumer never has to care.
+			auto srcChannel = jmin(ch, numSourceChannels - 1);
+
+			if (size1 > 0)
+				buffer.copyFrom(ch, start1, source, srcChannel, startSample, size1);
+
+			if (size2 > 0)
+				buffer.copyFrom(ch, start2, source, srcChannel, startSample + size1, size2);
+		}
+
+		fifo.finishedWrite(size1 + size2);
+		pushedBlocks.fetch_add(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	/** Analysis thread: moves up to dest.getNumSamples() samples into dest and
+		returns how many were read. */
+	int pop(AudioBuffer<float>& dest) noexcept
+	{
+		int start1, size1, start2, size2;
+		fifo.prepareToRead(jmin(dest.getNumSamples(), fifo.getNumReady()), start1, size1, start2, size2);
+
+		auto numChannels = jmin(dest.getNumChannels(), buffer.getNumChannels());
+
+		for (int ch = 0; ch < numChannels; ++ch)
+		{
+			if (size1 > 0)
+				dest.copyFrom(ch, 0, buffer, ch, start1, size1);
+
+			if (size2 > 0)
+				dest.copyFrom(ch, size1, buffer, ch, start2, size2);
+		}
+
+		fifo.finishedRead(size1 + size2);
+		return size1 + size2;
+	}
+
+	int getNumReady() const noexcept		{ return fifo.getNumReady(); }
+	int getNumChannels() const noexcept		{ return buffer.getNumChannels(); }
+	int getCapacity() const noexcept		{ return fifo.getTotalSize(); }
+
+	uint32 getNumDroppedBlocks() const noexcept	{ return droppedBlocks.load(std::memory_order_relaxed); }
+	uint32 getNumPushedBlocks() const noexcept	{ return pushedBlocks.load(std::memory_order_relaxed); }
+
+private:
+	AbstractFifo fifo{ 1 };
+	AudioBuffer<float> buffer;
+
+	std::atomic<uint32> droppedBlocks{ 0 }, pushedBlocks{ 0 };
+
+	JUCE_DECLARE_NON_COPYABLE(AnalysisFifo)
+};
@@ -0,0 +1,80 @@
+/*
+  ==============================================================================
+
+    BandMeter.cpp
+    Created: 17 Oct 2026 5:20:41pm
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#include "BandMeter.h"
+
+constexpr double BandMeter::attackTime, BandMeter::releaseTime, BandMeter::peakHoldTime, BandMeter::peakFallTime;
+constexpr double BandMeter::lowestFrequency, BandMeter::highestFrequency;
+
+void BandMeter::prepare(double newSampleRate, int numBands)
+{
+	sampleRate = newSampleRate;
+	numBands = jlimit((int)minBands, (int)maxBands, numBands);
+	bank.setNumBands(numBands);
+
+	auto highest = jmin(highestFrequency, sampleRate * 0.45);
+	auto ratio = std::pow(highest / lowestFrequency, 1.0 / (numBands - 1));
+
+	// Wide enough that neighbouring bands cross about 3 dB down.
+	auto q = std::sqrt(ratio) / (ratio - 1.0);
+
+	for (int band = 0; band < numBands; ++band)
+	{
+		centreFrequencies[band] = lowestFrequency * std::pow(ratio, (double)band);
+		bank.setBandPass(band, sampleRate, centreFrequencies[band], q);
+	}
+
+	reset();
+}
+
+void BandMeter::reset()
+{
+	bank.reset();
+	samplesThisHop = 0;
+
+	for (auto* values : { hopSumSquares, hopPeaks, levels, envelopes, heldPeaks, peakAges })
+		FloatVectorOperations::clear(values, maxBands);
+}
+
+void BandMeter::process(const float* input, int numSamples)
+{
+	if (numSamples <= 0)
+		return;
+
+	ScopedNoDenormals noDenormals;
+	kernels.filterBands(bank, input, numSamples, hopSumSquares, hopPeaks);
+	samplesThisHop += numSamples;
+}
+
+void BandMeter::finishHop()
+{
+	if (samplesThisHop == 0)
+		return;
+
+	auto numBands = bank.getNumBands();
+
+	// A band-passed sine keeps its level but its RMS is 1/sqrt(2) of the peak.
+	FloatVectorOperations::multiply(hopSumSquares, 2.0f / (float)samplesThisHop, numBands);
+
+	for (int band = 0; band < numBands; ++band)
+		levels[band] = std::sqrt(hopSumSquares[band]);
+
+	auto seconds = samplesThisHop / sampleRate;
+	auto attack = (float)(1.0 - std::exp(-seconds / attackTime));
+	auto release = (float)(1.0 - std::exp(-seconds / releaseTime));
+	auto decay = (float)std::exp(-seconds / peakFallTime);
+
+	kernels.followEnvelopes(envelopes, levels, numBands, attack, release);
+	kernels.holdPeaks(heldPeaks, peakAges, hopPeaks, numBands, (float)seconds, (float)peakHoldTime, decay);
+
+	FloatVectorOperations::clear(hopSumSquares, maxBands);
+	FloatVectorOperations::clear(hopPeaks, maxBands);
+	samplesThisHop = 0;
+}
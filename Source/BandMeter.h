@@ -0,0 +1,74 @@
+/*
+  ==============================================================================
+
+    BandMeter.h
+    Created: 17 Oct 2026 5:20:41pm
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "MeterKernels.h"
+
+//==============================================================================
+/**
+	Splits a mono signal into log-spaced band-pass bands and meters each one:
+	RMS level, an attack/release envelope for smooth visuals, and a held peak.
+
+	Feed it audio with process() in any block size, then call finishHop() once
+	per meter update to turn what has accumulated into levels. The filtering
+	runs through MeterKernels, so many bands cost little more than a few.
+*/
+class BandMeter
+{
+public:
+	enum { minBands = 8, maxBands = BiquadBank::maxBands };
+
+	/** Uses the fastest kernels by default; the benchmark passes others in. */
+	explicit BandMeter(const MeterKernels& kernelsToUse = MeterKernels::get()) : kernels(kernelsToUse) {}
+
+	void prepare(double sampleRate, int numBands);
+	void reset();
+
+	/** Filters numSamples of mono input into the running band totals. */
+	void process(const float* input, int numSamples);
+
+	/** Closes off everything processed since the last call and updates the
+		levels, envelopes and held peaks. */
+	void finishHop();
+
+	int getNumBands() const noexcept						{ return bank.getNumBands(); }
+	double getCentreFrequency(int band) const noexcept		{ return centreFrequencies[band]; }
+
+	// numBands values each, low to high. Linear, scaled so a full-scale sine at a band's centre reads ~1.0.
+	const float* getLevels() const noexcept		{ return levels; }
+	const float* getEnvelopes() const noexcept	{ return envelopes; }
+	const float* getPeaks() const noexcept		{ return heldPeaks; }
+
+	// Envelope and peak hold timing, in seconds.
+	static constexpr double attackTime = 0.01, releaseTime = 0.25, peakHoldTime = 1.0, peakFallTime = 1.5;
+
+	// Band centres are spread evenly in log frequency across this range.
+	static constexpr double lowestFrequency = 40.0, highestFrequency = 16000.0;
+
+private:
+	const MeterKernels& kernels;
+	BiquadBank bank;
+	double centreFrequencies[maxBands] = {};
+	double sampleRate = 44100.0;
+
+	int samplesThisHop = 0;
+
+	// Padded to whole vector blocks, like the bank itself.
+	alignas(32) float hopSumSquares[maxBands] = {};
+	alignas(32) float hopPeaks[maxBands] = {};
+	alignas(32) float levels[maxBands] = {};
+	alignas(32) float envelopes[maxBands] = {};
+	alignas(32) float heldPeaks[maxBands] = {};
+	alignas(32) float peakAges[maxBands] = {};
+
+	JUCE_DECLARE_NON_COPYABLE(BandMeter)
+};
@@ -0,0 +1,145 @@
+/*
+  ==============================================================================
+
+    BatchAnalyser.cpp
+    Created: 17 Oct 2026 9:52:23pm
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#include "BatchAnalyser.h"
+#include "TrackAnalysisJob.h"
+
+namespace
+{
+	String formatRate(int numTracks, double elapsedSeconds)
+	{
+		return String(numTracks / jmax(1.0 / 60.0, elapsedSeconds / 60.0), 1) + " tracks/minute";
+	}
+}
+
+int BatchAnalyser::run(const File& folder, int numThreads, std::ostream& out)
+{
+	AudioFormatManager formatManager;
+	formatManager.registerBasicFormats();
+
+	auto files = folder.findChildFiles(File::findFiles, true, formatManager.getWildcardForAllFormats());
+	files.sort();
+
+	out << "Analysing " << files.size() << " files in " << folder.getFullPathName()
+		<< " on " << numThreads << " threads" << std::endl;
+
+	// Nobody polls progress here, so every job shares one.
+	std::atomic<float> progress{ 0.0f };
+	std::atomic<int> numAnalysed{ 0 }, numCached{ 0 }, numNotSaved{ 0 };
+	std::atomic<int64> millisecondsAnalysed{ 0 };
+
+	// Written by the jobs, printed from this thread so lines don't interleave.
+	CriticalSection errorLock;
+	StringArray errors;
+
+	auto printErrors = [&]
+	{
+		const ScopedLock sl(errorLock);
+
+		for (auto& error : errors)
+			out << error << std::endl;
+
+		errors.clear();
+	};
+
+	// Declared after everything its jobs write to, so they're gone first.
+	ThreadPool pool(numThreads);
+
+	auto onFinished = [&](std::shared_ptr<TrackAnalysis> analysis)
+	{
+		// A mapped analysis came out of the cache; a fresh one was just written to it.
+		if (analysis->storage != nullptr)
+		{
+			++numCached;
+		}
+		else
+		{
+			++numAnalysed;
+			millisecondsAnalysed += (int64)(analysis->lengthInSeconds * 1000.0);
+		}
+	};
+
+	auto startTime = Time::getMillisecondCounterHiRes();
+	auto lastReportTime = startTime;
+	int next = 0;
+
+	// Only a couple of jobs per thread at a time, so a big library doesn't mean
+	// thousands of open readers.
+	while (next < files.size() || pool.getNumJobs() > 0)
+	{
+		while (next < files.size() && pool.getNumJobs() < numThreads * 2)
+		{
+			auto file = files[next++];
+
+			if (auto* reader = formatManager.createReaderFor(file))
+			{
+				auto* job = new TrackAnalysisJob(file, reader, progress, onFinished);
+
+				// Analysed but not cached is no use to the gig, so it counts as a failure.
+				job->onSaveFailed = [&, file](const Result& result)
+				{
+					++numNotSaved;
+
+					const ScopedLock sl(errorLock);
+					errors.add("Couldn't cache " + file.getFullPathName() + ": " + result.getErrorMessage());
+				};
+
+				pool.addJob(job, true);
+			}
+			else
+			{
+				out << "Can't read " << file.getFullPathName() << std::endl;
+			}
+		}
+
+		Thread::sleep(50);
+		printErrors();
+
+		auto now = Time::getMillisecondCounterHiRes();
+
+		if (now - lastReportTime >= 5000.0)
+		{
+			out << numAnalysed + numCached << " of " << files.size() << " done, "
+				<< formatRate(numAnalysed, (now - startTime) * 0.001) << " analysed" << std::endl;
+			lastReportTime = now;
+		}
+	}
+
+	printErrors();
+
+	auto elapsedSeconds = (Time::getMillisecondCounterHiRes() - startTime) * 0.001;
+	auto numFailed = files.size() - numAnalysed - numCached + numNotSaved;
+	auto audioSeconds = millisecondsAnalysed * 0.001;
+
+	out << "Analysed " << numAnalysed << " tracks (" << String(audioSeconds / 60.0, 1) << " minutes of audio, "
+		<< String(audioSeconds / jmax(0.001, elapsedSeconds), 1) << "x real time), "
+		<< numNotSaved << " of them not cached, " << numCached << " already cached, " << numFailed << " failed" << std::endl
+		<< "Took " << String(elapsedSeconds, 1) << " s: " << formatRate(numAnalysed, elapsedSeconds) << " analysed" << std::endl;
+
+	return numFailed;
+}
+
+int BatchAnalyser::runFromCommandLine(const String& commandLine, std::ostream& out)
+{
+	auto args = StringArray::fromTokens(commandLine, true);
+	auto folderIndex = args.indexOf("--analyse-library") + 1;
+	auto threadsIndex = args.indexOf("--threads") + 1;
+
+	auto folder = File::getCurrentWorkingDirectory().getChildFile(args[folderIndex].unquoted());
+	auto numThreads = threadsIndex > 0 ? args[threadsIndex].getIntValue() : SystemStats::getNumCpus();
+
+	if (folderIndex >= args.size() || !folder.isDirectory())
+	{
+		out << "Usage: Groov --analyse-library <folder> [--threads <n>]" << std::endl;
+		return 1;
+	}
+
+	return run(folder, jlimit(1, 64, numThreads), out);
+}
@@ -0,0 +1,37 @@
+/*
+  ==============================================================================
+
+    BatchAnalyser.h
+    Created: 17 Oct 2026 9:52:23pm
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <ostream>
+
+//==============================================================================
+/**
+	Pre-analyses a whole music library into the AnalysisCache, so tracks are
+	ready the moment they're loaded at a gig.
+
+	Walks a folder for every file the basic formats can read and runs each one
+	through a TrackAnalysisJob on a pool of worker threads. Tracks the cache
+	already has are hashed and skipped. Needs no audio device and no display:
+	run it with "Groov --analyse-library <folder> [--threads <n>]".
+
+	Blocks until every file is done, printing progress, any track that couldn't
+	be cached, and finally a summary with tracks analysed per minute.
+*/
+struct BatchAnalyser
+{
+	/** Returns the number of files that couldn't be analysed, or were analysed
+		but couldn't be written to the cache. */
+	static int run(const File& folder, int numThreads, std::ostream& out);
+
+	/** Picks the folder and thread count out of the command line and runs. */
+	static int runFromCommandLine(const String& commandLine, std::ostream& out);
+};
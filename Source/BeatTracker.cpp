@@ -0,0 +1,226 @@
+/*
+  ==============================================================================
+
+    BeatTracker.cpp
+    Created: 17 Oct 2026 11:32:45am
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#include "BeatTracker.h"
+#include "FeatureExtractor.h"
+
+namespace
+{
+	// One-pole smoothing coefficient for a given time constant in frames.
+	double onePole(double timeConstantFrames)
+	{
+		return 1.0 - std::exp(-1.0 / jmax(1.0, timeConstantFrames));
+	}
+
+	// Wraps a phase difference (in beats) into [-0.5, 0.5).
+	double wrapPhase(double p)
+	{
+		return p - std::floor(p + 0.5);
+	}
+
+	const float fluxCompression = 100.0f;
+	const float onsetThreshold = 1.5f;
+	const double tempoPriorCentre = 120.0, tempoPriorWidthOctaves = 0.7;
+}
+
+void BeatTracker::prepare(double sampleRate, int hopSize)
+{
+	frameRate = sampleRate / (double)hopSize;
+
+	auto binWidth = sampleRate / (double)AnalysisFrame::fftSize;
+	minBin = jmax(1, (int)(30.0 / binWidth));
+	maxBin = jmin((int)AnalysisFrame::numBins, (int)(11000.0 / binWidth));
+	previousLogSpectrum.calloc(AnalysisFrame::numBins);
+
+	meanCoeff = (float)onePole(0.5 * frameRate);
+	minFramesBetweenOnsets = jmax(1, roundToInt(0.05 * frameRate));
+
+	minLag = jmax(2, (int)std::floor(60.0 * frameRate / maxTempo));
+	maxLag = (int)std::ceil(60.0 * frameRate / minTempo);
+
+	// The comb in updateTempo() looks at twice the longest lag.
+	auto historySize = nextPowerOfTwo(2 * maxLag + 2);
+	historyMask = historySize - 1;
+	odfHistory.calloc(historySize);
+	autocorrelation.calloc(2 * maxLag + 2);
+
+	tempoPrior.calloc(maxLag + 2);
+	for (int lag = minLag; lag <= maxLag + 1; ++lag)
+	{
+		auto octaves = std::log2((60.0 * frameRate / lag) / tempoPriorCentre) / tempoPriorWidthOctaves;
+		tempoPrior[lag] = (float)std::exp(-0.5 * octaves * octaves);
+	}
+
+	acfDecay = (float)std::pow(0.5, 1.0 / (1.25 * frameRate));
+	histogramDecay = (float)std::pow(0.5, 1.0 / (1.0 * frameRate));
+	tempoCoeff = onePole(0.25 * frameRate);
+	phaseCoeff = onePole(0.15 * frameRate);
+
+	reset();
+}
+
+void BeatTracker::reset()
+{
+	if (previousLogSpectrum != nullptr)
+		FloatVectorOperations::clear(previousLogSpectrum, AnalysisFrame::numBins);
+
+	if (odfHistory != nullptr)
+	{
+		FloatVectorOperations::clear(odfHistory, historyMask + 1);
+		FloatVectorOperations::clear(autocorrelation, 2 * maxLag + 2);
+	}
+
+	FloatVectorOperations::clear(phaseHistogram, numPhaseBins);
+
+	odfMean = odfSpread = 0.0f;
+	previousOdf = previousPreviousOdf = 0.0f;
+	framesSinceOnset = 0;
+	historyPos = 0;
+	tempo = tempoPriorCentre;
+	confidence = 0.0f;
+	freeRunningBeats = phaseOffset = 0.0;
+}
+
+void BeatTracker::process(AnalysisFrame& frame)
+{
+	// Half-wave rectified log spectral flux
+	auto flux = 0.0f;
+
+	for (int b = minBin; b < maxBin; ++b)
+	{
+		auto logMag = std::log1p(fluxCompression * frame.spectrum[b]);
+		auto diff = logMag - previousLogSpectrum[b];
+		previousLogSpectrum[b] = logMag;
+
+		if (diff > 0.0f)
+			flux += diff;
+	}
+
+	flux /= (float)(maxBin - minBin);
+
+	// Subtract a running mean so steady sections don't look like one long onset.
+	odfMean += (flux - odfMean) * meanCoeff;
+	odfSpread += (std::abs(flux - odfMean) - odfSpread) * meanCoeff;
+	auto odf = jmax(0.0f, flux - odfMean);
+
+	// An onset is a local maximum that stands clear of the recent spread. We can
+	// only tell the previous frame was a peak once we've seen this one.
+	++framesSinceOnset;
+	frame.onset = previousOdf > previousPreviousOdf
+		&& previousOdf >= odf
+		&& previousOdf > onsetThreshold * odfSpread
+		&& previousOdf > 1.0e-4f
+		&& framesSinceOnset > minFramesBetweenOnsets;
+
+	if (frame.onset)
+		framesSinceOnset = 0;
+
+	previousPreviousOdf = previousOdf;
+	previousOdf = odf;
+
+	// Leaky autocorrelation of the onset curve
+	historyPos = (historyPos + 1) & historyMask;
+	odfHistory[historyPos] = odf;
+
+	for (int lag = 0; lag <= 2 * maxLag + 1; ++lag)
+		autocorrelation[lag] = autocorrelation[lag] * acfDecay + odf * odfHistory[(historyPos - lag) & historyMask];
+
+	updateTempo();
+	updatePhase(odf);
+
+	frame.onsetFunction = odf;
+	frame.onsetStrength = jlimit(0.0f, 1.0f, odf / (4.0f * odfSpread + 1.0e-6f));
+	frame.tempo = (float)tempo;
+	frame.tempoConfidence = confidence;
+	frame.beatPosition = freeRunningBeats - phaseOffset;
+}
+
+void BeatTracker::updateTempo()
+{
+	auto score = [this](int lag)
+	{
+		return tempoPrior[lag] * (autocorrelation[lag] + 0.5f * autocorrelation[2 * lag]);
+	};
+
+	int bestLag = minLag;
+	auto bestScore = 0.0f, total = 0.0f;
+
+	for (int lag = minLag; lag <= maxLag; ++lag)
+	{
+		auto s = score(lag);
+		total += s;
+
+		if (s > bestScore)
+		{
+			bestScore = s;
+			bestLag = lag;
+		}
+	}
+
+	if (bestScore <= 0.0f)
+	{
+		confidence = 0.0f;
+		return;
+	}
+
+	// Parabolic interpolation for a fractional lag, otherwise the tempo would be
+	// quantised to about 1 BPM steps at 120.
+	auto lag = (double)bestLag;
+
+	if (bestLag > minLag && bestLag < maxLag)
+	{
+		auto y0 = score(bestLag - 1), y1 = bestScore, y2 = score(bestLag + 1);
+		auto denom = y0 - 2.0f * y1 + y2;
+
+		if (denom < 0.0f)
+			lag += jlimit(-0.5, 0.5, 0.5 * (double)(y0 - y2) / (double)denom);
+	}
+
+	auto mean = total / (float)(maxLag - minLag + 1);
+	confidence = jlimit(0.0f, 1.0f, (bestScore / mean - 1.0f) / 3.0f);
+
+	tempo += (60.0 * frameRate / lag - tempo) * tempoCoeff;
+}
+
+void BeatTracker::updatePhase(float odf)
+{
+	freeRunningBeats += tempo / (60.0 * frameRate);
+
+	// Fold the onset curve onto the free-running oscillator's phase.
+	auto position = (freeRunningBeats - std::floor(freeRunningBeats)) * numPhaseBins;
+	auto bin = (int)position;
+	auto frac = (float)(position - bin);
+
+	for (auto& h : phaseHistogram)
+		h *= histogramDecay;
+
+	phaseHistogram[bin % numPhaseBins] += odf * (1.0f - frac);
+	phaseHistogram[(bin + 1) % numPhaseBins] += odf * frac;
+
+	// Wherever the onsets pile up is where the beat is.
+	int peak = 0;
+	for (int i = 1; i < numPhaseBins; ++i)
+		if (phaseHistogram[i] > phaseHistogram[peak])
+			peak = i;
+
+	if (phaseHistogram[peak] <= 1.0e-6f)
+		return;
+
+	auto y0 = phaseHistogram[(peak + numPhaseBins - 1) % numPhaseBins];
+	auto y1 = phaseHistogram[peak];
+	auto y2 = phaseHistogram[(peak + 1) % numPhaseBins];
+	auto denom = y0 - 2.0f * y1 + y2;
+	auto offset = (double)peak;
+
+	if (denom < 0.0f)
+		offset += jlimit(-0.5, 0.5, 0.5 * (double)(y0 - y2) / (double)denom);
+
+	phaseOffset += wrapPhase(offset / numPhaseBins - phaseOffset) * phaseCoeff;
+}
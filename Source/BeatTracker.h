@@ -0,0 +1,73 @@
+/*
+  ==============================================================================
+
+    BeatTracker.h
+    Created: 17 Oct 2026 11:32:45am
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+struct AnalysisFrame;
+
+//==============================================================================
+/**
+	Causal onset detector and tempo/phase tracker that runs one step per
+	analysis frame.
+
+	Onsets come from log-compressed spectral flux. Tempo is the strongest peak
+	of a leaky autocorrelation of the onset curve, weighted towards dance-music
+	tempos so it doesn't lock onto half or double time. Phase comes from folding
+	the onset curve onto a free-running beat oscillator and tracking where the
+	energy piles up.
+
+	Both the autocorrelation and the phase histogram forget with a half-life of
+	about a beat and a half, so a tempo change is picked up within ~4 beats.
+*/
+class BeatTracker
+{
+public:
+	BeatTracker() = default;
+
+	void prepare(double sampleRate, int hopSize);
+	void reset();
+
+	/** Reads frame.spectrum and fills in the onset and tempo fields. */
+	void process(AnalysisFrame& frame);
+
+	// Tempo search range, in BPM.
+	static constexpr double minTempo = 60.0, maxTempo = 200.0;
+
+private:
+	void updateTempo();
+	void updatePhase(float odf);
+
+	double frameRate = 86.0;
+
+	// Onset detection function
+	HeapBlock<float> previousLogSpectrum;
+	int minBin = 1, maxBin = 256;
+	float odfMean = 0.0f, odfSpread = 0.0f, meanCoeff = 0.0f;
+	float previousOdf = 0.0f, previousPreviousOdf = 0.0f;
+	int framesSinceOnset = 0, minFramesBetweenOnsets = 4;
+
+	// Tempo
+	HeapBlock<float> odfHistory, autocorrelation, tempoPrior;
+	int historyMask = 0, historyPos = 0;
+	int minLag = 1, maxLag = 2;
+	float acfDecay = 0.99f;
+	double tempo = 120.0, tempoCoeff = 0.1;
+	float confidence = 0.0f;
+
+	// Phase
+	enum { numPhaseBins = 48 };
+	float phaseHistogram[numPhaseBins] = {};
+	float histogramDecay = 0.99f;
+	double freeRunningBeats = 0.0, phaseOffset = 0.0, phaseCoeff = 0.05;
+
+	JUCE_DECLARE_NON_COPYABLE(BeatTracker)
+};
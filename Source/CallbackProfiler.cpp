@@ -0,0 +1,125 @@
+/*
+  ==============================================================================
+
+    CallbackProfiler.cpp
+    Created: 17 Oct 2026 7:31:52pm
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#include "CallbackProfiler.h"
+
+void CallbackProfiler::prepare(double newSampleRate, int samplesPerBlockExpected)
+{
+	sampleRate = newSampleRate;
+	samplesPerBlock = jmax(1, samplesPerBlockExpected);
+
+	for (auto& count : histogram)
+		count.store(0);
+
+	numCallbacks = 0;
+	numOverBudget = 0;
+	numLate = 0;
+	worstLoad = 0.0;
+
+	lastStartTicks = 0;
+	lastNumSamples = 0;
+}
+
+void CallbackProfiler::addCallback(int64 startTicks, int64 endTicks, int numSamples) noexcept
+{
+	if (numSamples <= 0)
+		return;
+
+	auto budget = numSamples / sampleRate;
+	auto load = Time::highResolutionTicksToSeconds(endTicks - startTicks) / budget;
+
+	// Single writer, so plain loads and stores are enough and nothing needs a locked instruction.
+	auto bucket = jmin((int)numBuckets - 1, (int)(load * 100.0));
+	histogram[bucket].store(histogram[bucket].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+	if (load > worstLoad.load(std::memory_order_relaxed))
+		worstLoad.store(load, std::memory_order_relaxed);
+
+	if (load > 1.0)
+		numOverBudget.store(numOverBudget.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+	// The device should come back once the previous block has played; much later and it has glitched.
+	if (lastStartTicks != 0)
+	{
+		auto interval = Time::highResolutionTicksToSeconds(startTicks - lastStartTicks);
+
+		if (interval > 1.5 * lastNumSamples / sampleRate)
+			numLate.store(numLate.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	}
+
+	lastStartTicks = startTicks;
+	lastNumSamples = numSamples;
+
+	// Last, so a reader that sees the count sees the histogram entry too.
+	numCallbacks.store(numCallbacks.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+double CallbackProfiler::getLoadPercentile(const uint32* counts, int64 total, double fraction) const noexcept
+{
+	auto target = (int64)std::ceil(total * fraction);
+	int64 cumulative = 0;
+
+	for (int i = 0; i < numBuckets; ++i)
+	{
+		cumulative += counts[i];
+
+		// The bucket's upper edge, so the figure errs on the slow side.
+		if (cumulative >= target)
+			return (i + 1) * 0.01;
+	}
+
+	return numBuckets * 0.01;
+}
+
+CallbackProfiler::Stats CallbackProfiler::getStats() const
+{
+	Stats stats;
+	stats.numCallbacks = numCallbacks.load(std::memory_order_acquire);
+	stats.blockDuration = samplesPerBlock / sampleRate;
+	stats.numOverBudget = numOverBudget.load();
+	stats.numLate = numLate.load();
+	stats.worst = worstLoad.load();
+
+	uint32 counts[numBuckets];
+	int64 total = 0;
+
+	for (int i = 0; i < numBuckets; ++i)
+		total += (counts[i] = histogram[i].load(std::memory_order_relaxed));
+
+	if (total > 0)
+	{
+		stats.median = getLoadPercentile(counts, total, 0.5);
+		stats.p99 = getLoadPercentile(counts, total, 0.99);
+	}
+
+	return stats;
+}
+
+String CallbackProfiler::Stats::getSummary() const
+{
+	if (numCallbacks == 0)
+		return "Callback: not running";
+
+	auto percent = [](double load) { return String(roundToInt(load * 100.0)) + "%"; };
+
+	return "Callback: p50 " + percent(median) + "  p99 " + percent(p99) + "  max " + percent(worst)
+		+ " of " + String(blockDuration * 1000.0, 1) + " ms, " + String(numOverBudget) + " over, " + String(numLate) + " late";
+}
+
+String CallbackProfiler::getHistogramText() const
+{
+	String text;
+
+	for (int i = 0; i < numBuckets; ++i)
+		if (auto count = histogram[i].load(std::memory_order_relaxed))
+			text << (i == numBuckets - 1 ? ">=" : "") << String(i) << "%: " << String(count) << newLine;
+
+	return text;
+}
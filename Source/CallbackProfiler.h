@@ -0,0 +1,95 @@
+/*
+  ==============================================================================
+
+    CallbackProfiler.h
+    Created: 17 Oct 2026 7:31:52pm
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+	Times every audio callback against its block's time budget, i.e. how long
+	the block lasts at the device's sample rate.
+
+	Each duration goes into a histogram of load (duration / budget) in 1%
+	steps, so percentiles can be read off at any time without keeping the
+	durations themselves. The audio thread is the only writer; it never locks
+	or allocates, and readers on other threads only ever see counts that are
+	a callback or so out of date.
+
+	Besides the load it counts callbacks that ran over their budget and
+	callbacks that started late, more than half a block after the previous
+	block would have finished playing. Late callbacks are what an xrun looks
+	like from the inside, on drivers that don't report xruns themselves.
+*/
+class CallbackProfiler
+{
+public:
+	CallbackProfiler() = default;
+
+	/** Starts afresh for a new device setup. Call while the device is stopped. */
+	void prepare(double sampleRate, int samplesPerBlockExpected);
+
+	/** Times one callback from construction to destruction. Audio thread only. */
+	struct ScopedCallback
+	{
+		ScopedCallback(CallbackProfiler& p, int numSamplesInBlock) noexcept
+			: profiler(p), numSamples(numSamplesInBlock), startTicks(Time::getHighResolutionTicks())
+		{
+		}
+
+		~ScopedCallback() { profiler.addCallback(startTicks, Time::getHighResolutionTicks(), numSamples); }
+
+		CallbackProfiler& profiler;
+		const int numSamples;
+		const int64 startTicks;
+
+		JUCE_DECLARE_NON_COPYABLE(ScopedCallback)
+	};
+
+	struct Stats
+	{
+		int64 numCallbacks = 0;
+		double blockDuration = 0.0;		// Budget of a block of the expected size, in seconds
+		double median = 0.0;			// Load percentiles: callback duration / its block's budget
+		double p99 = 0.0;
+		double worst = 0.0;				// Measured exactly, not from the histogram
+		int64 numOverBudget = 0;		// Callbacks that took longer than their block lasts
+		int64 numLate = 0;				// Callbacks that started over half a block late
+
+		/** One line for the player, e.g. "p50 12%  p99 40%  max 85% of 5.8 ms". */
+		String getSummary() const;
+	};
+
+	/** Safe from any thread but the audio thread, which would only be timing itself. */
+	Stats getStats() const;
+
+	/** The non-empty histogram buckets, one "load%: count" per line, for the shutdown log. */
+	String getHistogramText() const;
+
+	// 1% buckets up to 400% of the budget; anything slower lands in the last one.
+	enum { numBuckets = 401 };
+
+private:
+	void addCallback(int64 startTicks, int64 endTicks, int numSamples) noexcept;
+	double getLoadPercentile(const uint32* counts, int64 total, double fraction) const noexcept;
+
+	double sampleRate = 44100.0;
+	int samplesPerBlock = 512;
+
+	std::atomic<uint32> histogram[numBuckets] = {};
+	std::atomic<int64> numCallbacks{ 0 }, numOverBudget{ 0 }, numLate{ 0 };
+	std::atomic<double> worstLoad{ 0.0 };
+
+	// Audio thread only.
+	int64 lastStartTicks = 0;
+	int lastNumSamples = 0;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CallbackProfiler)
+};
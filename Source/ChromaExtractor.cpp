@@ -0,0 +1,186 @@
+/*
+  ==============================================================================
+
+    ChromaExtractor.cpp
+    Created: 17 Oct 2026 9:18:06pm
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#include "ChromaExtractor.h"
+
+constexpr double ChromaExtractor::lowestFrequency, ChromaExtractor::highestFrequency, ChromaExtractor::smoothingTime;
+
+namespace
+{
+	// Krumhansl & Kessler (1982) probe-tone ratings, tonic first.
+	const float majorProfile[ChromaExtractor::numPitchClasses] = { 6.35f, 2.23f, 3.48f, 2.33f, 4.38f, 4.09f, 2.52f, 5.19f, 2.39f, 3.66f, 2.29f, 2.88f };
+	const float minorProfile[ChromaExtractor::numPitchClasses] = { 6.33f, 2.68f, 3.52f, 5.38f, 2.60f, 3.53f, 2.54f, 4.75f, 3.98f, 2.69f, 3.34f, 3.17f };
+
+	const char* const pitchClassNames[ChromaExtractor::numPitchClasses] = { "C", "C#", "D", "Eb", "E", "F", "F#", "G", "Ab", "A", "Bb", "B" };
+
+	// Steps round the circle of fifths from C.
+	int getFifthsPosition(int pitchClass) noexcept	{ return (pitchClass * 7) % ChromaExtractor::numPitchClasses; }
+
+	float wrapHue(float degrees) noexcept
+	{
+		degrees = std::fmod(degrees, 360.0f);
+		return degrees < 0.0f ? degrees + 360.0f : degrees;
+	}
+}
+
+void ChromaExtractor::prepare(double sampleRate, int fftSize, int hopSize)
+{
+	auto binWidth = sampleRate / fftSize;
+	auto lastBin = jmin(fftSize / 2 - 1, (int)(jmin(highestFrequency, sampleRate * 0.45) / binWidth));
+
+	firstBin = jmax(1, (int)std::ceil(lowestFrequency / binWidth));
+	lowerClass.clear();
+	upperShare.clear();
+
+	for (int bin = firstBin; bin <= lastBin; ++bin)
+	{
+		// MIDI note number, so pitch class 0 is C.
+		auto note = 69.0 + 12.0 * std::log2(bin * binWidth / 440.0);
+		auto lower = (int)std::floor(note);
+
+		lowerClass.push_back((uint8)(((lower % numPitchClasses) + numPitchClasses) % numPitchClasses));
+		upperShare.push_back((float)(note - lower));
+	}
+
+	smoothingCoeff = (float)(1.0 - std::exp(-hopSize / (sampleRate * smoothingTime)));
+	reset();
+}
+
+void ChromaExtractor::reset()
+{
+	for (auto& c : smoothed)
+		c = 0.0f;
+}
+
+void ChromaExtractor::process(const float* magnitudes, float* chroma) noexcept
+{
+	float power[numPitchClasses] = {};
+	auto* magnitude = magnitudes + firstBin;
+	auto numBins = (int)lowerClass.size();
+
+	for (int i = 0; i < numBins; ++i)
+	{
+		auto binPower = magnitude[i] * magnitude[i];
+		auto lower = lowerClass[(size_t)i];
+		auto upper = lower == numPitchClasses - 1 ? 0 : lower + 1;
+
+		power[lower] += binPower * (1.0f - upperShare[(size_t)i]);
+		power[upper] += binPower * upperShare[(size_t)i];
+	}
+
+	auto strongest = 0.0f;
+
+	for (int pc = 0; pc < numPitchClasses; ++pc)
+	{
+		chroma[pc] = std::sqrt(power[pc]);
+		strongest = jmax(strongest, chroma[pc]);
+	}
+
+	// Roughly -80 dBFS: nothing there worth calling a pitch.
+	auto scale = strongest > 1.0e-4f ? 1.0f / strongest : 0.0f;
+
+	for (int pc = 0; pc < numPitchClasses; ++pc)
+	{
+		chroma[pc] *= scale;
+		smoothed[pc] += (chroma[pc] - smoothed[pc]) * smoothingCoeff;
+	}
+}
+
+ChromaExtractor::KeyEstimate ChromaExtractor::estimateKey(const float* chroma) noexcept
+{
+	auto chromaMean = 0.0f;
+
+	for (int pc = 0; pc < numPitchClasses; ++pc)
+		chromaMean += chroma[pc] / numPitchClasses;
+
+	auto chromaVariance = 0.0f;
+
+	for (int pc = 0; pc < numPitchClasses; ++pc)
+		chromaVariance += (chroma[pc] - chromaMean) * (chroma[pc] - chromaMean);
+
+	KeyEstimate estimate;
+
+	// Flat or silent: every key fits equally badly.
+	if (chromaVariance < 1.0e-6f * (chromaMean * chromaMean * numPitchClasses + 1.0e-9f))
+		return estimate;
+
+	auto best = -1.0f;
+
+	for (int key = 0; key < numKeys; ++key)
+	{
+		auto* profile = key < numPitchClasses ? majorProfile : minorProfile;
+		auto tonic = key % numPitchClasses;
+
+		auto profileMean = 0.0f;
+		for (int i = 0; i < numPitchClasses; ++i)
+			profileMean += profile[i] / numPitchClasses;
+
+		// Pearson correlation between the chroma and the profile rotated onto this tonic.
+		auto covariance = 0.0f, profileVariance = 0.0f;
+
+		for (int i = 0; i < numPitchClasses; ++i)
+		{
+			auto p = profile[i] - profileMean;
+			covariance += (chroma[(tonic + i) % numPitchClasses] - chromaMean) * p;
+			profileVariance += p * p;
+		}
+
+		auto correlation = covariance / std::sqrt(chromaVariance * profileVariance);
+
+		if (correlation > best)
+		{
+			best = correlation;
+			estimate.key = key;
+		}
+	}
+
+	estimate.confidence = jlimit(0.0f, 1.0f, best);
+	return estimate;
+}
+
+String ChromaExtractor::getKeyName(int key)
+{
+	if (!isPositiveAndBelow(key, (int)numKeys))
+		return "Unknown key";
+
+	return String(pitchClassNames[key % numPitchClasses]) + (key < numPitchClasses ? " major" : " minor");
+}
+
+float ChromaExtractor::getKeyHue(int key) noexcept
+{
+	if (!isPositiveAndBelow(key, (int)numKeys))
+		return 0.0f;
+
+	auto tonic = key % numPitchClasses;
+	auto relativeMajor = key < numPitchClasses ? tonic : (tonic + 3) % numPitchClasses;
+
+	return 30.0f * (float)getFifthsPosition(relativeMajor);
+}
+
+float ChromaExtractor::getChromaHue(const float* chroma) noexcept
+{
+	auto x = 0.0f, y = 0.0f, total = 0.0f;
+
+	for (int pc = 0; pc < numPitchClasses; ++pc)
+	{
+		auto angle = MathConstants<float>::twoPi * (float)getFifthsPosition(pc) / numPitchClasses;
+		x += chroma[pc] * std::cos(angle);
+		y += chroma[pc] * std::sin(angle);
+		total += chroma[pc];
+	}
+
+	// Evenly spread round the circle: no harmonic centre to speak of.
+	if (total <= 0.0f || std::sqrt(x * x + y * y) < 0.05f * total)
+		return -1.0f;
+
+	// A major scale spans a fifth below its tonic to five above, so its centre
+	// sits two fifths (60 degrees) above the key's own hue.
+	return wrapHue(radiansToDegrees(std::atan2(y, x)) - 60.0f);
+}
@@ -0,0 +1,79 @@
+/*
+  ==============================================================================
+
+    ChromaExtractor.h
+    Created: 17 Oct 2026 9:18:06pm
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+
+//==============================================================================
+/**
+	Folds an FFT magnitude spectrum into a 12-bin chroma vector (how much of
+	each pitch class, C to B) and estimates the musical key from it.
+
+	Like SpectralFilterbank, the bin-to-pitch-class mapping is worked out once
+	in prepare(). Each bin between lowestFrequency and highestFrequency splits
+	its power between the two pitch classes either side of it, so process() is
+	a couple of multiply-adds per bin.
+
+	Keys are matched against the Krumhansl-Kessler profiles and numbered 0..11
+	for C major..B major, then 12..23 for C minor..B minor.
+*/
+class ChromaExtractor
+{
+public:
+	enum { numPitchClasses = 12, numKeys = 24 };
+
+	ChromaExtractor() = default;
+
+	/** Builds the mapping. Allocates, so not for the audio thread. */
+	void prepare(double sampleRate, int fftSize, int hopSize);
+	void reset();
+
+	/** Fills chroma[numPitchClasses] from numBins = fftSize / 2 magnitudes,
+		scaled so the strongest pitch class is 1.0 (all zero in silence), and
+		updates the smoothed chroma. */
+	void process(const float* magnitudes, float* chroma) noexcept;
+
+	/** The last smoothingTime seconds of chroma, same scaling. Steadier than a
+		single frame, which is what the live key and hue need. */
+	const float* getSmoothedChroma() const noexcept		{ return smoothed; }
+
+	struct KeyEstimate
+	{
+		int key = -1;				// -1 when there's no pitched content
+		float confidence = 0.0f;	// Correlation with the key's profile, 0..1
+	};
+
+	/** The best-matching key for a chroma vector, or any sum of them. */
+	static KeyEstimate estimateKey(const float* chroma) noexcept;
+	static String getKeyName(int key);
+
+	/** Hue in degrees for a key, going round the circle of fifths: neighbouring
+		keys are 30 degrees apart and a minor key shares its relative major's hue. */
+	static float getKeyHue(int key) noexcept;
+	/** The same mapping for a chroma vector, from its centre of weight on the
+		circle of fifths. -1 if there's no pitched content. */
+	static float getChromaHue(const float* chroma) noexcept;
+
+	// Range of the spectrum used. Below ~100 Hz the bins are wider than a semitone.
+	static constexpr double lowestFrequency = 100.0, highestFrequency = 4000.0;
+	static constexpr double smoothingTime = 2.0;
+
+private:
+	int firstBin = 0;
+	std::vector<uint8> lowerClass;		// Per bin from firstBin: the pitch class below it...
+	std::vector<float> upperShare;		// ...and how much of its power goes to the one above
+
+	float smoothed[numPitchClasses] = {};
+	float smoothingCoeff = 0.0f;
+
+	JUCE_DECLARE_NON_COPYABLE(ChromaExtractor)
+};
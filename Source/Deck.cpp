@@ -0,0 +1,863 @@
+/*
+  ==============================================================================
+
+    Deck.cpp
+    Created: 17 Oct 2026 10:31:46pm
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#include "Deck.h"
+
+constexpr double Deck::queuedReadAheadSeconds;
+
+namespace
+{
+	// Picks out the analysis job for one track.
+	struct TrackJobSelector : public ThreadPool::JobSelector
+	{
+		explicit TrackJobSelector(int id) : jobName(getJobName(id)) {}
+
+		static String getJobName(int trackId) { return "Track analysis " + String(trackId); }
+
+		bool isJobSuitable(ThreadPoolJob* job) override { return job->getJobName() == jobName; }
+
+		String jobName;
+	};
+}
+
+Deck::Deck(const String& deckName, DecodedAudioCache& decodedAudioToUse, TimeSliceThread& readAheadThreadToUse,
+		   ThreadPool& analysisPoolToUse, ThreadPool& waveformPoolToUse)
+	: name(deckName),
+	  decodedAudio(decodedAudioToUse),
+	  readAheadThread(readAheadThreadToUse),
+	  analysisPool(analysisPoolToUse),
+	  waveformPool(waveformPoolToUse)
+{
+}
+
+Deck::~Deck()
+{
+	// The audio thread has stopped by now, so everything it held is ours.
+	sendLoopCommand(nullptr);
+	retireLoop(activeLoop);
+	retireLoop(nextLoop);
+
+	for (auto* region = retiredLoops.exchange(nullptr); region != nullptr;)
+	{
+		auto* nextRegion = region->nextRetired;
+		delete region;
+		region = nextRegion;
+	}
+}
+
+int Deck::createTrackId()
+{
+	// Shared by every deck, so one id never means two tracks.
+	static std::atomic<int> lastTrackId{ 0 };
+	return ++lastTrackId;
+}
+
+void Deck::prepareToPlay(int samplesPerBlockExpected, double newSampleRate, int numAnalysedChannels)
+{
+	sampleRate = newSampleRate;
+	playlist.prepareToPlay(samplesPerBlockExpected, newSampleRate);
+	output.setSize(2, jmax(1, samplesPerBlockExpected));
+	analyser.prepare(newSampleRate, samplesPerBlockExpected, numAnalysedChannels);
+}
+
+void Deck::releaseResources()
+{
+	playlist.releaseResources();
+}
+
+bool Deck::renderNextBlock(int numSamples) noexcept
+{
+	jassert(numSamples <= output.getNumSamples());
+
+	takeLoopCommand();
+
+	auto shouldPlay = playing.load(std::memory_order_relaxed);
+
+	// A track that's about to be replaced has nothing worth fading out, and
+	// pulling the playlist now would play a block of the new one.
+	if (!shouldPlay && fadeGain > 0.0f && playlist.isLoadPending())
+	{
+		fadeGain = 0.0f;
+		hasStopped = true;
+	}
+
+	if (fadeGain == 0.0f)
+	{
+		// So the position and waveform show the new track while it's cued.
+		playlist.takeLoadedTrack();
+
+		// Starting waits for the read-ahead to have the track ready, rather than
+		// opening on silence it hasn't decoded yet.
+		if (!shouldPlay || !playlist.isBuffered())
+		{
+			output.clear(0, numSamples);
+			analyser.pushBlock(output, 0, numSamples);
+			return false;
+		}
+	}
+
+	renderTrack(numSamples);
+
+	auto targetGain = shouldPlay ? 1.0f : 0.0f;
+
+	if (fadeGain != targetGain)
+	{
+		output.applyGainRamp(0, numSamples, fadeGain, targetGain);
+		fadeGain = targetGain;
+
+		if (!shouldPlay)
+			hasStopped = true;
+	}
+
+	// Played off the end of the last track: stop where AudioTransportSource would.
+	if (shouldPlay && playlist.getNextReadPosition() > playlist.getTotalLength() + 1)
+	{
+		playing = false;
+		fadeGain = 0.0f;
+		hasStopped = true;
+	}
+
+	analyser.pushBlock(output, 0, numSamples);
+	return true;
+}
+
+bool Deck::loadFile(const File& audioFile, StringArray* leftOutStems)
+{
+	auto trackId = createTrackId();
+	auto track = createTrack(audioFile, trackId, false, leftOutStems);
+
+	if (track == nullptr)
+		return false;
+
+	stop();
+
+	// The old track's loop goes with it, before the audio thread can wrap it over the new one.
+	if (isLooping() || incomingLoop.load() != nullptr)
+	{
+		auto* command = new LoopRegion();
+		command->exitNow = true;
+		sendLoopCommand(command);
+	}
+
+	playlist.loadTrack(std::move(track));
+
+	startTrackAnalysis(audioFile, trackId);
+	queueNextTrack();
+	return true;
+}
+
+void Deck::queueFile(const File& audioFile)
+{
+	if (playlist.getCurrentTrackId() == 0)
+	{
+		loadFile(audioFile);
+		return;
+	}
+
+	queue.add(audioFile);
+	queueNextTrack();
+}
+
+int Deck::getNumQueued() const
+{
+	return queue.size() + (playlist.getNextTrackId() != 0 ? 1 : 0);
+}
+
+void Deck::queueNextTrack()
+{
+	// Hand the playlist its next track early, so it's decoded and analysed by the time it's needed.
+	while (playlist.getNextTrackId() == 0 && !queue.isEmpty())
+	{
+		auto audioFile = queue.removeAndReturn(0);
+		auto trackId = createTrackId();
+
+		if (auto track = createTrack(audioFile, trackId, true))
+		{
+			playlist.setNextTrack(std::move(track));
+			startTrackAnalysis(audioFile, trackId);
+		}
+	}
+}
+
+bool Deck::update()
+{
+	for (auto* region = retiredLoops.exchange(nullptr); region != nullptr;)
+	{
+		auto* nextRegion = region->nextRetired;
+		delete region;
+		region = nextRegion;
+	}
+
+	// Once the playlist has moved on, the track after next can start loading.
+	if (playlist.releaseFinishedTracks() > 0)
+		queueNextTrack();
+
+	for (auto& slot : analysisSlots)
+		startWaveform(slot);
+
+	// Back to the top once stopped, as with the transport. If it's been started
+	// again since, the flag waits for the next stop.
+	if (isPlaying() || !hasStopped.exchange(false))
+		return false;
+
+	setPosition(0.0);
+	return true;
+}
+
+AudioFormatReader* Deck::createReader(const File& audioFile, bool waitForDecoder, StringArray* leftOutStems)
+{
+	if (!audioFile.isDirectory())
+		return decodedAudio.createReaderFor(audioFile, waitForDecoder);
+
+	// Every stem goes to the decode cache at once, so they're decoded side by side.
+	auto stems = StemSet::fromFolder(audioFile);
+	Array<AudioFormatReader*> stemReaders;
+
+	for (auto& stemFile : stems.files)
+		stemReaders.add(stemFile != File() ? decodedAudio.createReaderFor(stemFile, waitForDecoder) : nullptr);
+
+	std::unique_ptr<StemMixReader> reader(new StemMixReader(stemReaders));
+
+	if (leftOutStems != nullptr)
+		leftOutStems->addArray(reader->getLeftOutStems());
+
+	return reader->getNumStemReaders() > 0 ? reader.release() : nullptr;
+}
+
+std::unique_ptr<PlaylistSource::Track> Deck::createTrack(const File& audioFile, int trackId, bool isQueued,
+														 StringArray* leftOutStems)
+{
+	auto* reader = createReader(audioFile, false, leftOutStems);
+
+	if (reader == nullptr)
+		return nullptr;
+
+	auto* readerSource = new AudioFormatReaderSource(reader, true);
+	auto seconds = isQueued ? jmax(readAheadSeconds, queuedReadAheadSeconds) : readAheadSeconds;
+
+	ReadAheadSource* readAhead = nullptr;
+
+	if (seconds > 0.0)
+		readAhead = new ReadAheadSource(readerSource, false, readAheadThread,
+			roundToInt(seconds * reader->sampleRate), jlimit(1, 2, (int)reader->numChannels));
+
+	return std::unique_ptr<PlaylistSource::Track>(new PlaylistSource::Track(trackId, audioFile, readerSource, readAhead));
+}
+
+void Deck::setReadAheadSeconds(double seconds)
+{
+	if (seconds == readAheadSeconds)
+		return;
+
+	readAheadSeconds = seconds;
+
+	// Swap the buffering under the current track without losing our place in it.
+	auto audioFile = playlist.getCurrentFile();
+	auto track = audioFile.exists() ? createTrack(audioFile, playlist.getCurrentTrackId(), false) : nullptr;
+
+	if (track != nullptr)
+		playlist.replaceTrack(std::move(track));
+}
+
+double Deck::getPosition() const noexcept
+{
+	auto rate = sampleRate.load();
+	auto position = loopPosition.load();
+
+	if (position < 0)
+		position = playlist.getNextReadPosition();
+
+	return rate > 0.0 ? (double)position / rate : 0.0;
+}
+
+void Deck::setPosition(double seconds)
+{
+	// Leaving the loop first; the audio thread sees both at the start of its next block.
+	if (isLooping() || incomingLoop.load() != nullptr)
+	{
+		auto* command = new LoopRegion();
+		command->exitNow = true;
+		sendLoopCommand(command);
+	}
+
+	auto position = (int64)(jmax(0.0, seconds) * sampleRate.load());
+
+	// A jump past what the read-ahead has decoded would drop out until it caught
+	// up. Instead a fresh copy of the track buffers from there while this one
+	// plays on, and takes over at the start of the first block it's ready for.
+	if (!playlist.canSeekWithoutGap(position))
+	{
+		auto audioFile = playlist.getCurrentFile();
+
+		if (auto track = audioFile.exists() ? createTrack(audioFile, playlist.getCurrentTrackId(), false) : nullptr)
+		{
+			playlist.replaceTrack(std::move(track), position);
+			return;
+		}
+	}
+
+	playlist.setNextReadPosition(position);
+	playlist.wakeDecoder();
+}
+
+//==============================================================================
+double Deck::quantiseToBeat(double seconds, bool roundUp) const
+{
+	auto analysis = getTrackAnalysis(playlist.getCurrentTrackId());
+
+	if (analysis == nullptr || analysis->beats.size() < 2)
+		return -1.0;
+
+	auto beat = analysis->getBeatPosition(seconds);
+
+	// A hair's leeway, so a playhead sitting on a beat doesn't round up past it.
+	return analysis->getBeatTime(roundUp ? std::ceil(beat - 1.0e-3) : std::round(beat));
+}
+
+bool Deck::setBeatLoop(int numBeats)
+{
+	auto analysis = getTrackAnalysis(playlist.getCurrentTrackId());
+
+	if (analysis == nullptr || analysis->beats.size() < 2 || numBeats < 1)
+		return false;
+
+	auto firstBeat = std::round(analysis->getBeatPosition(getPosition()));
+	auto* region = createLoopRegion(analysis->getBeatTime(firstBeat), analysis->getBeatTime(firstBeat + numBeats));
+
+	if (region == nullptr)
+		return false;
+
+	sendLoopCommand(region);
+	return true;
+}
+
+void Deck::setLoopIn()
+{
+	auto seconds = quantiseToBeat(getPosition(), false);
+	loopInSeconds = seconds >= 0.0 ? seconds : -1.0;
+	loopInTrackId = playlist.getCurrentTrackId();
+}
+
+bool Deck::setLoopOut()
+{
+	if (loopInSeconds < 0.0 || loopInTrackId != playlist.getCurrentTrackId())
+		return false;
+
+	auto analysis = getTrackAnalysis(loopInTrackId);
+
+	if (analysis == nullptr)
+		return false;
+
+	// At least a beat long.
+	auto endSeconds = jmax(quantiseToBeat(getPosition(), true),
+						   analysis->getBeatTime(std::round(analysis->getBeatPosition(loopInSeconds)) + 1.0));
+	auto* region = createLoopRegion(loopInSeconds, endSeconds);
+
+	if (region == nullptr)
+		return false;
+
+	sendLoopCommand(region);
+	return true;
+}
+
+void Deck::exitLoop()
+{
+	if (isLooping())
+		sendLoopCommand(new LoopRegion());
+}
+
+Range<double> Deck::getLoop() const noexcept
+{
+	auto rate = sampleRate.load();
+	auto end = loopEnd.load();
+
+	if (rate <= 0.0 || end <= 0)
+		return {};
+
+	return { (double)loopStart.load() / rate, (double)end / rate };
+}
+
+Deck::LoopRegion* Deck::createLoopRegion(double startSeconds, double endSeconds)
+{
+	auto rate = sampleRate.load();
+	auto trackId = playlist.getCurrentTrackId();
+
+	if (rate <= 0.0 || trackId == 0 || startSeconds < 0.0)
+		return nullptr;
+
+	std::unique_ptr<LoopRegion> region(new LoopRegion());
+	region->trackId = trackId;
+	region->start = (int64)(startSeconds * rate);
+	region->end = jmin(playlist.getTotalLength(), (int64)(endSeconds * rate));
+
+	auto length = (int)(region->end - region->start);
+
+	if (length <= 0)
+		return nullptr;
+
+	// Playback's own reader can't be borrowed; this one streams whatever the
+	// decode cache hasn't reached, so it never waits on it.
+	std::unique_ptr<AudioFormatReader> reader(createReader(playlist.getCurrentFile(), false));
+
+	if (reader == nullptr)
+		return nullptr;
+
+	region->audio.setSize(2, length);
+	auto ratio = reader->sampleRate / rate;
+
+	if (ratio == 1.0)
+	{
+		reader->read(&region->audio, 0, length, region->start, true, true);
+	}
+	else
+	{
+		// The playlist resamples this track, so the loop is resampled to match.
+		auto numInput = (int)std::ceil(length * ratio) + 4;
+		AudioBuffer<float> input(2, numInput);
+		reader->read(&input, 0, numInput, (int64)((double)region->start * ratio), true, true);
+
+		for (int ch = 0; ch < 2; ++ch)
+		{
+			LagrangeInterpolator interpolator;
+			interpolator.process(ratio, input.getReadPointer(ch), region->audio.getWritePointer(ch), length);
+		}
+	}
+
+	return region.release();
+}
+
+void Deck::sendLoopCommand(LoopRegion* command)
+{
+	// One the audio thread never saw is still ours.
+	delete incomingLoop.exchange(command);
+}
+
+void Deck::takeLoopCommand() noexcept
+{
+	auto* command = incomingLoop.exchange(nullptr);
+
+	if (command == nullptr)
+		return;
+
+	if (command->audio.getNumSamples() == 0)
+	{
+		// Out at the end of the pass, or now if the playlist is about to be sent elsewhere.
+		if (inLoop && !command->exitNow)
+		{
+			leavingLoop = true;
+		}
+		else
+		{
+			retireLoop(activeLoop);
+			activeLoop = nullptr;
+			inLoop = leavingLoop = false;
+		}
+
+		retireLoop(nextLoop);
+		nextLoop = nullptr;
+		retireLoop(command);
+	}
+	else if (inLoop && command->end <= activeLoop->end)
+	{
+		// Inside what's already playing from memory: renderTrack() switches to it
+		// once the playhead's in it, without leaving the loop.
+		retireLoop(nextLoop);
+		nextLoop = command;
+		leavingLoop = false;
+	}
+	else if (inLoop)
+	{
+		// The playlist is waiting at this loop's end, so it has to finish its pass first.
+		retireLoop(nextLoop);
+		nextLoop = command;
+		leavingLoop = true;
+	}
+	else
+	{
+		retireLoop(activeLoop);
+		activeLoop = command;
+	}
+
+	publishLoop();
+}
+
+void Deck::renderTrack(int numSamples) noexcept
+{
+	for (int done = 0; done < numSamples;)
+	{
+		auto num = numSamples - done;
+
+		// A loop belongs to its track: once the playlist has another, drop it even mid-pass.
+		if (activeLoop != nullptr && activeLoop->trackId != playlist.getCurrentTrackId())
+		{
+			retireLoop(activeLoop);
+			retireLoop(nextLoop);
+			activeLoop = nextLoop = nullptr;
+			inLoop = leavingLoop = false;
+		}
+
+		if (activeLoop != nullptr && !inLoop)
+		{
+			// One the playhead's already past never starts.
+			auto position = playlist.getNextReadPosition();
+
+			if (position > activeLoop->end)
+			{
+				retireLoop(activeLoop);
+				activeLoop = nullptr;
+			}
+			else
+			{
+				// Up to the loop's end from the playlist, which then waits there.
+				num = (int)jmin((int64)num, activeLoop->end - position);
+				playlist.getNextAudioBlock(AudioSourceChannelInfo(&output, done, num));
+				done += num;
+
+				if (position + num == activeLoop->end)
+				{
+					inLoop = true;
+					loopPlayhead = activeLoop->start;
+				}
+
+				continue;
+			}
+		}
+
+		if (activeLoop == nullptr)
+		{
+			playlist.getNextAudioBlock(AudioSourceChannelInfo(&output, done, num));
+			break;
+		}
+
+		if (nextLoop != nullptr && !leavingLoop)
+		{
+			if (loopPlayhead >= nextLoop->start && loopPlayhead < nextLoop->end)
+			{
+				// A loop inside this one takes over in place, and the playlist
+				// waits at its end instead.
+				retireLoop(activeLoop);
+				activeLoop = nextLoop;
+				nextLoop = nullptr;
+				playlist.setNextReadPosition(activeLoop->end);
+			}
+			else if (loopPlayhead < nextLoop->start)
+			{
+				num = (int)jmin((int64)num, nextLoop->start - loopPlayhead);
+			}
+		}
+
+		num = (int)jmin((int64)num, activeLoop->end - loopPlayhead);
+		auto offset = (int)(loopPlayhead - activeLoop->start);
+
+		for (int ch = 0; ch < output.getNumChannels(); ++ch)
+			output.copyFrom(ch, done, activeLoop->audio, jmin(ch, activeLoop->audio.getNumChannels() - 1), offset, num);
+
+		done += num;
+		loopPlayhead += num;
+
+		if (loopPlayhead == activeLoop->end)
+		{
+			if (leavingLoop)
+			{
+				// The playlist carries on from where it waited.
+				retireLoop(activeLoop);
+				activeLoop = nextLoop;
+				nextLoop = nullptr;
+				inLoop = leavingLoop = false;
+			}
+			else
+			{
+				loopPlayhead = activeLoop->start;
+
+				// One this pass never reaches starts from its own beginning.
+				if (nextLoop != nullptr && loopPlayhead >= nextLoop->end)
+					loopPlayhead = nextLoop->start;
+			}
+		}
+	}
+
+	publishLoop();
+}
+
+void Deck::retireLoop(LoopRegion* region) noexcept
+{
+	if (region == nullptr)
+		return;
+
+	region->nextRetired = retiredLoops.load();
+
+	while (!retiredLoops.compare_exchange_weak(region->nextRetired, region))
+	{
+	}
+}
+
+void Deck::publishLoop() noexcept
+{
+	loopStart = activeLoop != nullptr ? activeLoop->start : 0;
+	loopEnd = activeLoop != nullptr ? activeLoop->end : 0;
+	loopPosition = inLoop ? loopPlayhead : -1;
+}
+
+//==============================================================================
+void Deck::setHotCue(int index)
+{
+	auto audioFile = playlist.getCurrentFile();
+
+	if (!isPositiveAndBelow(index, (int)numHotCues) || audioFile == File())
+		return;
+
+	auto position = getPosition();
+	auto beat = quantiseToBeat(position, false);
+
+	auto entry = hotCues.find(audioFile.getFullPathName());
+
+	if (entry == hotCues.end())
+	{
+		HotCues cues;
+
+		for (auto& seconds : cues.seconds)
+			seconds = -1.0;
+
+		entry = hotCues.insert({ audioFile.getFullPathName(), cues }).first;
+	}
+
+	entry->second.seconds[index] = beat >= 0.0 ? beat : position;
+}
+
+void Deck::clearHotCue(int index)
+{
+	auto entry = hotCues.find(playlist.getCurrentFile().getFullPathName());
+
+	if (entry != hotCues.end() && isPositiveAndBelow(index, (int)numHotCues))
+		entry->second.seconds[index] = -1.0;
+}
+
+double Deck::getHotCue(int index) const
+{
+	auto entry = hotCues.find(playlist.getCurrentFile().getFullPathName());
+
+	if (entry == hotCues.end() || !isPositiveAndBelow(index, (int)numHotCues))
+		return -1.0;
+
+	return entry->second.seconds[index];
+}
+
+bool Deck::jumpToHotCue(int index)
+{
+	auto seconds = getHotCue(index);
+
+	if (seconds < 0.0)
+		return false;
+
+	setPosition(seconds);
+	return true;
+}
+
+float Deck::getReadAheadFill() const
+{
+	auto* readAhead = playlist.getCurrentReadAhead();
+
+	if (readAhead == nullptr)
+		return -1.0f;
+
+	return (float)readAhead->getNumBufferedSamples() / (float)readAhead->getBufferSize();
+}
+
+int Deck::getNumUnderruns() const
+{
+	auto* readAhead = playlist.getCurrentReadAhead();
+	return readAhead != nullptr ? readAhead->getNumUnderruns() : 0;
+}
+
+std::shared_ptr<const TrackAnalysis> Deck::getTrackAnalysis(int trackId) const
+{
+	for (auto& slot : analysisSlots)
+	{
+		auto published = std::atomic_load(&slot.published);
+
+		if (trackId != 0 && published != nullptr && published->trackId == trackId)
+			return published->analysis;
+	}
+
+	return nullptr;
+}
+
+std::shared_ptr<const TrackAnalysis> Deck::getStemAnalysis(int trackId, StemSet::Stem stem) const
+{
+	for (auto& slot : analysisSlots)
+	{
+		auto published = std::atomic_load(&slot.published);
+
+		if (trackId != 0 && published != nullptr && published->trackId == trackId)
+			return published->stemAnalyses[stem];
+	}
+
+	return nullptr;
+}
+
+float Deck::getAnalysisProgress() const
+{
+	auto trackId = playlist.getCurrentTrackId();
+
+	for (auto& slot : analysisSlots)
+	{
+		if (trackId == 0 || slot.trackId.load() != trackId)
+			continue;
+
+		auto progress = slot.progress.load();
+
+		for (auto& stemProgress : slot.stemProgress)
+		{
+			auto stem = stemProgress.load();
+
+			if (stem >= 0.0f)
+				progress = progress >= 0.0f ? jmin(progress, stem) : stem;
+		}
+
+		return progress;
+	}
+
+	return -1.0f;
+}
+
+std::shared_ptr<const WaveformPyramid> Deck::getWaveform() const
+{
+	auto trackId = playlist.getCurrentTrackId();
+
+	for (auto& slot : analysisSlots)
+		if (trackId != 0 && slot.trackId.load() == trackId)
+			return slot.waveform;
+
+	return nullptr;
+}
+
+void Deck::startTrackAnalysis(const File& audioFile, int trackId)
+{
+	// Use whichever slot isn't holding the other track in the playlist.
+	auto otherId = trackId == playlist.getCurrentTrackId() ? playlist.getNextTrackId() : playlist.getCurrentTrackId();
+	auto& slot = analysisSlots[0].trackId.load() != otherId ? analysisSlots[0] : analysisSlots[1];
+
+	// Whatever that slot was analysing isn't wanted any more. Running jobs are told
+	// to stop but not waited for: one that finishes anyway finds the slot holding
+	// another track and its result is dropped.
+	TrackJobSelector oldJob(slot.trackId.load());
+	analysisPool.removeAllJobs(true, 0, &oldJob);
+
+	if (slot.waveform != nullptr)
+		slot.waveform->cancel();
+
+	slot.trackId = 0;
+	std::atomic_store(&slot.published, std::shared_ptr<const PublishedAnalysis>());
+	slot.cacheMissTrackId = 0;
+	slot.waveform = nullptr;
+	slot.waveformFile = File();
+	slot.progress = -1.0f;
+
+	for (auto& stemProgress : slot.stemProgress)
+		stemProgress = -1.0f;
+
+	// Shares the decoded copy playback uses, waiting for the decoder where it's behind.
+	if (auto* analysisReader = createReader(audioFile, true))
+	{
+		auto published = std::make_shared<PublishedAnalysis>();
+		published->trackId = trackId;
+		std::atomic_store(&slot.published, std::shared_ptr<const PublishedAnalysis>(std::move(published)));
+
+		slot.trackId = trackId;
+		slot.progress = 0.0f;
+
+		auto* job = new TrackAnalysisJob(audioFile, analysisReader, slot.progress,
+			[&slot, trackId](std::shared_ptr<TrackAnalysis> result)
+			{
+				publishAnalysis(slot, trackId, wholeTrack, std::move(result));
+			});
+
+		job->onCacheMiss = [&slot, trackId]
+		{
+			if (slot.trackId.load() == trackId)
+				slot.cacheMissTrackId = trackId;
+		};
+
+		job->setJobName(TrackJobSelector::getJobName(trackId));
+		analysisPool.addJob(job, true);
+
+		// One job per stem, under the track's name so they're cancelled with it.
+		auto stems = StemSet::fromFolder(audioFile);
+
+		for (int i = 0; i < StemSet::numStems; ++i)
+		{
+			auto* stemReader = stems.files[i] != File() ? decodedAudio.createReaderFor(stems.files[i], true) : nullptr;
+
+			if (stemReader == nullptr)
+				continue;
+
+			slot.stemProgress[i] = 0.0f;
+
+			auto* stemJob = new TrackAnalysisJob(stems.files[i], stemReader, slot.stemProgress[i],
+				[&slot, trackId, i](std::shared_ptr<TrackAnalysis> result)
+				{
+					publishAnalysis(slot, trackId, i, std::move(result));
+				});
+
+			stemJob->setJobName(TrackJobSelector::getJobName(trackId));
+			analysisPool.addJob(stemJob, true);
+		}
+
+		// The waveform waits to see whether the cache has it: see startWaveform().
+		slot.waveformFile = audioFile;
+		startWaveform(slot);
+	}
+}
+
+void Deck::startWaveform(AnalysisSlot& slot)
+{
+	auto trackId = slot.trackId.load();
+
+	if (trackId == 0 || slot.waveform != nullptr || slot.waveformFile == File())
+		return;
+
+	// A cache hit arrives with its waveform, long before a parallel summary would finish.
+	auto published = std::atomic_load(&slot.published);
+	auto analysis = published != nullptr && published->trackId == trackId ? published->analysis : nullptr;
+
+	if (analysis != nullptr)
+		slot.waveform = WaveformPyramid::fromAnalysis(*analysis);
+
+	// A miss has the whole track to analyse, which takes much longer than summarising it in parallel.
+	if (slot.waveform == nullptr && (analysis != nullptr || slot.cacheMissTrackId.load() == trackId))
+	{
+		auto audioFile = slot.waveformFile;
+		slot.waveform = WaveformPyramid::create(waveformPool, waveformPool.getNumThreads(),
+			[this, audioFile] { return createReader(audioFile, true); });
+	}
+
+	if (slot.waveform != nullptr || analysis != nullptr)
+		slot.waveformFile = File();
+}
+
+void Deck::publishAnalysis(AnalysisSlot& slot, int trackId, int stem, std::shared_ptr<const TrackAnalysis> analysis)
+{
+	auto current = std::atomic_load(&slot.published);
+
+	// Only onto this track's own entry: a job that outlived its cancel finds the
+	// slot holding another track and drops its result.
+	while (current != nullptr && current->trackId == trackId)
+	{
+		// The stems finish on their own threads; one that loses the race tries again on top of the other.
+		auto updated = std::make_shared<PublishedAnalysis>(*current);
+		(stem == wholeTrack ? updated->analysis : updated->stemAnalyses[stem]) = analysis;
+
+		if (std::atomic_compare_exchange_strong(&slot.published, &current, std::shared_ptr<const PublishedAnalysis>(std::move(updated))))
+		{
+			(stem == wholeTrack ? slot.progress : slot.stemProgress[stem]) = -1.0f;
+			return;
+		}
+	}
+}
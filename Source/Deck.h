@@ -0,0 +1,256 @@
+/*
+  ==============================================================================
+
+    Deck.h
+    Created: 17 Oct 2026 10:31:46pm
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "DecodedAudioCache.h"
+#include "GroovAnalyser.h"
+#include "PlaylistSource.h"
+#include "StemSet.h"
+#include "TrackAnalysisJob.h"
+#include "WaveformPyramid.h"
+#include <map>
+
+//==============================================================================
+/**
+	One of the mixer's players: a playlist with its own transport, live
+	analysis and track pre-analysis.
+
+	Stands in for AudioTransportSource, which takes a lock in every callback.
+	start(), stop(), seeks and loads here only touch atomics, and the audio
+	thread picks them up at the start of its next block. Starting and stopping
+	fade over one block so they don't click.
+
+	Loops are set on the track's beat grid and rendered into memory at the
+	device rate when they're set. Once the playhead reaches a loop's end the
+	playlist is simply left waiting there while the audio thread plays the loop
+	round from memory, so the wrap is sample-accurate and costs no disk or
+	decoder work; leaving the loop finishes the pass and picks the playlist up
+	where it waited. A loop set inside a playing one takes over once the
+	playhead reaches it, and the playlist is sent to wait at its end instead.
+
+	A stem set's folder loads like a file: the stems are decoded side by side
+	and played summed, the sum is analysed as the track, and each stem gets an
+	analysis of its own as well.
+
+	Track ids are unique across decks, so an id alone says which deck's
+	analysis to look in. Everything not marked otherwise is for the message
+	thread.
+*/
+class Deck
+{
+public:
+	Deck(const String& deckName, DecodedAudioCache& decodedAudioToUse, TimeSliceThread& readAheadThreadToUse,
+		 ThreadPool& analysisPoolToUse, ThreadPool& waveformPoolToUse);
+	~Deck();
+
+	const String name;
+
+	void prepareToPlay(int samplesPerBlockExpected, double sampleRate, int numAnalysedChannels);
+	void releaseResources();
+
+	/** Audio thread: renders up to samplesPerBlockExpected samples into
+		getOutput(), faded if the deck is starting or stopping, and hands them to
+		the analyser. Returns false if it's stopped and the block is silent.
+		Never blocks or allocates. */
+	bool renderNextBlock(int numSamples) noexcept;
+	const AudioBuffer<float>& getOutput() const noexcept	{ return output; }
+
+	/** Safe from any thread. */
+	void start() noexcept						{ playing = true; }
+	void stop() noexcept						{ playing = false; }
+	bool isPlaying() const noexcept				{ return playing.load(); }
+
+	/** Stops the deck and replaces whatever it had with audioFile, from the top.
+		audioFile may be a stem set's folder, in which case any stems that had to
+		be left out are added to leftOutStems. Returns false if it can't be read. */
+	bool loadFile(const File& audioFile, StringArray* leftOutStems = nullptr);
+	/** Adds a file to the deck's playlist, to follow the current track without a gap. */
+	void queueFile(const File& audioFile);
+	int getNumQueued() const;
+	void setCrossfadeLength(double seconds)		{ playlist.setCrossfadeLength(seconds); }
+
+	/** Read-ahead for tracks loaded from now on. The current track is reloaded
+		with it, in place and without stopping. */
+	void setReadAheadSeconds(double seconds);
+
+	/** Call regularly: frees finished tracks, loads the next queued one, starts
+		waveforms and rewinds after a stop. Returns true if the deck has stopped since. */
+	bool update();
+
+	/** Audio or message thread. */
+	int getCurrentTrackId() const noexcept		{ return playlist.getCurrentTrackId(); }
+	File getCurrentFile() const					{ return playlist.getCurrentFile(); }
+
+	/** Position in the current track, in seconds, inside the loop while there is
+		one. Audio or message thread. */
+	double getPosition() const noexcept;
+	/** Also drops any loop straight away. With read-ahead, a jump past what's
+		decoded plays on from the old position until the new one is buffered,
+		rather than dropping out. */
+	void setPosition(double seconds);
+
+	/** Loops numBeats from the beat nearest the playhead. The loop starts once
+		the playhead reaches its end. False without a beat grid. */
+	bool setBeatLoop(int numBeats);
+	/** Marks where setLoopOut() will loop from: the beat nearest the playhead. */
+	void setLoopIn();
+	/** Loops from the loop in point to the next beat at or after the playhead.
+		False without a beat grid or a loop in point on this track. */
+	bool setLoopOut();
+	/** Leaves the loop at the end of its current pass and plays on from there. */
+	void exitLoop();
+	/** The loop in seconds, whether or not the playhead has reached it yet; empty
+		for none. Audio or message thread. */
+	Range<double> getLoop() const noexcept;
+	bool isLooping() const noexcept				{ return loopEnd.load() > 0; }
+	/** True once the playhead has reached the loop and it's playing round. */
+	bool isInLoop() const noexcept				{ return loopPosition.load() >= 0; }
+
+	/** Hot cues sit on the beat nearest the playhead when they're set, or
+		exactly on it without a beat grid. They belong to the file, so they come
+		back if it's loaded again; -1 for an unset one. */
+	enum { numHotCues = 4 };
+	void setHotCue(int index);
+	void clearHotCue(int index);
+	double getHotCue(int index) const;
+	/** False if the cue isn't set. */
+	bool jumpToHotCue(int index);
+
+	/** Read-ahead buffer fill, 0..1, or -1 with no read-ahead. */
+	float getReadAheadFill() const;
+	/** Blocks the read-ahead couldn't serve in time since the track was loaded. */
+	int getNumUnderruns() const;
+
+	GroovAnalyser& getAnalyser() noexcept		{ return analyser; }
+
+	/** Pre-analysis of one of this deck's tracks, or nullptr until it's ready. Safe from any thread. */
+	std::shared_ptr<const TrackAnalysis> getTrackAnalysis(int trackId) const;
+	/** The same for one stem, if the track is a stem set with that stem. */
+	std::shared_ptr<const TrackAnalysis> getStemAnalysis(int trackId, StemSet::Stem stem) const;
+	/** 0..1 while the current track or any of its stems is being analysed,
+		going by whichever is furthest behind; -1 otherwise. */
+	float getAnalysisProgress() const;
+	/** Waveform of the current track, possibly still being built, or nullptr. */
+	std::shared_ptr<const WaveformPyramid> getWaveform() const;
+
+private:
+	// A queued track has to be decoded before its turn comes, so it always gets at least this much.
+	static constexpr double queuedReadAheadSeconds = 2.0;
+
+	// A loop's audio, or with no audio the order to leave the loop: at the end
+	// of the pass, or straight away if exitNow is set.
+	struct LoopRegion
+	{
+		int trackId = 0;
+		int64 start = 0, end = 0;	// Device samples in the track
+		AudioBuffer<float> audio;	// At the device rate
+		bool exitNow = false;
+		LoopRegion* nextRetired = nullptr;
+	};
+
+	LoopRegion* createLoopRegion(double startSeconds, double endSeconds);
+	void sendLoopCommand(LoopRegion* command);
+	/** The nearest beat, or the next at or after seconds; -1 without a beat grid. */
+	double quantiseToBeat(double seconds, bool roundUp) const;
+
+	// Audio thread
+	void takeLoopCommand() noexcept;
+	void renderTrack(int numSamples) noexcept;
+	void retireLoop(LoopRegion* region) noexcept;
+	void publishLoop() noexcept;
+
+	AudioFormatReader* createReader(const File& audioFile, bool waitForDecoder, StringArray* leftOutStems = nullptr);
+	std::unique_ptr<PlaylistSource::Track> createTrack(const File& audioFile, int trackId, bool isQueued,
+													   StringArray* leftOutStems = nullptr);
+	void queueNextTrack();
+	void startTrackAnalysis(const File& audioFile, int trackId);
+
+	static int createTrackId();
+
+	DecodedAudioCache& decodedAudio;
+	TimeSliceThread& readAheadThread;
+	ThreadPool& analysisPool;
+	ThreadPool& waveformPool;
+
+	PlaylistSource playlist;
+	Array<File> queue;
+	double readAheadSeconds = 0.0;
+
+	std::atomic<bool> playing{ false }, hasStopped{ false };
+	std::atomic<double> sampleRate{ 0.0 };
+
+	// Audio thread only
+	AudioBuffer<float> output;
+	float fadeGain = 0.0f;
+
+	// Loops reach the audio thread one command at a time, and go back to the
+	// message thread to be deleted.
+	std::atomic<LoopRegion*> incomingLoop{ nullptr }, retiredLoops{ nullptr };
+	std::atomic<int64> loopStart{ 0 }, loopEnd{ 0 };	// The audio thread's current loop, device samples, 0 for none
+	std::atomic<int64> loopPosition{ -1 };				// Where it is in it, -1 until the loop's started
+
+	// Audio thread only
+	LoopRegion* activeLoop = nullptr;
+	LoopRegion* nextLoop = nullptr;		// Takes over when activeLoop's pass ends, or inside it if it's nested
+	bool inLoop = false, leavingLoop = false;
+	int64 loopPlayhead = 0;
+
+	// Message thread only
+	double loopInSeconds = -1.0;
+	int loopInTrackId = 0;
+	struct HotCues { double seconds[numHotCues]; };
+	std::map<String, HotCues> hotCues;		// By file path
+
+	GroovAnalyser analyser;
+
+	// A track's id and its analyses, swapped in as one so no reader can pair a
+	// track with the analysis of the one its slot held before. Never changed
+	// once published; each result replaces the whole thing.
+	struct PublishedAnalysis
+	{
+		int trackId = 0;
+		std::shared_ptr<const TrackAnalysis> analysis;
+
+		// A stem set's stems, each analysed on its own; a plain file leaves these empty.
+		std::shared_ptr<const TrackAnalysis> stemAnalyses[StemSet::numStems];
+	};
+
+	// One for the current track and one for the next, so the analysis is
+	// ready the moment the playlist moves on.
+	struct AnalysisSlot
+	{
+		AnalysisSlot()								{ for (auto& p : stemProgress) p = -1.0f; }
+
+		std::atomic<int> trackId{ 0 };
+		std::atomic<float> progress{ -1.0f };
+		std::atomic<float> stemProgress[StemSet::numStems];	// -1 for a stem that isn't being analysed
+		std::shared_ptr<const PublishedAnalysis> published;	// Only through atomic_load/atomic_store
+		std::atomic<int> cacheMissTrackId{ 0 };		// Set once the analysis job finds the track isn't cached
+
+		// Message thread only
+		std::shared_ptr<WaveformPyramid> waveform;
+		File waveformFile;		// Until its waveform has been started
+	};
+
+	AnalysisSlot analysisSlots[2];
+
+	/** Worker thread: hands a finished analysis of the track, or of one of its
+		stems, to the slot, unless it's been given to another track since. */
+	static void publishAnalysis(AnalysisSlot& slot, int trackId, int stem, std::shared_ptr<const TrackAnalysis> analysis);
+	enum { wholeTrack = -1 };
+
+	/** Takes a slot's waveform from its cached analysis, or summarises the track
+		in parallel with the analysis if the cache didn't have it. */
+	void startWaveform(AnalysisSlot& slot);
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Deck)
+};
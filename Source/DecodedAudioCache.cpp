@@ -0,0 +1,434 @@
+/*
+  ==============================================================================
+
+    DecodedAudioCache.cpp
+    Created: 17 Oct 2026 6:48:25pm
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#include "DecodedAudioCache.h"
+#include "Mp3SeekIndex.h"
+
+namespace
+{
+	const float int16Scale = 32767.0f;
+	const double secondsToAlign = 30.0;		// Decoded before an MP3's seek index is checked and used
+
+	//==============================================================================
+	// Fills a DecodedTrack from the start, a chunk at a time. For an MP3 it also
+	// indexes the frames, and once there's enough decoded to check the index
+	// against, hands it to the track for readers to jump ahead with.
+	class DecodeJob : public ThreadPoolJob
+	{
+	public:
+		DecodeJob(std::shared_ptr<DecodedTrack> trackToFill, AudioFormatReader* readerToUse, const File& audioFile)
+			: ThreadPoolJob("Decode"), track(std::move(trackToFill)), reader(readerToUse), file(audioFile)
+		{
+		}
+
+		JobStatus runJob() override
+		{
+			AudioBuffer<float> buffer(track->numChannels, samplesPerRead);
+
+			std::unique_ptr<Mp3SeekIndex> seekIndex;
+
+			if (file.hasFileExtension("mp3"))
+				seekIndex = Mp3SeekIndex::build(file);
+
+			auto alignPosition = jmin(track->lengthInSamples, (int64)(secondsToAlign * track->sampleRate));
+
+			for (int64 position = 0; position < track->lengthInSamples; position += samplesPerRead)
+			{
+				if (shouldExit() || track->isCancelled())
+				{
+					track->finish();
+					return jobHasFinished;
+				}
+
+				auto numSamples = (int)jmin((int64)samplesPerRead, track->lengthInSamples - position);
+				reader->read(&buffer, 0, numSamples, position, true, true);
+				track->write(buffer, position, numSamples);
+
+				if (seekIndex != nullptr && position + numSamples >= alignPosition)
+					publishSeekIndex(std::move(seekIndex));
+			}
+
+			track->finish();
+			return jobHasFinished;
+		}
+
+	private:
+		enum { samplesPerRead = 32768 };
+
+		void publishSeekIndex(std::unique_ptr<Mp3SeekIndex> seekIndex)
+		{
+			// Checked against what we decoded from the top; one that doesn't match is never used.
+			auto trackToRead = track.get();
+			auto reference = [trackToRead](float* const* dest, int numChannels, int64 startSample, int numSamples)
+			{
+				trackToRead->read(dest, numChannels, 0, startSample, numSamples);
+			};
+
+			if (seekIndex->alignWith(reference, track->getNumDecoded()))
+				track->setSeekIndex(std::move(seekIndex));
+		}
+
+		std::shared_ptr<DecodedTrack> track;
+		std::unique_ptr<AudioFormatReader> reader;
+		const File file;
+	};
+
+	//==============================================================================
+	// Reads from a DecodedTrack. What isn't decoded yet is waited for, or read
+	// through the track's seek index or a fallback reader of its own.
+	class DecodedTrackReader : public AudioFormatReader
+	{
+	public:
+		DecodedTrackReader(std::shared_ptr<DecodedTrack> trackToRead, AudioFormatReader* fallbackReader, bool shouldWait)
+			: AudioFormatReader(nullptr, "Decoded audio"),
+			  track(std::move(trackToRead)),
+			  fallback(fallbackReader),
+			  waitForDecoder(shouldWait)
+		{
+			sampleRate = track->sampleRate;
+			numChannels = (unsigned int)track->numChannels;
+			lengthInSamples = track->lengthInSamples;
+			bitsPerSample = 32;
+			usesFloatingPointData = true;
+		}
+
+		bool readSamples(int** destSamples, int numDestChannels, int startOffsetInDestBuffer,
+						 int64 startSampleInFile, int numSamples) override
+		{
+			clearSamplesBeyondAvailableLength(destSamples, numDestChannels, startOffsetInDestBuffer,
+											  startSampleInFile, numSamples, lengthInSamples);
+
+			if (numSamples <= 0)
+				return true;
+
+			auto endSample = startSampleInFile + numSamples;
+
+			if (waitForDecoder)
+			{
+				while (!track->waitUntilDecoded(endSample, 100) && !track->isFinished())
+				{
+					// A cancelled analysis or waveform job mustn't sit here behind the decode.
+					auto* job = ThreadPoolJob::getCurrentThreadPoolJob();
+
+					if (job != nullptr && job->shouldExit())
+					{
+						for (int ch = 0; ch < numDestChannels; ++ch)
+							if (destSamples[ch] != nullptr)
+								zeromem(destSamples[ch] + startOffsetInDestBuffer, sizeof(float) * (size_t)numSamples);
+
+						return false;
+					}
+				}
+			}
+
+			if (track->getNumDecoded() >= endSample)
+			{
+				track->read(reinterpret_cast<float* const*>(destSamples), numDestChannels, startOffsetInDestBuffer,
+							startSampleInFile, numSamples);
+				return true;
+			}
+
+			if (seeker == nullptr && !waitForDecoder)
+				if (auto seekIndex = track->getSeekIndex())
+					seeker.reset(new SeekableMp3Reader(seekIndex));
+
+			// The index has no clean entry near every position; the fallback reader covers those.
+			if (seeker != nullptr
+				&& seeker->readSamples(destSamples, numDestChannels, startOffsetInDestBuffer, startSampleInFile, numSamples))
+				return true;
+
+			if (fallback != nullptr)
+				return fallback->readSamples(destSamples, numDestChannels, startOffsetInDestBuffer, startSampleInFile, numSamples);
+
+			for (int ch = 0; ch < numDestChannels; ++ch)
+				if (destSamples[ch] != nullptr)
+					zeromem(destSamples[ch] + startOffsetInDestBuffer, sizeof(float) * (size_t)numSamples);
+
+			return false;
+		}
+
+	private:
+		std::shared_ptr<DecodedTrack> track;
+		std::unique_ptr<AudioFormatReader> fallback;
+		std::unique_ptr<SeekableMp3Reader> seeker;
+		const bool waitForDecoder;
+	};
+}
+
+//==============================================================================
+DecodedTrack::DecodedTrack(double rate, int channels, int64 length, SampleFormat sampleFormat)
+	: sampleRate(rate),
+	  numChannels(channels),
+	  lengthInSamples(length),
+	  format(sampleFormat),
+	  bytesPerSample(sampleFormat == int16Samples ? sizeof(int16) : sizeof(float))
+{
+}
+
+DecodedTrack::~DecodedTrack()
+{
+	mapped.reset();
+
+	if (spillFile != File())
+		spillFile.deleteFile();
+}
+
+bool DecodedTrack::allocateInMemory()
+{
+	memory.allocate(getSizeInBytes(), false);
+	data = memory.get();
+	return data != nullptr;
+}
+
+bool DecodedTrack::allocateOnDisk(const File& file)
+{
+	{
+		FileOutputStream out(file);
+
+		if (!out.openedOk() || !out.setPosition((int64)getSizeInBytes() - 1) || !out.writeByte(0))
+		{
+			file.deleteFile();
+			return false;
+		}
+	}
+
+	spillFile = file;
+	mapped.reset(new MemoryMappedFile(file, MemoryMappedFile::readWrite, false));
+	data = mapped->getData();
+
+	return data != nullptr && mapped->getSize() >= getSizeInBytes();
+}
+
+void* DecodedTrack::getChannel(int channel) const noexcept
+{
+	return static_cast<char*>(data) + (size_t)(channel * lengthInSamples) * bytesPerSample;
+}
+
+void DecodedTrack::write(const AudioBuffer<float>& source, int64 startSample, int numSamples)
+{
+	jassert(startSample == numDecoded.load());
+
+	for (int ch = 0; ch < numChannels; ++ch)
+	{
+		auto* src = source.getReadPointer(jmin(ch, source.getNumChannels() - 1));
+
+		if (format == floatSamples)
+		{
+			FloatVectorOperations::copy(static_cast<float*>(getChannel(ch)) + startSample, src, numSamples);
+		}
+		else
+		{
+			auto* dest = static_cast<int16*>(getChannel(ch)) + startSample;
+
+			for (int i = 0; i < numSamples; ++i)
+				dest[i] = (int16)roundToInt(jlimit(-1.0f, 1.0f, src[i]) * int16Scale);
+		}
+	}
+
+	// Publishing after the samples are written is what makes them safe to read.
+	numDecoded.store(startSample + numSamples);
+	progress.signal();
+}
+
+void DecodedTrack::finish()
+{
+	finished = true;
+	progress.signal();
+}
+
+void DecodedTrack::read(float* const* dest, int numDestChannels, int destOffset, int64 startSample, int numSamples) const noexcept
+{
+	jassert(startSample + numSamples <= numDecoded.load());
+
+	for (int ch = 0; ch < numDestChannels; ++ch)
+	{
+		if (dest[ch] == nullptr)
+			continue;
+
+		auto* out = dest[ch] + destOffset;
+		auto srcChannel = jmin(ch, numChannels - 1);
+
+		if (format == floatSamples)
+		{
+			FloatVectorOperations::copy(out, static_cast<const float*>(getChannel(srcChannel)) + startSample, numSamples);
+		}
+		else
+		{
+			auto* src = static_cast<const int16*>(getChannel(srcChannel)) + startSample;
+
+			for (int i = 0; i < numSamples; ++i)
+				out[i] = src[i] * (1.0f / int16Scale);
+		}
+	}
+}
+
+bool DecodedTrack::waitUntilDecoded(int64 endSample, int timeoutMs) const
+{
+	auto giveUpTime = Time::getMillisecondCounter() + (uint32)timeoutMs;
+
+	while (numDecoded.load() < endSample && !finished.load())
+	{
+		auto now = Time::getMillisecondCounter();
+
+		if (now >= giveUpTime)
+			return false;
+
+		// Auto-reset, so with several readers waiting some only wake on the timeout.
+		progress.wait(jmin(10, (int)(giveUpTime - now)));
+	}
+
+	return numDecoded.load() >= endSample;
+}
+
+//==============================================================================
+DecodedAudioCache::DecodedAudioCache(AudioFormatManager& formatManagerToUse)
+	: formatManager(formatManagerToUse)
+{
+	// Whatever's there was spilled by a run that never got to delete it.
+	getSpillDirectory().deleteRecursively();
+}
+
+DecodedAudioCache::~DecodedAudioCache()
+{
+	for (auto& entry : entries)
+		entry.track->cancel();
+
+	decodePool.removeAllJobs(true, 5000);
+}
+
+AudioFormatReader* DecodedAudioCache::createReaderFor(const File& audioFile, bool waitForDecoder)
+{
+	// Uncompressed files: map them and let the OS share the pages.
+	if (auto* format = formatManager.findFormatForFileExtension(audioFile.getFileExtension()))
+	{
+		if (auto* mappedReader = format->createMemoryMappedReader(audioFile))
+		{
+			if (mappedReader->mapEntireFile())
+				return mappedReader;
+
+			delete mappedReader;
+		}
+	}
+
+	auto track = getTrack(audioFile);
+
+	if (track == nullptr)
+		return formatManager.createReaderFor(audioFile);
+
+	// Playback can't wait for the decoder, so it streams whatever isn't ready yet.
+	AudioFormatReader* fallback = nullptr;
+
+	if (!waitForDecoder && track->getNumDecoded() < track->lengthInSamples)
+		fallback = formatManager.createReaderFor(audioFile);
+
+	return new DecodedTrackReader(track, fallback, waitForDecoder);
+}
+
+std::shared_ptr<DecodedTrack> DecodedAudioCache::getTrack(const File& audioFile)
+{
+	auto key = audioFile.getFullPathName() + ":" + String(audioFile.getSize()) + ":"
+		+ String(audioFile.getLastModificationTime().toMilliseconds());
+
+	for (auto i = entries.begin(); i != entries.end(); ++i)
+	{
+		if (i->key == key)
+		{
+			// Move it to the most recently used end.
+			auto entry = std::move(*i);
+			entries.erase(i);
+			entries.push_back(std::move(entry));
+			return entries.back().track;
+		}
+	}
+
+	std::unique_ptr<AudioFormatReader> reader(formatManager.createReaderFor(audioFile));
+
+	if (reader == nullptr || reader->lengthInSamples <= 0)
+		return nullptr;
+
+	auto track = std::make_shared<DecodedTrack>(reader->sampleRate, jlimit(1, 2, (int)reader->numChannels),
+												reader->lengthInSamples, sampleFormat);
+	auto size = (int64)track->getSizeInBytes();
+
+	evictToFit(size);
+
+	// Over budget even with everything unused gone: keep this one on disk instead.
+	auto allocated = getMemoryUsed() + size <= memoryBudget
+		? track->allocateInMemory()
+		: track->allocateOnDisk(getSpillDirectory().getNonexistentChildFile(audioFile.getFileNameWithoutExtension(), ".pcm"));
+
+	if (!allocated)
+		return nullptr;
+
+	decodePool.addJob(new DecodeJob(track, reader.release(), audioFile), true);
+	entries.push_back({ key, track });
+	return track;
+}
+
+void DecodedAudioCache::setMemoryBudget(int64 numBytes)
+{
+	memoryBudget = jmax((int64)0, numBytes);
+	evictToFit(0);
+}
+
+int64 DecodedAudioCache::getMemoryUsed() const noexcept
+{
+	int64 total = 0;
+
+	for (auto& entry : entries)
+		if (entry.track->isInMemory())
+			total += (int64)entry.track->getSizeInBytes();
+
+	return total;
+}
+
+void DecodedAudioCache::evictToFit(int64 numBytes)
+{
+	// A spilled track nobody's reading frees no RAM, but it holds a temp file the
+	// size of the track, and over a long set those add up. Decoding it again if
+	// it's loaded again is cheaper, so it goes whatever the budget.
+	for (auto i = entries.begin(); i != entries.end();)
+	{
+		if (i->track.use_count() == 1 && !i->track->isInMemory())
+		{
+			i->track->cancel();
+			i = entries.erase(i);
+		}
+		else
+		{
+			++i;
+		}
+	}
+
+	auto used = getMemoryUsed();
+
+	for (auto i = entries.begin(); i != entries.end() && used + numBytes > memoryBudget;)
+	{
+		// A track that's still being decoded or read stays, or it would be decoded
+		// twice. Spilled ones don't count against the budget.
+		if (i->track.use_count() > 1 || !i->track->isInMemory())
+		{
+			++i;
+			continue;
+		}
+
+		used -= (int64)i->track->getSizeInBytes();
+
+		i->track->cancel();
+		i = entries.erase(i);
+	}
+}
+
+File DecodedAudioCache::getSpillDirectory() const
+{
+	auto directory = File::getSpecialLocation(File::tempDirectory).getChildFile("Groov Decoded Audio");
+	directory.createDirectory();
+	return directory;
+}
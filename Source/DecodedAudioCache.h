@@ -0,0 +1,149 @@
+/*
+  ==============================================================================
+
+    DecodedAudioCache.h
+    Created: 17 Oct 2026 6:48:25pm
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+class Mp3SeekIndex;
+
+//==============================================================================
+/**
+	One file's audio decoded to PCM, shared by every reader of that file.
+
+	Samples are stored planar, one channel after another, as float or int16,
+	either in memory or in a memory-mapped file on disk. A background job
+	fills it from the start; numDecoded says how far it has got, and readers
+	only touch what's below it.
+*/
+class DecodedTrack
+{
+public:
+	enum SampleFormat { floatSamples, int16Samples };
+
+	DecodedTrack(double sampleRate, int numChannels, int64 lengthInSamples, SampleFormat format);
+	~DecodedTrack();
+
+	/** Keeps the samples in RAM. Returns false if the allocation failed. */
+	bool allocateInMemory();
+	/** Keeps the samples in a memory-mapped file, deleted again with the track. */
+	bool allocateOnDisk(const File& spillFile);
+
+	/** Decoder only: stores numSamples starting at startSample, then publishes them. */
+	void write(const AudioBuffer<float>& source, int64 startSample, int numSamples);
+	/** Decoder only: nothing more is coming, whether or not the whole file made it. */
+	void finish();
+
+	/** Copies samples below getNumDecoded() out as floats. Safe from any thread. */
+	void read(float* const* dest, int numDestChannels, int destOffset, int64 startSample, int numSamples) const noexcept;
+
+	/** Blocks until at least endSample is decoded, decoding stops, or timeoutMs passes. */
+	bool waitUntilDecoded(int64 endSample, int timeoutMs) const;
+
+	int64 getNumDecoded() const noexcept		{ return numDecoded.load(); }
+	bool isFinished() const noexcept			{ return finished.load(); }
+	bool isInMemory() const noexcept			{ return mapped == nullptr; }
+	size_t getSizeInBytes() const noexcept		{ return (size_t)(numChannels * lengthInSamples) * bytesPerSample; }
+
+	/** Decoder only: an aligned index for reading ahead of it without scanning. */
+	void setSeekIndex(std::shared_ptr<const Mp3SeekIndex> index)	{ std::atomic_store(&seekIndex, std::move(index)); }
+	std::shared_ptr<const Mp3SeekIndex> getSeekIndex() const		{ return std::atomic_load(&seekIndex); }
+
+	void cancel() noexcept						{ cancelled = true; }
+	bool isCancelled() const noexcept			{ return cancelled.load(); }
+
+	const double sampleRate;
+	const int numChannels;
+	const int64 lengthInSamples;
+	const SampleFormat format;
+
+private:
+	void* getChannel(int channel) const noexcept;
+
+	const size_t bytesPerSample;
+	HeapBlock<char> memory;
+	std::unique_ptr<MemoryMappedFile> mapped;
+	File spillFile;
+	void* data = nullptr;
+
+	std::shared_ptr<const Mp3SeekIndex> seekIndex;
+	std::atomic<int64> numDecoded{ 0 };
+	std::atomic<bool> finished{ false }, cancelled{ false };
+	mutable WaitableEvent progress;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DecodedTrack)
+};
+
+//==============================================================================
+/**
+	Decodes each compressed file once and lets playback, analysis and the
+	waveform display all read the same copy.
+
+	createReaderFor() hands out ordinary AudioFormatReaders. WAV and AIFF files
+	aren't cached at all: they get a memory-mapped reader, so the OS page
+	cache does the sharing. Anything else is decoded in the background into a
+	DecodedTrack, in memory while it fits the budget and spilled to a
+	memory-mapped temp file when it doesn't. The least recently used tracks
+	that nobody is reading any more are dropped first. Spilled ones nobody
+	is reading are dropped at the next load, so their files don't pile up.
+
+	A reader asked for samples that haven't been decoded yet either waits for
+	them (offline analysis) or streams them from its own decoder meanwhile
+	(playback, which can't wait). For MP3s that decoder jumps through an
+	Mp3SeekIndex once the decode has got far enough to check it against, so a
+	cue past the decoded part doesn't scan the file from the top.
+
+	Message thread only, apart from the readers themselves.
+*/
+class DecodedAudioCache
+{
+public:
+	explicit DecodedAudioCache(AudioFormatManager& formatManagerToUse);
+	~DecodedAudioCache();
+
+	/** Caller owns the reader. nullptr if the file can't be opened. */
+	AudioFormatReader* createReaderFor(const File& audioFile, bool waitForDecoder);
+
+	/** Most decoded audio to keep in RAM, in bytes. Shrinking it evicts straight away. */
+	void setMemoryBudget(int64 numBytes);
+	int64 getMemoryBudget() const noexcept				{ return memoryBudget; }
+	int64 getMemoryUsed() const noexcept;
+
+	/** int16 halves the memory per track. Applies to tracks decoded from now on. */
+	void setSampleFormat(DecodedTrack::SampleFormat newFormat)	{ sampleFormat = newFormat; }
+	DecodedTrack::SampleFormat getSampleFormat() const noexcept	{ return sampleFormat; }
+
+	int getNumTracks() const noexcept					{ return (int)entries.size(); }
+
+private:
+	struct Entry
+	{
+		String key;
+		std::shared_ptr<DecodedTrack> track;
+	};
+
+	std::shared_ptr<DecodedTrack> getTrack(const File& audioFile);
+	void evictToFit(int64 numBytes);
+	File getSpillDirectory() const;
+
+	AudioFormatManager& formatManager;
+	int64 memoryBudget = (int64)512 * 1024 * 1024;
+	DecodedTrack::SampleFormat sampleFormat = DecodedTrack::floatSamples;
+
+	// Least recently used first.
+	std::vector<Entry> entries;
+
+	// Declared last so its jobs stop before the tracks they fill go away. A few
+	// threads, so a stem set's stems decode side by side.
+	enum { maxParallelDecodes = 4 };
+	ThreadPool decodePool{ jlimit(1, (int)maxParallelDecodes, SystemStats::getNumCpus() - 1) };
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DecodedAudioCache)
+};
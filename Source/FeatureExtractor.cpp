@@ -0,0 +1,171 @@
+/*
+  ==============================================================================
+
+    FeatureExtractor.cpp
+    Created: 17 Oct 2026 10:21:50am
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#include "FeatureExtractor.h"
+
+FeatureExtractor::FeatureExtractor()
+{
+	history.calloc(AnalysisFrame::fftSize);
+	fftData.calloc(AnalysisFrame::fftSize * 2);
+}
+
+void FeatureExtractor::prepare(double newSampleRate, int newNumChannels, int numBands)
+{
+	sampleRate = newSampleRate;
+	numChannels = jlimit(1, (int)AnalysisFrame::maxChannels, newNumChannels);
+
+	beatTracker.prepare(sampleRate, hopSize);
+	bandMeter.prepare(sampleRate, numBands);
+	loudnessMeter.prepare(sampleRate, numChannels);
+	filterbank.prepare(sampleRate, AnalysisFrame::fftSize);
+	chromaExtractor.prepare(sampleRate, AnalysisFrame::fftSize, hopSize);
+	reset();
+}
+
+void FeatureExtractor::reset()
+{
+	FloatVectorOperations::clear(history.get(), AnalysisFrame::fftSize);
+	historyPos = 0;
+	samplesUntilHop = hopSize;
+	samplesProcessed = 0;
+
+	for (int ch = 0; ch < AnalysisFrame::maxChannels; ++ch)
+	{
+		hopSumSquares[ch] = 0.0f;
+		hopPeak[ch] = 0.0f;
+	}
+
+	frame = AnalysisFrame();
+	frame.sampleRate = sampleRate;
+
+	beatTracker.reset();
+	bandMeter.reset();
+	loudnessMeter.reset();
+	chromaExtractor.reset();
+}
+
+void FeatureExtractor::process(const AudioBuffer<float>& buffer, int numSamples, const FrameCallback& onFrame)
+{
+	auto channelsToRead = jmin(numChannels, buffer.getNumChannels());
+
+	if (channelsToRead == 0)
+		return;
+
+	auto mixGain = 1.0f / (float)channelsToRead;
+	int pos = 0;
+
+	while (pos < numSamples)
+	{
+		auto num = jmin(samplesUntilHop, numSamples - pos);
+
+		// Level meters, per channel.
+		for (int ch = 0; ch < channelsToRead; ++ch)
+		{
+			auto* src = buffer.getReadPointer(ch, pos);
+			hopPeak[ch] = jmax(hopPeak[ch], kernels.peak(src, num));
+			hopSumSquares[ch] += kernels.sumSquares(src, num);
+		}
+
+		// A buffer short of channels repeats its last one, as the level meters report it.
+		const float* loudnessChannels[AnalysisFrame::maxChannels];
+
+		for (int ch = 0; ch < numChannels; ++ch)
+			loudnessChannels[ch] = buffer.getReadPointer(jmin(ch, channelsToRead - 1), pos);
+
+		loudnessMeter.process(loudnessChannels, num);
+
+		// Mono mixdown into the circular history, in at most two pieces.
+		auto first = jmin(num, (int)AnalysisFrame::fftSize - historyPos);
+		int pieces[2][2] = { { historyPos, 0 }, { 0, first } };
+		int lengths[2] = { first, num - first };
+
+		for (int p = 0; p < 2; ++p)
+		{
+			if (lengths[p] == 0)
+				continue;
+
+			auto* dest = history.get() + pieces[p][0];
+			FloatVectorOperations::copyWithMultiply(dest, buffer.getReadPointer(0, pos + pieces[p][1]), mixGain, lengths[p]);
+
+			for (int ch = 1; ch < channelsToRead; ++ch)
+				FloatVectorOperations::addWithMultiply(dest, buffer.getReadPointer(ch, pos + pieces[p][1]), mixGain, lengths[p]);
+
+			bandMeter.process(dest, lengths[p]);
+		}
+
+		historyPos = (historyPos + num) & (AnalysisFrame::fftSize - 1);
+		samplesUntilHop -= num;
+		samplesProcessed += num;
+		pos += num;
+
+		if (samplesUntilHop == 0)
+		{
+			analyseFrame();
+
+			if (onFrame)
+				onFrame(frame);
+
+			samplesUntilHop = hopSize;
+		}
+	}
+}
+
+void FeatureExtractor::analyseFrame()
+{
+	frame.samplePosition = samplesProcessed;
+	frame.sampleRate = sampleRate;
+
+	for (int ch = 0; ch < AnalysisFrame::maxChannels; ++ch)
+	{
+		// Mono input reports the same level on both sides.
+		auto src = jmin(ch, numChannels - 1);
+		frame.rms[ch] = std::sqrt(hopSumSquares[src] / (float)hopSize);
+		frame.peak[ch] = hopPeak[src];
+	}
+
+	for (int ch = 0; ch < AnalysisFrame::maxChannels; ++ch)
+	{
+		hopSumSquares[ch] = 0.0f;
+		hopPeak[ch] = 0.0f;
+	}
+
+	frame.momentaryLoudness = loudnessMeter.getMomentaryLoudness();
+	frame.shortTermLoudness = loudnessMeter.getShortTermLoudness();
+
+	bandMeter.finishHop();
+	frame.numBands = bandMeter.getNumBands();
+	FloatVectorOperations::copy(frame.bandLevel, bandMeter.getLevels(), frame.numBands);
+	FloatVectorOperations::copy(frame.bandEnvelope, bandMeter.getEnvelopes(), frame.numBands);
+	FloatVectorOperations::copy(frame.bandPeak, bandMeter.getPeaks(), frame.numBands);
+
+	// Unwrap the history so the oldest sample comes first.
+	auto tail = AnalysisFrame::fftSize - historyPos;
+	FloatVectorOperations::copy(fftData.get(), history.get() + historyPos, tail);
+	FloatVectorOperations::copy(fftData.get() + tail, history.get(), historyPos);
+
+	window.multiplyWithWindowingTable(fftData.get(), (size_t)AnalysisFrame::fftSize);
+	fft.performFrequencyOnlyForwardTransform(fftData.get());
+
+	// A Hann window sums to fftSize / 2, and a real sine splits its energy
+	// between the positive and negative bins.
+	FloatVectorOperations::copyWithMultiply(frame.spectrum, fftData.get(), 4.0f / (float)AnalysisFrame::fftSize, AnalysisFrame::numBins);
+
+	frame.spectralBandMode = spectralBandMode;
+	filterbank.process(spectralBandMode, frame.spectrum, frame.spectralBands);
+
+	// Harmony comes out of the same spectrum for a few hundred multiply-adds more.
+	chromaExtractor.process(frame.spectrum, frame.chroma);
+	auto key = ChromaExtractor::estimateKey(chromaExtractor.getSmoothedChroma());
+	frame.key = key.key;
+	frame.keyConfidence = key.confidence;
+	frame.harmonicHue = ChromaExtractor::getChromaHue(chromaExtractor.getSmoothedChroma());
+
+	beatTracker.process(frame);
+}
@@ -0,0 +1,133 @@
+/*
+  ==============================================================================
+
+    FeatureExtractor.h
+    Created: 17 Oct 2026 10:21:50am
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "BeatTracker.h"
+#include "BandMeter.h"
+#include "ChromaExtractor.h"
+#include "LoudnessMeter.h"
+#include "SpectralFilterbank.h"
+#include <functional>
+
+//==============================================================================
+/** One hop's worth of analysis results, as handed to the renderer. */
+struct AnalysisFrame
+{
+	enum
+	{
+		fftOrder = 11,
+		fftSize = 1 << fftOrder,
+		numBins = fftSize / 2,
+		maxChannels = 2,
+		maxBands = BandMeter::maxBands,
+		numSpectralBands = SpectralFilterbank::numBands,
+		numPitchClasses = ChromaExtractor::numPitchClasses
+	};
+
+	// Number of samples analysed up to and including this frame.
+	int64 samplePosition = 0;
+	double sampleRate = 44100.0;
+
+	float rms[maxChannels] = {};
+	float peak[maxChannels] = {};
+
+	// K-weighted loudness in LUFS, see LoudnessMeter. Updated every 100 ms.
+	float momentaryLoudness = LoudnessMeter::silence;	// Last 400 ms
+	float shortTermLoudness = LoudnessMeter::silence;	// Last 3 s
+
+	// Linear magnitude spectrum, scaled so a full-scale sine reads ~1.0.
+	float spectrum[numBins] = {};
+
+	// The spectrum folded into log-frequency bands, low to high, same units. See SpectralFilterbank.
+	SpectralFilterbank::Mode spectralBandMode = SpectralFilterbank::mel;
+	float spectralBands[numSpectralBands] = {};
+
+	// Band meters on the mono mix, low to high, see BandMeter. Same scaling as the spectrum.
+	int numBands = 0;
+	float bandLevel[maxBands] = {};		// RMS over the hop
+	float bandEnvelope[maxBands] = {};	// Smoothed for visuals
+	float bandPeak[maxBands] = {};		// Held peaks
+
+	// Harmony, see ChromaExtractor. The key and hue follow the last few seconds, not just this frame.
+	float chroma[numPitchClasses] = {};	// C to B, strongest 1.0
+	int key = -1;						// 0..11 major, 12..23 minor, -1 if unknown
+	float keyConfidence = 0.0f;			// 0..1
+	float harmonicHue = -1.0f;			// Degrees, -1 if there's no pitched content
+
+	// Beat tracking, see BeatTracker.
+	float onsetFunction = 0.0f;		// Raw onset detection function, unscaled
+	float onsetStrength = 0.0f;		// 0..1
+	bool onset = false;
+	float tempo = 120.0f;			// BPM
+	float tempoConfidence = 0.0f;	// 0..1
+	double beatPosition = 0.0;		// Beats since the tracker started; the fractional part is the beat phase.
+};
+
+//==============================================================================
+/**
+	The synchronous part of the analysis pipeline. Feed it audio in any block
+	size and it produces one AnalysisFrame every hopSize samples.
+
+	This has no threads or queues of its own, so the same code runs behind the
+	live analysis thread and in offline jobs.
+*/
+class FeatureExtractor
+{
+public:
+	enum { hopSize = 512, defaultNumBands = 16 };
+
+	using FrameCallback = std::function<void(const AnalysisFrame&)>;
+
+	FeatureExtractor();
+
+	void prepare(double sampleRate, int numChannels, int numBands = defaultNumBands);
+	void reset();
+
+	/** Consumes numSamples from the start of buffer, calling onFrame for every completed hop. */
+	void process(const AudioBuffer<float>& buffer, int numSamples, const FrameCallback& onFrame);
+
+	double getSampleRate() const noexcept { return sampleRate; }
+
+	/** Which band layout fills AnalysisFrame::spectralBands from the next frame on.
+		Both are precomputed, so switching is free. Same thread as process(). */
+	void setSpectralBandMode(SpectralFilterbank::Mode mode) noexcept { spectralBandMode = mode; }
+
+private:
+	void analyseFrame();
+
+	dsp::FFT fft{ AnalysisFrame::fftOrder };
+	dsp::WindowingFunction<float> window{ (size_t)AnalysisFrame::fftSize, dsp::WindowingFunction<float>::hann, false };
+
+	// Mono mixdown of the last fftSize samples, written circularly.
+	HeapBlock<float> history;
+	HeapBlock<float> fftData;
+	int historyPos = 0;
+	int samplesUntilHop = hopSize;
+
+	float hopSumSquares[AnalysisFrame::maxChannels] = {};
+	float hopPeak[AnalysisFrame::maxChannels] = {};
+
+	AnalysisFrame frame;
+	BeatTracker beatTracker;
+	BandMeter bandMeter;
+	LoudnessMeter loudnessMeter;
+	SpectralFilterbank filterbank;
+	ChromaExtractor chromaExtractor;
+	SpectralFilterbank::Mode spectralBandMode = SpectralFilterbank::mel;
+	const MeterKernels& kernels = MeterKernels::get();
+
+	double sampleRate = 44100.0;
+	int numChannels = 2;
+	int64 samplesProcessed = 0;
+
+	JUCE_DECLARE_NON_COPYABLE(FeatureExtractor)
+};
@@ -0,0 +1,284 @@
+/*
+  ==============================================================================
+
+    FeatureRing.cpp
+    Created: 18 Oct 2026 4:12:08am
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#include "FeatureRing.h"
+#include <type_traits>
+
+struct FeatureRing::Header
+{
+	char magic[8];
+	uint32 layoutVersion;
+	uint32 frameSize;					// Catches a Frame layout change that forgot to bump the version
+	uint32 numSlots;
+	std::atomic<uint32> writerId;		// Whoever's publishing, 0 for nobody
+	std::atomic<uint64> writeCount;		// Frames published so far
+};
+
+struct FeatureRing::Slot
+{
+	std::atomic<uint64> sequence;		// 2n + 1 while frame n is being written, 2n + 2 once it's done
+	Frame frame;
+};
+
+namespace
+{
+	const char ringMagic[8] = { 'G', 'R', 'O', 'O', 'V', 'F', 'E', 'D' };
+
+	enum { slotAlignment = 64 };
+
+	// A writer that's gone this long without publishing has crashed or been bypassed.
+	const double staleSeconds = 1.0;
+
+	size_t getSlotsOffset(size_t headerSize)
+	{
+		return (headerSize + slotAlignment - 1) & ~(size_t)(slotAlignment - 1);
+	}
+}
+
+static_assert(std::is_trivially_copyable<FeatureRing::Frame>::value, "Frames are shared as raw bytes");
+static_assert(sizeof(std::atomic<uint64>) == sizeof(uint64), "The ring's counters have to be plain lock-free words");
+
+//==============================================================================
+File FeatureRing::getDefaultFile()
+{
+	return File::getSpecialLocation(File::userApplicationDataDirectory)
+		.getChildFile("Groov")
+		.getChildFile("Plugin feed.ring");
+}
+
+//==============================================================================
+FeatureRing::Writer::Writer()
+	: writerId((uint32)Random::getSystemRandom().nextInt() | 1)
+{
+}
+
+FeatureRing::Writer::~Writer()
+{
+	close();
+}
+
+Result FeatureRing::Writer::open(const File& ringFile)
+{
+	close();
+
+	auto slotsOffset = getSlotsOffset(sizeof(Header));
+	auto ringSize = slotsOffset + sizeof(Slot) * numSlots;
+
+	auto mapRing = [&]
+	{
+		mapped.reset(new MemoryMappedFile(ringFile, MemoryMappedFile::readWrite));
+
+		if (mapped->getData() == nullptr || mapped->getSize() != ringSize)
+		{
+			mapped.reset();
+			return false;
+		}
+
+		header = static_cast<Header*>(mapped->getData());
+		slots = reinterpret_cast<Slot*>(static_cast<char*>(mapped->getData()) + slotsOffset);
+		return true;
+	};
+
+	auto hasThisLayout = [this]
+	{
+		return std::memcmp(header->magic, ringMagic, sizeof(ringMagic)) == 0
+			&& header->layoutVersion == layoutVersion
+			&& header->frameSize == sizeof(Frame)
+			&& header->numSlots == numSlots;
+	};
+
+	if (!ringFile.existsAsFile() || (uint64)ringFile.getSize() != ringSize || !mapRing() || !hasThisLayout())
+	{
+		mapped.reset();
+
+		// Zeroed next to the real file and swapped in, so a reader still mapping an
+		// old one keeps its own copy rather than having it cut short underneath it.
+		ringFile.getParentDirectory().createDirectory();
+		auto tempFile = ringFile.getSiblingFile(ringFile.getFileName() + ".tmp");
+
+		{
+			FileOutputStream out(tempFile);
+
+			if (!out.openedOk())
+				return Result::fail("Couldn't write " + tempFile.getFullPathName());
+
+			out.setPosition(0);
+			out.truncate();
+
+			if (!out.writeRepeatedByte(0, ringSize))
+			{
+				tempFile.deleteFile();
+				return Result::fail("Couldn't write " + tempFile.getFullPathName());
+			}
+		}
+
+		if (!tempFile.moveFileTo(ringFile))
+		{
+			tempFile.deleteFile();
+			return Result::fail("Couldn't replace " + ringFile.getFullPathName() + ", is another Groov using it?");
+		}
+
+		if (!mapRing())
+			return Result::fail("Couldn't map " + ringFile.getFullPathName());
+
+		std::memcpy(header->magic, ringMagic, sizeof(ringMagic));
+		header->layoutVersion = layoutVersion;
+		header->frameSize = sizeof(Frame);
+		header->numSlots = numSlots;
+	}
+
+	// Another writer that's still publishing keeps the ring; one that's gone quiet loses it.
+	writeCount = header->writeCount.load();
+	auto currentWriter = header->writerId.load();
+
+	if (currentWriter != 0 && writeCount > 0)
+	{
+		auto& newest = slots[(writeCount - 1) % numSlots].frame;
+
+		if (Time::getMillisecondCounterHiRes() * 0.001 - newest.blockTime < staleSeconds)
+		{
+			mapped.reset();
+			header = nullptr;
+			slots = nullptr;
+			return Result::fail("Another Groov plugin is already feeding " + ringFile.getFullPathName());
+		}
+	}
+
+	// Only from the writer we saw, so of two opening at once just one gets it.
+	if (!header->writerId.compare_exchange_strong(currentWriter, writerId))
+	{
+		mapped.reset();
+		header = nullptr;
+		slots = nullptr;
+		return Result::fail("Another Groov plugin is already feeding " + ringFile.getFullPathName());
+	}
+
+	return Result::ok();
+}
+
+void FeatureRing::Writer::close()
+{
+	if (header != nullptr)
+	{
+		auto expected = writerId;
+		header->writerId.compare_exchange_strong(expected, 0);
+	}
+
+	mapped.reset();
+	header = nullptr;
+	slots = nullptr;
+}
+
+FeatureRing::Frame* FeatureRing::Writer::getWriteBuffer() noexcept
+{
+	jassert(isOpen());
+
+	// Someone else has taken the ring over; their frames aren't ours to write over.
+	if (header->writerId.load(std::memory_order_relaxed) != writerId)
+		return nullptr;
+
+	auto& slot = slots[writeCount % numSlots];
+	slot.sequence.store(2 * writeCount + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	return &slot.frame;
+}
+
+void FeatureRing::Writer::publish() noexcept
+{
+	jassert(isOpen());
+
+	// Taken over since getWriteBuffer(); leave them to it.
+	if (header->writerId.load(std::memory_order_relaxed) != writerId)
+		return;
+
+	auto& slot = slots[writeCount % numSlots];
+	slot.sequence.store(2 * writeCount + 2, std::memory_order_release);
+	header->writeCount.store(++writeCount, std::memory_order_release);
+}
+
+//==============================================================================
+Result FeatureRing::Reader::open(const File& ringFile)
+{
+	close();
+
+	if (!ringFile.existsAsFile())
+		return Result::fail("Nothing is feeding " + ringFile.getFullPathName() + " yet");
+
+	auto slotsOffset = getSlotsOffset(sizeof(Header));
+	auto ringSize = slotsOffset + sizeof(Slot) * numSlots;
+
+	mapped.reset(new MemoryMappedFile(ringFile, MemoryMappedFile::readOnly));
+
+	if (mapped->getData() == nullptr || mapped->getSize() != ringSize)
+	{
+		mapped.reset();
+		return Result::fail(ringFile.getFullPathName() + " was made by a different build of Groov");
+	}
+
+	auto* ringHeader = static_cast<const Header*>(mapped->getData());
+
+	if (std::memcmp(ringHeader->magic, ringMagic, sizeof(ringMagic)) != 0
+		|| ringHeader->layoutVersion != layoutVersion
+		|| ringHeader->frameSize != sizeof(Frame)
+		|| ringHeader->numSlots != numSlots)
+	{
+		mapped.reset();
+		return Result::fail(ringFile.getFullPathName() + " was made by a different build of Groov");
+	}
+
+	header = ringHeader;
+	slots = reinterpret_cast<const Slot*>(static_cast<const char*>(mapped->getData()) + slotsOffset);
+	return Result::ok();
+}
+
+void FeatureRing::Reader::close()
+{
+	mapped.reset();
+	header = nullptr;
+	slots = nullptr;
+	readVersion = 0;
+}
+
+bool FeatureRing::Reader::read(Frame& destination) noexcept
+{
+	if (!isOpen())
+		return false;
+
+	// A writer publishing every few samples can lap a copy; try again with the
+	// newer frame a couple of times before giving up on this one.
+	for (int attempt = 0; attempt < 3; ++attempt)
+	{
+		auto count = header->writeCount.load(std::memory_order_acquire);
+
+		if (count == 0)
+			return false;
+
+		// Anything but "finished frame count - 1" means the writer's already moved on to this slot again.
+		auto& slot = slots[(count - 1) % numSlots];
+
+		if (slot.sequence.load(std::memory_order_acquire) != 2 * count)
+			continue;
+
+		auto copy = slot.frame;
+
+		// The same number after the copy means nothing was written to it meanwhile.
+		std::atomic_thread_fence(std::memory_order_acquire);
+
+		if (slot.sequence.load(std::memory_order_relaxed) == 2 * count)
+		{
+			destination = copy;
+			readVersion = count;
+			return true;
+		}
+	}
+
+	return false;
+}
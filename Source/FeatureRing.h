@@ -0,0 +1,124 @@
+/*
+  ==============================================================================
+
+    FeatureRing.h
+    Created: 18 Oct 2026 4:12:08am
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "FeatureExtractor.h"
+#include <atomic>
+
+//==============================================================================
+/**
+	Live analysis frames and the host's transport, handed from one process to
+	another on the same machine: GroovProcessor writes them from inside the
+	DJ's host and GroovRenderer reads them in Groov.
+
+	The ring is a memory-mapped file both processes map. One writer appends a
+	frame per audio block; any number of readers copy out the newest. Each slot
+	carries a sequence number that's odd while it's being written, and the
+	reader checks it again after copying, so a copy the writer lapped while it
+	was being taken is thrown away rather than used torn. Nothing waits on
+	anything: a host with tiny blocks only makes the odd read come back empty.
+
+	Only plain data goes in, and the header records its layout, so a build with
+	a different Frame refuses the ring rather than misreading it.
+*/
+class FeatureRing
+{
+public:
+	static constexpr uint32 layoutVersion = 1;
+
+	struct Frame
+	{
+		AnalysisFrame features;			// The newest the writer's analyser had when the block arrived
+
+		// Time::getMillisecondCounterHiRes() when the block arrived, in seconds. It's the
+		// system's monotonic clock, so it means the same in every process.
+		double blockTime = 0.0;
+		double latency = 0.0;			// Seconds from then until the block is heard, as far as the writer knows
+
+		// The host's transport at the start of the block.
+		bool isPlaying = false;
+		double position = 0.0;			// Seconds into the host's timeline
+		double tempo = 0.0;				// BPM, 0 if the host doesn't say
+		double ppqPosition = -1.0;		// Quarter notes into the timeline, -1 if the host doesn't say
+		double ppqLastBarStart = 0.0;	// Quarter notes, where the current bar started
+	};
+
+	// At 32 samples / 48kHz a slot comes round again after ~170ms, plenty for one video frame.
+	enum { numSlots = 256 };
+
+	/** Where the writer and readers meet unless told otherwise: in Groov's app data folder. */
+	static File getDefaultFile();
+
+private:
+	// Laid out in FeatureRing.cpp; only raw bytes and lock-free atomics.
+	struct Header;
+	struct Slot;
+
+public:
+	//==============================================================================
+	class Writer
+	{
+	public:
+		Writer();
+		~Writer();
+
+		/** Maps the ring, creating it if it's missing or from another build, and
+			claims it. Fails if another writer is still publishing to it. Not for
+			the audio thread. */
+		Result open(const File& ringFile);
+		void close();
+		bool isOpen() const noexcept					{ return slots != nullptr; }
+
+		/** Audio thread: the slot to fill before calling publish(), or nullptr
+			if another writer has taken the ring over since open(), in which case
+			skip the block. Only call either while isOpen(). Never blocks or
+			allocates. */
+		Frame* getWriteBuffer() noexcept;
+		void publish() noexcept;
+
+	private:
+		std::unique_ptr<MemoryMappedFile> mapped;
+		Header* header = nullptr;
+		Slot* slots = nullptr;
+		uint32 writerId;
+		uint64 writeCount = 0;
+
+		JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Writer)
+	};
+
+	//==============================================================================
+	class Reader
+	{
+	public:
+		Reader() = default;
+
+		/** Maps an existing ring read-only. */
+		Result open(const File& ringFile);
+		void close();
+		bool isOpen() const noexcept					{ return slots != nullptr; }
+
+		/** Copies the newest finished frame into destination. False, leaving
+			destination alone, if there isn't one or the writer kept overwriting
+			it while it was copied. */
+		bool read(Frame& destination) noexcept;
+		/** How many frames the writer had published when read() last found one; 0 before that. */
+		uint64 getReadVersion() const noexcept			{ return readVersion; }
+
+	private:
+		std::unique_ptr<MemoryMappedFile> mapped;
+		const Header* header = nullptr;
+		const Slot* slots = nullptr;
+		uint64 readVersion = 0;
+
+		JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Reader)
+	};
+};
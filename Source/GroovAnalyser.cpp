@@ -0,0 +1,60 @@
+/*
+  ==============================================================================
+
+    GroovAnalyser.cpp
+    Created: 17 Oct 2026 10:40:18am
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#include "GroovAnalyser.h"
+
+GroovAnalyser::GroovAnalyser() : Thread("Groov Analysis")
+{
+	publishFrame = [this](const AnalysisFrame& frame)
+	{
+		snapshots.getWriteBuffer() = frame;
+		snapshots.publish();
+
+		detectedTempo.store(frame.tempo, std::memory_order_relaxed);
+		tempoConfidence.store(frame.tempoConfidence, std::memory_order_relaxed);
+		shortTermLoudness.store(frame.shortTermLoudness, std::memory_order_relaxed);
+	};
+}
+
+GroovAnalyser::~GroovAnalyser()
+{
+	stopThread(1000);
+}
+
+void GroovAnalyser::prepare(double sampleRate, int maxBlockSize, int numChannels)
+{
+	stopThread(1000);
+
+	numChannels = jlimit(1, (int)AnalysisFrame::maxChannels, numChannels);
+
+	fifo.prepare(numChannels, maxBlockSize, queueSizeInBlocks);
+	extractor.prepare(sampleRate, numChannels);
+	scratch.setSize(numChannels, FeatureExtractor::hopSize);
+
+	// Above the message and GL threads, below the audio callback itself.
+	startThread(8);
+}
+
+void GroovAnalyser::run()
+{
+	while (!threadShouldExit())
+	{
+		if (fifo.getNumReady() == 0)
+		{
+			// Roughly one 64-sample block at 48kHz, so the queue stays shallow.
+			wait(1);
+			continue;
+		}
+
+		auto numRead = fifo.pop(scratch);
+		extractor.setSpectralBandMode(spectralBandMode.load(std::memory_order_relaxed));
+		extractor.process(scratch, numRead, publishFrame);
+	}
+}
@@ -0,0 +1,79 @@
+/*
+  ==============================================================================
+
+    GroovAnalyser.h
+    Created: 17 Oct 2026 10:40:18am
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "AnalysisFifo.h"
+#include "FeatureExtractor.h"
+#include "SnapshotBuffer.h"
+
+//==============================================================================
+/**
+	Live analysis of whatever the audio callback is playing.
+
+	The audio thread hands every block to pushBlock(), which only copies it into
+	a lock-free queue. A dedicated worker thread drains the queue through a
+	FeatureExtractor and publishes each frame as a versioned snapshot that the
+	renderer picks up with getLatestFrame().
+*/
+class GroovAnalyser : private Thread
+{
+public:
+	GroovAnalyser();
+	~GroovAnalyser();
+
+	/** Sizes the queue for the device and (re)starts the worker. Not for the audio thread. */
+	void prepare(double sampleRate, int maxBlockSize, int numChannels);
+
+	/** Audio thread only. Never blocks or allocates. */
+	void pushBlock(const AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept
+	{
+		fifo.push(buffer, startSample, numSamples);
+	}
+
+	/** Render thread only: the newest published frame. */
+	const AnalysisFrame& getLatestFrame() noexcept	{ return snapshots.read(); }
+	uint64 getLatestVersion() const noexcept		{ return snapshots.getReadVersion(); }
+
+	/** Blocks that arrived while the queue was full. Safe from any thread. */
+	uint32 getNumDroppedBlocks() const noexcept		{ return fifo.getNumDroppedBlocks(); }
+	uint32 getNumPushedBlocks() const noexcept		{ return fifo.getNumPushedBlocks(); }
+	int getQueueCapacity() const noexcept			{ return fifo.getCapacity(); }
+
+	/** Latest tracked tempo, for display. Safe from any thread. */
+	float getDetectedTempo() const noexcept			{ return detectedTempo.load(std::memory_order_relaxed); }
+	float getTempoConfidence() const noexcept		{ return tempoConfidence.load(std::memory_order_relaxed); }
+	/** Latest short-term (3 s) loudness in LUFS, for display. Safe from any thread. */
+	float getShortTermLoudness() const noexcept		{ return shortTermLoudness.load(std::memory_order_relaxed); }
+
+	/** Band layout for AnalysisFrame::spectralBands. Safe from any thread; the worker picks it up before its next block. */
+	void setSpectralBandMode(SpectralFilterbank::Mode mode) noexcept	{ spectralBandMode = mode; }
+	SpectralFilterbank::Mode getSpectralBandMode() const noexcept		{ return spectralBandMode.load(); }
+
+	// How many device blocks the queue can hold before it starts dropping.
+	// At 64 samples / 48kHz, 64 blocks is ~85ms of slack for the worker.
+	int queueSizeInBlocks = 64;
+
+private:
+	void run() override;
+
+	AnalysisFifo fifo;
+	FeatureExtractor extractor;
+	SnapshotBuffer<AnalysisFrame> snapshots;
+
+	AudioBuffer<float> scratch;
+	FeatureExtractor::FrameCallback publishFrame;
+
+	std::atomic<float> detectedTempo{ 0.0f }, tempoConfidence{ 0.0f }, shortTermLoudness{ LoudnessMeter::silence };
+	std::atomic<SpectralFilterbank::Mode> spectralBandMode{ SpectralFilterbank::mel };
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GroovAnalyser)
+};
@@ -10,90 +10,459 @@
 
 #include "GroovAudioApp.h"
 #include "GroovPlayer.h"
+#include "MeterKernels.h"
 
-GroovAudioApp::GroovAudioApp(GroovPlayer& p) : player(p), state(Stopped)
+namespace
 {
+	double getReadAheadSeconds(GroovAudioApp::ReadAheadMode mode)
+	{
+		switch (mode)
+		{
+		case GroovAudioApp::LocalDiskReadAhead:
+			return 2.0;
+		case GroovAudioApp::SlowMediaReadAhead:
+			// USB sticks and network shares stall for hundreds of milliseconds at a time.
+			return 15.0;
+		default:
+			return 0.0;
+		}
+	}
+}
+
+GroovAudioApp::GroovAudioApp(GroovPlayer& p) : player(p)
+{
+	// The decks have to exist before the device starts calling back.
+	for (int i = 0; i < numDecks; ++i)
+	{
+		auto* deck = decks.add(new Deck(String("Deck ") + (char)('A' + i), decodedAudio, readAheadThread, analysisPool, waveformPool));
+		deck->setReadAheadSeconds(getReadAheadSeconds(readAheadMode));
+		deckGains[i] = 1.0f;
+	}
+
 	setAudioChannels(0, 2);
 	formatManager.registerBasicFormats();
-	transport.addChangeListener(this);
+
+	PropertiesFile::Options options;
+	options.applicationName = "Groov";
+	options.folderName = "Groov";
+	options.filenameSuffix = ".settings";
+	options.osxLibrarySubFolder = "Application Support";
+	settings.reset(new PropertiesFile(options));
+
+	decodedAudio.setMemoryBudget((int64)settings->getIntValue("decodeCacheMegabytes", 512) * 1024 * 1024);
+	decodedAudio.setSampleFormat(settings->getBoolValue("decodeCacheInt16", false) ? DecodedTrack::int16Samples : DecodedTrack::floatSamples);
+
+	// The input may have gone since last time; then it's just left closed.
+	midiSync.setMode((MidiClockSync::Mode)jlimit((int)MidiClockSync::off, (int)MidiClockSync::timecode, settings->getIntValue("midiSyncMode")));
+	midiSync.setInput(settings->getValue("midiSyncInput"));
+
+	// Above the message thread, below the analysis thread: decoding has a
+	// buffer's worth of slack, the analysis only a few blocks.
+	readAheadThread.startThread(6);
+
+	startTimer(100);
 }
 
 GroovAudioApp::~GroovAudioApp()
 {
+	stopTimer();
+	profiledXruns = getNumXruns();
+	writeCallbackReport();
 	shutdownAudio();
 }
 
 void GroovAudioApp::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
 {
-	transport.prepareToPlay(samplesPerBlockExpected, sampleRate);
+	auto numAnalysedChannels = 2;
+
+	// Drivers disagree on whether this includes the block being filled; the user's A/V trim covers the difference.
+	if (auto* device = deviceManager.getCurrentAudioDevice())
+	{
+		outputLatency = device->getOutputLatencyInSamples() / sampleRate;
+		inputLatency = device->getInputLatencyInSamples() / sampleRate;
+
+		// A mono line in shouldn't be mixed down with the silent channel next to it.
+		if (inputMode == LineIn)
+			numAnalysedChannels = jmax(1, device->getActiveInputChannels().countNumberOfSetBits());
+	}
+
+	for (int i = 0; i < numDecks; ++i)
+	{
+		decks[i]->prepareToPlay(samplesPerBlockExpected, sampleRate, i == 0 ? numAnalysedChannels : 2);
+		mixGains[i] = 0.0f;
+	}
+
+	mixBlockSize = jmax(1, samplesPerBlockExpected);
+	deviceSampleRate = sampleRate;
+
+	// Each buffer size tried gets its own report, before the profiler starts afresh.
+	writeCallbackReport();
+	profiledSetup.clear();
+	profiledXruns = -1;
+
+	if (auto* device = deviceManager.getCurrentAudioDevice())
+		profiledSetup << device->getTypeName() << " / " << device->getName() << ", "
+					  << String(samplesPerBlockExpected) << " samples at " << String(sampleRate) << " Hz";
+
+	callbackProfiler.prepare(sampleRate, samplesPerBlockExpected);
 }
 
 void GroovAudioApp::getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill)
 {
+	CallbackProfiler::ScopedCallback timing(callbackProfiler, bufferToFill.numSamples);
+
+	auto& playback = playbackStates.getWriteBuffer();
+	playback.blockTime = Time::getMillisecondCounterHiRes() * 0.001;
+
+	// Counted in samples rather than timed, so it runs exactly as fast as the audio.
+	playback.deviceTime = deviceTime;
+	deviceTime += bufferToFill.numSamples / deviceSampleRate;
+
+	if (inputMode.load(std::memory_order_relaxed) == LineIn)
+	{
+		// No track: the renderer follows the live tracker, which lags the room by the input latency.
+		playback.leadDeck = 0;
+		playback.deckWeights[0] = 1.0f;
+		playback.deckWeights[1] = 0.0f;
+		playback.deckTrackIds[0] = playback.deckTrackIds[1] = 0;
+		playback.deckPositions[0] = playback.deckPositions[1] = 0.0;
+		playback.deckLoops[0] = playback.deckLoops[1] = {};
+		playback.deckInLoops[0] = playback.deckInLoops[1] = false;
+		playback.trackId = 0;
+		playback.position = 0.0;
+		playback.isPlaying = true;
+		playback.outputLatency = avTrim.load(std::memory_order_relaxed) - inputLatency.load(std::memory_order_relaxed);
+		playbackStates.publish();
+
+		// The device has already put the input in the buffer, so analyse it where it is.
+		decks[0]->getAnalyser().pushBlock(*bufferToFill.buffer, bufferToFill.startSample, bufferToFill.numSamples);
+
+		if (!monitorLineIn.load(std::memory_order_relaxed))
+			bufferToFill.clearActiveBufferRegion();
+
+		return;
+	}
+
 	bufferToFill.clearActiveBufferRegion();
-	transport.getNextAudioBlock(bufferToFill);
-}
 
-void GroovAudioApp::releaseResources()
-{
+	// Each deck's fader times its side of the crossfader. Equal power: cos/sin
+	// keep the level steady as the crossfader goes through the middle.
+	auto crossfaderAngle = MathConstants<float>::halfPi * crossfader.load(std::memory_order_relaxed);
+	float targetGains[numDecks] = {
+		deckGains[0].load(std::memory_order_relaxed) * std::cos(crossfaderAngle),
+		deckGains[1].load(std::memory_order_relaxed) * std::sin(crossfaderAngle)
+	};
 
-}
+	// Which track this block starts in and where, so the renderer can look it up
+	// in the right beat grid even across a playlist boundary.
+	updatePlaybackState(playback, targetGains);
+	playback.outputLatency = outputLatency.load(std::memory_order_relaxed) + avTrim.load(std::memory_order_relaxed);
+	playbackStates.publish();
 
-void GroovAudioApp::changeListenerCallback(ChangeBroadcaster *source)
-{
-	if (source == &transport)
+	// Normally one pass; a device handing over more than it promised gets several.
+	auto& buffer = *bufferToFill.buffer;
+	auto& kernels = MeterKernels::get();
+
+	for (int done = 0; done < bufferToFill.numSamples;)
 	{
-		if (transport.isPlaying())
+		auto numSamples = jmin(bufferToFill.numSamples - done, mixBlockSize);
+		auto startFraction = (float)done / (float)bufferToFill.numSamples;
+		auto endFraction = (float)(done + numSamples) / (float)bufferToFill.numSamples;
+
+		for (int i = 0; i < numDecks; ++i)
 		{
-			transportStateChanged(Playing);
+			// Each deck hands its own, pre-fader copy to its analysis thread.
+			if (!decks[i]->renderNextBlock(numSamples))
+				continue;
+
+			// Ramp over the whole callback from last block's gain, so fader moves don't zip.
+			auto startGain = jmap(startFraction, mixGains[i], targetGains[i]);
+			auto endGain = jmap(endFraction, mixGains[i], targetGains[i]);
+			auto& deckOutput = decks[i]->getOutput();
+
+			for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+				kernels.addWithGainRamp(buffer.getWritePointer(ch, bufferToFill.startSample + done),
+					deckOutput.getReadPointer(jmin(ch, deckOutput.getNumChannels() - 1)), numSamples, startGain, endGain);
 		}
-		else
+
+		done += numSamples;
+	}
+
+	for (int i = 0; i < numDecks; ++i)
+		mixGains[i] = targetGains[i];
+}
+
+void GroovAudioApp::updatePlaybackState(PlaybackState& playback, const float* targetGains) const noexcept
+{
+	auto totalWeight = 0.0f, loudest = 0.0f;
+	playback.leadDeck = selectedDeck;
+	playback.isPlaying = false;
+
+	for (int i = 0; i < numDecks; ++i)
+	{
+		// A stopped deck is silent whatever its faders say.
+		auto weight = decks[i]->isPlaying() ? targetGains[i] : 0.0f;
+
+		if (weight > loudest)
 		{
-			transportStateChanged(Stopped);
+			loudest = weight;
+			playback.leadDeck = i;
 		}
+
+		playback.deckWeights[i] = weight;
+		playback.deckTrackIds[i] = decks[i]->getCurrentTrackId();
+		playback.deckPositions[i] = decks[i]->getPosition();
+		playback.deckLoops[i] = decks[i]->getLoop();
+		playback.deckInLoops[i] = decks[i]->isInLoop();
+		playback.isPlaying = playback.isPlaying || decks[i]->isPlaying();
+		totalWeight += weight;
 	}
+
+	for (auto& weight : playback.deckWeights)
+		weight = totalWeight > 0.0f ? weight / totalWeight : 0.0f;
+
+	auto& lead = *decks[playback.leadDeck];
+	playback.trackId = lead.getCurrentTrackId();
+	playback.position = lead.getPosition();
+}
+
+void GroovAudioApp::releaseResources()
+{
+	for (auto* deck : decks)
+		deck->releaseResources();
 }
 
 void GroovAudioApp::transportStateChanged(TransportState newState)
 {
-	if (newState != state)
+	auto& deck = *decks[selectedDeck];
+
+	switch (newState)
 	{
-		state = newState;
-		switch (state)
-		{
-		case Stopped:
-			transport.setPosition(0.0);
-			break;
-		case Playing:
-			player.changeButtonEnabled(GroovPlayer::ButtonName::PlayButton, false);
-			break;
-		case Starting:
-			player.changeButtonEnabled(GroovPlayer::ButtonName::StopButton, true);
-			player.changeButtonEnabled(GroovPlayer::ButtonName::PlayButton, false);
-			transport.start();
-			break;
-		case Stopping:
-			player.changeButtonEnabled(GroovPlayer::ButtonName::StopButton, false);
-			player.changeButtonEnabled(GroovPlayer::ButtonName::PlayButton, true);
-			transport.stop();
-			break;
-		default:
-			break;
-		}
+	case Starting:
+		deck.start();
+		break;
+	case Stopping:
+		deck.stop();
+		break;
+	default:
+		break;
 	}
+
+	updateTransportButtons();
+}
+
+void GroovAudioApp::updateTransportButtons()
+{
+	auto playing = decks[selectedDeck]->isPlaying();
+	player.changeButtonEnabled(GroovPlayer::ButtonName::PlayButton, !playing);
+	player.changeButtonEnabled(GroovPlayer::ButtonName::StopButton, playing);
+}
+
+void GroovAudioApp::setSelectedDeck(int deckIndex)
+{
+	selectedDeck = jlimit(0, numDecks - 1, deckIndex);
+	updateTransportButtons();
+}
+
+bool GroovAudioApp::isPlaying() const
+{
+	for (auto* deck : decks)
+		if (deck->isPlaying())
+			return true;
+
+	return false;
 }
 
 void GroovAudioApp::playFile(File audioFile)
 {
-	AudioFormatReader* reader = formatManager.createReaderFor(audioFile);
+	if (decks[selectedDeck]->loadFile(audioFile))
+		updateTransportButtons();
+}
 
-	if (reader != nullptr)
+Result GroovAudioApp::playStems(const File& folder)
+{
+	if (!StemSet::isStemFolder(folder))
+		return Result::fail("There are no drums, bass, melody or vocal stems in " + folder.getFileName()
+			+ ". Stems are told apart by their file names, and it takes at least two.");
+
+	StringArray leftOutStems;
+
+	if (!decks[selectedDeck]->loadFile(folder, &leftOutStems))
+		return Result::fail("Couldn't read the stems in " + folder.getFileName());
+
+	updateTransportButtons();
+
+	// Loaded all the same, just without them.
+	if (!leftOutStems.isEmpty())
+		return Result::fail("Left out " + leftOutStems.joinIntoString(", ") + ", which didn't match the other stems' sample rate.");
+
+	return Result::ok();
+}
+
+void GroovAudioApp::queueFile(const File& audioFile)
+{
+	decks[selectedDeck]->queueFile(audioFile);
+	updateTransportButtons();
+}
+
+void GroovAudioApp::setCrossfadeLength(double seconds)
+{
+	for (auto* deck : decks)
+		deck->setCrossfadeLength(seconds);
+}
+
+void GroovAudioApp::setSpectralBandMode(SpectralFilterbank::Mode mode)
+{
+	for (auto* deck : decks)
+		deck->getAnalyser().setSpectralBandMode(mode);
+}
+
+void GroovAudioApp::timerCallback()
+{
+	// Stands in for the transport's change messages.
+	for (auto* deck : decks)
+		if (deck->update() && deck == decks[selectedDeck])
+			updateTransportButtons();
+
+	// Read while the device is still the one being profiled.
+	profiledXruns = getNumXruns();
+}
+
+void GroovAudioApp::setReadAheadMode(ReadAheadMode newMode)
+{
+	if (newMode == readAheadMode)
+		return;
+
+	readAheadMode = newMode;
+
+	for (auto* deck : decks)
+		deck->setReadAheadSeconds(getReadAheadSeconds(newMode));
+}
+
+Result GroovAudioApp::setInputMode(InputMode newMode)
+{
+	if (newMode == inputMode)
+		return Result::ok();
+
+	auto oldMode = inputMode.exchange(newMode);
+
+	if (newMode == LineIn)
 	{
-		std::unique_ptr<AudioFormatReaderSource> tempSource(new AudioFormatReaderSource(reader, true));
+		for (auto* deck : decks)
+			deck->stop();
+
+		updateTransportButtons();
+	}
+
+	AudioDeviceManager::AudioDeviceSetup oldSetup;
+	deviceManager.getAudioDeviceSetup(oldSetup);
+
+	auto setup = oldSetup;
+	setup.useDefaultInputChannels = false;
+	setup.inputChannels.clear();
+
+	if (newMode == LineIn)
+		setup.inputChannels.setRange(0, 2, true);
+
+	auto error = deviceManager.setAudioDeviceSetup(setup, true);
+
+	if (error.isEmpty())
+		return Result::ok();
+
+	// Get the outputs going again the way they were.
+	inputMode = oldMode;
+	deviceManager.setAudioDeviceSetup(oldSetup, true);
+	return Result::fail(error);
+}
 
-		transport.setSource(tempSource.get(),0,nullptr,reader->sampleRate);
-		transportStateChanged(Stopping);
+int GroovAudioApp::setBufferSize(int numSamples)
+{
+	AudioDeviceManager::AudioDeviceSetup setup;
+	deviceManager.getAudioDeviceSetup(setup);
 
-		playSource.reset(tempSource.release());
+	if (setup.bufferSize != numSamples)
+	{
+		setup.bufferSize = numSamples;
+		deviceManager.setAudioDeviceSetup(setup, true);
 	}
-}
\ No newline at end of file
+
+	return getBufferSize();
+}
+
+int GroovAudioApp::getNumXruns() const
+{
+	auto* device = deviceManager.getCurrentAudioDevice();
+	return device != nullptr ? device->getXRunCount() : -1;
+}
+
+void GroovAudioApp::writeCallbackReport()
+{
+	auto stats = callbackProfiler.getStats();
+
+	if (profiledSetup.isEmpty() || stats.numCallbacks == 0)
+		return;
+
+	auto xruns = profiledXruns;
+
+	String report;
+	report << Time::getCurrentTime().toString(true, true) << ": " << profiledSetup << newLine
+		   << stats.getSummary() << ", " << (xruns < 0 ? String("xruns not reported") : String(xruns) + " xruns")
+		   << " over " << String(stats.numCallbacks) << " callbacks" << newLine
+		   << callbackProfiler.getHistogramText() << newLine;
+
+	DBG(report);
+
+	// Appended, so one file covers every rig and buffer size tried.
+	auto logFile = File::getSpecialLocation(File::userApplicationDataDirectory).getChildFile("Groov").getChildFile("Callback timing.log");
+	logFile.getParentDirectory().createDirectory();
+	logFile.appendText(report);
+}
+
+void GroovAudioApp::setDecodeCacheBudget(int megabytes)
+{
+	decodedAudio.setMemoryBudget((int64)megabytes * 1024 * 1024);
+	settings->setValue("decodeCacheMegabytes", megabytes);
+}
+
+void GroovAudioApp::setDecodeCacheFormat(DecodedTrack::SampleFormat newFormat)
+{
+	decodedAudio.setSampleFormat(newFormat);
+	settings->setValue("decodeCacheInt16", newFormat == DecodedTrack::int16Samples);
+}
+
+void GroovAudioApp::setMidiSyncMode(MidiClockSync::Mode newMode)
+{
+	midiSync.setMode(newMode);
+	settings->setValue("midiSyncMode", (int)newMode);
+}
+
+Result GroovAudioApp::setMidiSyncInput(const String& name)
+{
+	auto result = midiSync.setInput(name);
+	settings->setValue("midiSyncInput", midiSync.getInputName());
+	return result;
+}
+
+int GroovAudioApp::getBufferSize() const
+{
+	auto* device = deviceManager.getCurrentAudioDevice();
+	return device != nullptr ? device->getCurrentBufferSizeSamples() : 0;
+}
+
+std::shared_ptr<const TrackAnalysis> GroovAudioApp::getTrackAnalysis(int trackId) const
+{
+	for (auto* deck : decks)
+		if (auto analysis = deck->getTrackAnalysis(trackId))
+			return analysis;
+
+	return nullptr;
+}
+
+std::shared_ptr<const TrackAnalysis> GroovAudioApp::getStemAnalysis(int trackId, StemSet::Stem stem) const
+{
+	for (auto* deck : decks)
+		if (auto analysis = deck->getStemAnalysis(trackId, stem))
+			return analysis;
+
+	return nullptr;
+}
@@ -10,12 +10,16 @@
 
 #pragma once
 
-#include "../JuceLibraryCode/JuceHeader.h"
+#include <JuceHeader.h>
+#include "CallbackProfiler.h"
+#include "Deck.h"
+#include "MidiClockSync.h"
+#include "SnapshotBuffer.h"
 
 class GroovPlayer;
 
 class GroovAudioApp : public AudioAppComponent,
-					  public ChangeListener
+					  private Timer
 {
 public:
 	GroovAudioApp(GroovPlayer& p);
@@ -25,7 +29,21 @@ public:
 	void getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill) override;
 	void releaseResources() override;
 
-	void changeListenerCallback(ChangeBroadcaster *source) override;
+	enum { numDecks = 2 };
+
+	// Which deck the player's transport, file and waveform controls act on.
+	void setSelectedDeck(int deckIndex);
+	int getSelectedDeck() const { return selectedDeck; }
+	Deck& getDeck(int deckIndex) { return *decks[deckIndex]; }
+	// True while either deck is playing.
+	bool isPlaying() const;
+
+	// Crossfader from 0 (deck A only) to 1 (deck B only), equal power in between. Safe from any thread.
+	void setCrossfader(float position) noexcept { crossfader = jlimit(0.0f, 1.0f, position); }
+	float getCrossfader() const noexcept { return crossfader.load(); }
+	// Each deck's gain ahead of the crossfader, linear. Safe from any thread.
+	void setDeckGain(int deckIndex, float gain) noexcept { deckGains[deckIndex] = jmax(0.0f, gain); }
+	float getDeckGain(int deckIndex) const noexcept { return deckGains[deckIndex].load(); }
 
 	enum TransportState
 	{
@@ -35,15 +53,221 @@ public:
 		Stopping
 	};
 
+	// Starts or stops the selected deck.
 	void transportStateChanged(TransportState newState);
 
+	// Loads a file onto the selected deck, cued at the start.
 	void playFile(File audioFile);
+
+	// Loads a folder of drums, bass, melody and vocal stems onto the selected deck
+	// the same way. The stems play summed, and each is analysed on its own too. A stem
+	// at another sample rate from the rest is left out: the others still load, and the
+	// result fails naming it.
+	Result playStems(const File& folder);
+
+	// Adds a file to the selected deck's playlist. It's decoded and analysed in the
+	// background once it's next up, and follows the current track without a gap.
+	void queueFile(const File& audioFile);
+	// Files waiting to play after the current one on the selected deck.
+	int getNumQueued() const { return decks[selectedDeck]->getNumQueued(); }
+	// Equal-power crossfade between queued tracks on a deck, 0 for a straight cut.
+	void setCrossfadeLength(double seconds);
+	File getCurrentFile() const { return decks[selectedDeck]->getCurrentFile(); }
+	// Position in the selected deck's current track, in seconds.
+	double getPosition() const { return decks[selectedDeck]->getPosition(); }
+	void setPosition(double seconds) { decks[selectedDeck]->setPosition(seconds); }
+
+	// Beat-quantised loops and hot cues on the selected deck; see Deck.
+	bool setBeatLoop(int numBeats) { return decks[selectedDeck]->setBeatLoop(numBeats); }
+	void setLoopIn() { decks[selectedDeck]->setLoopIn(); }
+	bool setLoopOut() { return decks[selectedDeck]->setLoopOut(); }
+	void exitLoop() { decks[selectedDeck]->exitLoop(); }
+	bool isLooping() const { return decks[selectedDeck]->isLooping(); }
+	void setHotCue(int index) { decks[selectedDeck]->setHotCue(index); }
+	void clearHotCue(int index) { decks[selectedDeck]->clearHotCue(index); }
+	double getHotCue(int index) const { return decks[selectedDeck]->getHotCue(index); }
+	bool jumpToHotCue(int index) { return decks[selectedDeck]->jumpToHotCue(index); }
+
+	// How far ahead of playback the file is decoded. NoReadAhead decodes on the audio thread.
+	enum ReadAheadMode
+	{
+		NoReadAhead,
+		LocalDiskReadAhead,
+		SlowMediaReadAhead
+	};
+
+	void setReadAheadMode(ReadAheadMode newMode);
+	ReadAheadMode getReadAheadMode() const { return readAheadMode; }
+
+	// The selected deck's read-ahead buffer fill, 0..1, or -1 with no read-ahead. Message thread only.
+	float getReadAheadFill() const { return decks[selectedDeck]->getReadAheadFill(); }
+	// Blocks the read-ahead couldn't serve in time since the track was loaded. Message thread only.
+	int getNumUnderruns() const { return decks[selectedDeck]->getNumUnderruns(); }
+
+	// Where the music comes from. LineIn analyses the device's inputs, e.g. a feed
+	// from the DJ's mixer, instead of playing files.
+	enum InputMode
+	{
+		FilePlayback,
+		LineIn
+	};
+
+	// Reopens the device with or without its inputs. On failure the mode stays as it was.
+	Result setInputMode(InputMode newMode);
+	InputMode getInputMode() const { return inputMode.load(); }
+	// Line in only: pass the input through to the outputs as well.
+	void setMonitorLineIn(bool shouldMonitor) { monitorLineIn = shouldMonitor; }
+	bool isMonitoringLineIn() const { return monitorLineIn.load(); }
+
+	// Device buffer size in samples; smaller means the visuals react sooner. The
+	// device picks the nearest size it supports, which is what's returned.
+	int setBufferSize(int numSamples);
+	int getBufferSize() const;
+	// Latency the device reports for its inputs, in seconds. Safe from any thread.
+	double getInputLatency() const noexcept { return inputLatency.load(); }
+
+	// How long getNextAudioBlock takes against each block's budget since the device
+	// last started. Appended to "Callback timing.log" when the device restarts, and on shutdown.
+	CallbackProfiler::Stats getCallbackStats() const { return callbackProfiler.getStats(); }
+	// Xruns the driver itself reports, or -1 if it doesn't. Message thread only.
+	int getNumXruns() const;
+
+	// RAM for decoded tracks shared by playback and analysis, beyond which they're
+	// kept on disk. Saved per machine, like the sample format.
+	void setDecodeCacheBudget(int megabytes);
+	int getDecodeCacheBudget() const { return (int)(decodedAudio.getMemoryBudget() / (1024 * 1024)); }
+	void setDecodeCacheFormat(DecodedTrack::SampleFormat newFormat);
+	DecodedTrack::SampleFormat getDecodeCacheFormat() const { return decodedAudio.getSampleFormat(); }
+	DecodedAudioCache& getDecodedAudio() { return decodedAudio; }
+
+	// Each deck has its own live analysis; line in goes through deck A's.
+	GroovAnalyser& getAnalyser(int deckIndex) { return decks[deckIndex]->getAnalyser(); }
+	void setSpectralBandMode(SpectralFilterbank::Mode mode);
+
+	// Pre-analysis of a track on either deck, or nullptr until it's ready. Safe from any thread.
+	std::shared_ptr<const TrackAnalysis> getTrackAnalysis(int trackId) const;
+	// One stem's pre-analysis, if the track is a stem set. Safe from any thread.
+	std::shared_ptr<const TrackAnalysis> getStemAnalysis(int trackId, StemSet::Stem stem) const;
+	// Pre-analysis of the selected deck's current track. Message thread only.
+	std::shared_ptr<const TrackAnalysis> getTrackAnalysis() const { return getTrackAnalysis(decks[selectedDeck]->getCurrentTrackId()); }
+	// 0..1 while the selected deck's track is being analysed, -1 otherwise. Message thread only.
+	float getAnalysisProgress() const { return decks[selectedDeck]->getAnalysisProgress(); }
+	// Waveform of the selected deck's track, possibly still being built, or nullptr. Message thread only.
+	std::shared_ptr<const WaveformPyramid> getWaveform() const { return decks[selectedDeck]->getWaveform(); }
+
+	struct PlaybackState
+	{
+		int leadDeck = 0;			// The deck the visuals take their beat and key from: the loudest playing
+		float deckWeights[numDecks] = {};	// How much of the mix each deck is, summing to 1 (all 0 in silence)
+		int deckTrackIds[numDecks] = {};	// The track on each deck, 0 for none
+		double deckPositions[numDecks] = {};	// Each deck's place in its track, in seconds
+		Range<double> deckLoops[numDecks];	// Each deck's loop, in seconds, empty for none
+		bool deckInLoops[numDecks] = {};	// Whether each deck's playhead is going round its loop yet
+
+		int trackId = 0;			// Which track the lead deck was playing...
+		double position = 0.0;		// ...and how far into it, in seconds
+		bool isPlaying = false;		// Either deck
+		double blockTime = 0.0;		// Time::getMillisecondCounterHiRes() when the block was asked for, in seconds
+		double outputLatency = 0.0;	// Seconds from then until the block's first sample is heard, trim included.
+									// Negative for line in, where the crowd heard it before we got it.
+		double deviceTime = 0.0;	// Seconds of audio the device had asked for before this block, over every run
+
+		/** How late the block's start is heard relative to wallTime: positive
+			once it's audible. Add to position for the track position heard at
+			wallTime. Stays at 0 while stopped. */
+		double getTimeSinceAudible(double wallTime) const noexcept
+		{
+			// A stalled device shouldn't send the visuals running off on their own.
+			return isPlaying ? jlimit(-1.0, 0.5, wallTime - blockTime - outputLatency) : 0.0;
+		}
+
+		/** The device's own clock at wallTime: deviceTime, run on since the block.
+			Keeps going while the decks are stopped, but not past a stalled device. */
+		double getDeviceTime(double wallTime) const noexcept
+		{
+			return deviceTime + jlimit(0.0, 0.5, wallTime - blockTime);
+		}
+
+		/** A deck's track position heard at wallTime, wrapped round its loop: back
+			to the start if the loop has come round since the block, or on to the
+			end if the block's just wrapped but what's heard hasn't yet. */
+		double getAudiblePosition(int deck, double wallTime) const noexcept
+		{
+			auto position = deckPositions[deck] + getTimeSinceAudible(wallTime);
+			auto loop = deckLoops[deck];
+
+			if (!loop.isEmpty() && deckPositions[deck] < loop.getEnd() && position >= loop.getEnd())
+				position -= loop.getLength();
+			else if (!loop.isEmpty() && deckInLoops[deck] && position < loop.getStart())
+				position += loop.getLength();
+
+			return position;
+		}
+	};
+
+	// Render thread only: where playback and the mix were at the start of the newest block.
+	const PlaybackState& getPlaybackState() noexcept { return playbackStates.read(); }
+
+	// Latency the device reports for its output, in seconds. Safe from any thread.
+	double getOutputLatency() const noexcept { return outputLatency.load(); }
+	// Extra delay added on top of the device's latency, in seconds; positive holds the visuals back.
+	void setAvTrim(double seconds) noexcept { avTrim = seconds; }
+	double getAvTrim() const noexcept { return avTrim.load(); }
+
+	// Saved between runs, for the player's own settings too. Message thread only.
+	PropertiesFile& getSettings() noexcept { return *settings; }
+
+	// MIDI clock or timecode from the DJ's own gear, which the renderer follows
+	// instead of the music while it's locked. Mode and input are saved per machine.
+	MidiClockSync& getMidiSync() noexcept { return midiSync; }
+	void setMidiSyncMode(MidiClockSync::Mode newMode);
+	// On failure the input is left closed.
+	Result setMidiSyncInput(const String& name);
 private:
-	TransportState state;
+	void timerCallback() override;
+
+	void updateTransportButtons();
+	void updatePlaybackState(PlaybackState& playback, const float* targetGains) const noexcept;
+	void writeCallbackReport();
 
 	GroovPlayer& player;
 
 	AudioFormatManager formatManager;
-	std::unique_ptr<AudioFormatReaderSource> playSource;
-	AudioTransportSource transport;
+	DecodedAudioCache decodedAudio{ formatManager };
+	std::unique_ptr<PropertiesFile> settings;
+	MidiClockSync midiSync;
+
+	// Declared before the sources that register with it.
+	TimeSliceThread readAheadThread{ "Groov Read-ahead" };
+	ReadAheadMode readAheadMode = LocalDiskReadAhead;
+
+	OwnedArray<Deck> decks;
+	std::atomic<int> selectedDeck{ 0 };	// Read by the audio thread when neither deck is playing
+
+	std::atomic<float> crossfader{ 0.5f };
+	std::atomic<float> deckGains[numDecks];
+
+	// Audio thread only: the gain each deck went into the mix with last block,
+	// which the next block ramps from.
+	float mixGains[numDecks] = {};
+	int mixBlockSize = 0;
+	double deviceTime = 0.0, deviceSampleRate = 44100.0;
+
+	SnapshotBuffer<PlaybackState> playbackStates;
+	std::atomic<double> outputLatency{ 0.0 }, inputLatency{ 0.0 }, avTrim{ 0.0 };
+
+	std::atomic<InputMode> inputMode{ FilePlayback };
+	std::atomic<bool> monitorLineIn{ false };
+
+	CallbackProfiler callbackProfiler;
+
+	// The setup callbackProfiler has been timing, captured when it started, since by
+	// the time its report is written the device may have changed. Message thread only.
+	String profiledSetup;
+	int profiledXruns = -1;
+
+	// Declared last so their jobs are gone before the decks they write to. The
+	// waveform is summarised with one job per core.
+	ThreadPool waveformPool{ SystemStats::getNumCpus() };
+	ThreadPool analysisPool{ 2 };
 };
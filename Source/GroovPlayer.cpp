@@ -8,18 +8,20 @@
   ==============================================================================
 */
 
-#include "../JuceLibraryCode/JuceHeader.h"
+#include <JuceHeader.h>
 #include "Mesh.h"
 #include "Shaders.h"
 #include "GroovPlayer.h"
 #include "GroovRenderer.h"
 #include "GroovAudioApp.h"
+#include "ModulationEditor.h"
 #include "Utilities.h"
 
 //==============================================================================
 GroovPlayer::GroovPlayer(GroovRenderer& r) : renderer(r)
 {
 	audioApp.reset(new GroovAudioApp (*this));
+	renderer.setAudioApp(audioApp.get());
 
 	// SLIDERS -----------------------
 	addAndMakeVisible(sizeSlider);
@@ -103,11 +105,106 @@ GroovPlayer::GroovPlayer(GroovRenderer& r) : renderer(r)
 	addAndMakeVisible(freeze);
 	freeze.onClick = [this] { freezeBlocks(); };
 
+	// colour by the music's key instead of cycling with the beat; BG Hue becomes an offset
+	addAndMakeVisible(keyColours);
+	keyColours.onClick = [this] { renderer.keyColours = keyColours.getToggleState(); };
+
+	// route the music onto the sliders below; the routes are remembered between runs
+	addAndMakeVisible(modulationButton);
+	modulationButton.setButtonText("Modulation...");
+	modulationButton.onClick = [this] { showModulationEditor(); };
+	renderer.modulation.setRoutes(ModulationMatrix::routesFromString(audioApp->getSettings().getValue("modulationRoutes")));
+
+	// follow the beat tracker; grabbing the BPM slider switches this off and makes it a manual override
+	addAndMakeVisible(autoTempo);
+	autoTempo.onClick = [this] { setAutoTempo(autoTempo.getToggleState()); };
+
+	// DECKS -----------------------
+
+	// the transport, file and waveform controls act on whichever deck is picked here
+	for (auto* button : { &deckAButton, &deckBButton })
+	{
+		addAndMakeVisible(button);
+		button->setRadioGroupId(1);
+	}
+
+	deckAButton.setToggleState(true, dontSendNotification);
+	deckAButton.onClick = [this] { if (deckAButton.getToggleState()) deckSelected(0); };
+	deckBButton.onClick = [this] { if (deckBButton.getToggleState()) deckSelected(1); };
+
+	addAndMakeVisible(crossfaderSlider);
+	crossfaderSlider.setRange(0.0, 1.0, 0.01);
+	crossfaderSlider.setValue(audioApp->getCrossfader(), dontSendNotification);
+	crossfaderSlider.setDoubleClickReturnValue(true, 0.5);
+	crossfaderSlider.textFromValueFunction = [](double value)
+	{
+		return "A " + String(roundToInt((1.0 - value) * 100.0)) + " : B " + String(roundToInt(value * 100.0));
+	};
+	crossfaderSlider.setTextBoxStyle(Slider::TextBoxLeft, true, 100, PARAM_HEIGHT - 5);
+	crossfaderSlider.onValueChange = [this] { audioApp->setCrossfader((float)crossfaderSlider.getValue()); };
+
+	for (auto* gainSlider : { &deckAGainSlider, &deckBGainSlider })
+	{
+		auto deckIndex = gainSlider == &deckAGainSlider ? 0 : 1;
+
+		addAndMakeVisible(gainSlider);
+		gainSlider->setRange(-40.0, 6.0, 0.5);
+		gainSlider->setValue(Decibels::gainToDecibels(audioApp->getDeckGain(deckIndex), -40.0f), dontSendNotification);
+		gainSlider->setDoubleClickReturnValue(true, 0.0);
+		gainSlider->setTextValueSuffix(deckIndex == 0 ? " dB A" : " dB B");
+		gainSlider->setTextBoxStyle(Slider::TextBoxLeft, false, 60, PARAM_HEIGHT - 5);
+		gainSlider->onValueChange = [this, gainSlider, deckIndex]
+		{
+			audioApp->setDeckGain(deckIndex, Decibels::decibelsToGain((float)gainSlider->getValue(), -40.0f));
+		};
+	}
+
 	// FILE LOADING BUTTONS -----------------------
 	addAndMakeVisible(&openButton);
 	openButton.setButtonText("Open File");
 	openButton.onClick = [this] { openButtonClicked(); };
 
+	// a folder of drums/bass/melody/vocal stems, played summed with each stem a modulation source
+	addAndMakeVisible(&stemsButton);
+	stemsButton.setButtonText("Open Stems");
+	stemsButton.onClick = [this] { stemsButtonClicked(); };
+
+	// queued files follow the current one without a gap, crossfaded if the slider says so
+	addAndMakeVisible(&queueButton);
+	queueButton.setButtonText("Queue Files");
+	queueButton.onClick = [this] { queueButtonClicked(); };
+
+	// LOOPS AND CUES -----------------------
+	for (auto* button : { &beatLoopButton, &loopInButton, &loopOutButton, &exitLoopButton })
+		addAndMakeVisible(button);
+
+	beatLoopButton.onClick = [this] { audioApp->setBeatLoop(4); };
+	loopInButton.onClick = [this] { audioApp->setLoopIn(); };
+	loopOutButton.onClick = [this] { audioApp->setLoopOut(); };
+	exitLoopButton.onClick = [this] { audioApp->exitLoop(); };
+
+	// click jumps to a cue, or sets it if it's empty; shift-click moves it, alt-click clears it
+	for (int i = 0; i < Deck::numHotCues; ++i)
+	{
+		auto* cueButton = cueButtons.add(new TextButton());
+		addAndMakeVisible(cueButton);
+		cueButton->onClick = [this, i] { cueButtonClicked(i); };
+	}
+
+	addAndMakeVisible(crossfadeSlider);
+	crossfadeSlider.setRange(0.0, 12.0, 0.5);
+	crossfadeSlider.setTextValueSuffix(" s crossfade");
+	crossfadeSlider.setTextBoxStyle(Slider::TextBoxLeft, false, 100, PARAM_HEIGHT - 5);
+	crossfadeSlider.onValueChange = [this] { audioApp->setCrossfadeLength(crossfadeSlider.getValue()); };
+
+	// Positive holds the visuals back, for outputs that report less latency than they have.
+	addAndMakeVisible(avTrimSlider);
+	avTrimSlider.setRange(-100.0, 100.0, 1.0);
+	avTrimSlider.setValue(audioApp->getAvTrim() * 1000.0, dontSendNotification);
+	avTrimSlider.setTextValueSuffix(" ms A/V trim");
+	avTrimSlider.setTextBoxStyle(Slider::TextBoxLeft, false, 100, PARAM_HEIGHT - 5);
+	avTrimSlider.onValueChange = [this] { audioApp->setAvTrim(avTrimSlider.getValue() * 0.001); };
+
 	addAndMakeVisible(&playButton);
 	playButton.setButtonText("PLAY");
 	playButton.onClick = [this] { playButtonClicked(); };
@@ -120,6 +217,116 @@ GroovPlayer::GroovPlayer(GroovRenderer& r) : renderer(r)
 	stopButton.setColour(TextButton::buttonColourId, Colours::red);
 	stopButton.setEnabled(false);
 
+	// decode ahead of playback on its own thread; the longer buffer rides out slow USB sticks
+	addAndMakeVisible(readAheadBox);
+	readAheadBox.addItem("No read-ahead", GroovAudioApp::NoReadAhead + 1);
+	readAheadBox.addItem("Read-ahead: local disk", GroovAudioApp::LocalDiskReadAhead + 1);
+	readAheadBox.addItem("Read-ahead: USB / network", GroovAudioApp::SlowMediaReadAhead + 1);
+	readAheadBox.setSelectedId(audioApp->getReadAheadMode() + 1, dontSendNotification);
+	readAheadBox.onChange = [this]
+	{
+		audioApp->setReadAheadMode((GroovAudioApp::ReadAheadMode)(readAheadBox.getSelectedId() - 1));
+	};
+
+	// RAM for decoded tracks before they go to disk; set per machine and remembered
+	addAndMakeVisible(decodeCacheBox);
+
+	for (auto megabytes : { 256, 512, 1024, 2048, 4096 })
+		decodeCacheBox.addItem("Decode cache: " + (megabytes < 1024 ? String(megabytes) + " MB" : String(megabytes / 1024) + " GB"), megabytes);
+
+	decodeCacheBox.setSelectedId(audioApp->getDecodeCacheBudget(), dontSendNotification);
+	decodeCacheBox.onChange = [this] { audioApp->setDecodeCacheBudget(decodeCacheBox.getSelectedId()); };
+
+	addAndMakeVisible(decodeCacheInt16);
+	decodeCacheInt16.setToggleState(audioApp->getDecodeCacheFormat() == DecodedTrack::int16Samples, dontSendNotification);
+	decodeCacheInt16.onClick = [this]
+	{
+		audioApp->setDecodeCacheFormat(decodeCacheInt16.getToggleState() ? DecodedTrack::int16Samples : DecodedTrack::floatSamples);
+	};
+
+	// log-frequency layout of the spectral bands the renderer gets
+	addAndMakeVisible(spectralBandBox);
+
+	for (int mode = 0; mode < SpectralFilterbank::numModes; ++mode)
+		spectralBandBox.addItem(String("Bands: ") + SpectralFilterbank::getModeName((SpectralFilterbank::Mode)mode), mode + 1);
+
+	spectralBandBox.setSelectedId(audioApp->getAnalyser(0).getSpectralBandMode() + 1, dontSendNotification);
+	spectralBandBox.onChange = [this]
+	{
+		audioApp->setSpectralBandMode((SpectralFilterbank::Mode)(spectralBandBox.getSelectedId() - 1));
+	};
+
+	// play files, or follow whatever comes in from the DJ's mixer
+	addAndMakeVisible(sourceBox);
+	sourceBox.addItem("Source: files", GroovAudioApp::FilePlayback + 1);
+	sourceBox.addItem("Source: line in", GroovAudioApp::LineIn + 1);
+	sourceBox.addItem("Source: plugin feed", pluginFeedSourceId);
+	sourceBox.setSelectedId(audioApp->getInputMode() + 1, dontSendNotification);
+	sourceBox.onChange = [this] { sourceChanged(); };
+
+	addAndMakeVisible(monitorLineIn);
+	monitorLineIn.onClick = [this] { audioApp->setMonitorLineIn(monitorLineIn.getToggleState()); };
+
+	// lock to the DJ's own gear over MIDI; the virtual input is for a software clock on this machine
+	addAndMakeVisible(syncBox);
+	syncBox.addItem("Sync: audio", MidiClockSync::off + 1);
+	syncBox.addItem("Sync: MIDI clock", MidiClockSync::midiClock + 1);
+	syncBox.addItem("Sync: MIDI timecode", MidiClockSync::timecode + 1);
+	syncBox.setSelectedId(audioApp->getMidiSync().getMode() + 1, dontSendNotification);
+	syncBox.onChange = [this] { audioApp->setMidiSyncMode((MidiClockSync::Mode)(syncBox.getSelectedId() - 1)); };
+
+	addAndMakeVisible(midiInputBox);
+	midiInputBox.setTextWhenNothingSelected("No MIDI input");
+	midiInputBox.addItemList(MidiClockSync::getInputNames(), 1);
+	midiInputBox.setText(audioApp->getMidiSync().getInputName(), dontSendNotification);
+	midiInputBox.onChange = [this]
+	{
+		auto result = audioApp->setMidiSyncInput(midiInputBox.getText());
+
+		if (result.failed())
+		{
+			midiInputBox.setSelectedId(0, dontSendNotification);
+			AlertWindow::showMessageBoxAsync(AlertWindow::WarningIcon, "Couldn't open the MIDI input", result.getErrorMessage());
+		}
+	};
+
+	// smaller buffers get the audio to the analysis sooner
+	addAndMakeVisible(bufferSizeBox);
+
+	for (auto size : { 64, 128, 256, 512, 1024, 2048 })
+		bufferSizeBox.addItem(String(size) + " samples", size);
+
+	bufferSizeBox.setSelectedId(audioApp->getBufferSize(), dontSendNotification);
+	bufferSizeBox.onChange = [this]
+	{
+		auto actualSize = audioApp->setBufferSize(bufferSizeBox.getSelectedId());
+		bufferSizeBox.setSelectedId(actualSize, dontSendNotification);
+	};
+
+	// STATUS -----------------------
+	addAndMakeVisible(analysisStatus);
+	analysisStatus.setFont(Font(12.0f));
+
+	addAndMakeVisible(trackStatus);
+	trackStatus.setFont(Font(12.0f));
+
+	addAndMakeVisible(bufferStatus);
+	bufferStatus.setFont(Font(12.0f));
+
+	addAndMakeVisible(avStatus);
+	avStatus.setFont(Font(12.0f));
+
+	addAndMakeVisible(callbackStatus);
+	callbackStatus.setFont(Font(12.0f));
+
+	addChildComponent(trackAnalysisBar);
+	trackAnalysisBar.setTextToDisplay("Analysing track");
+
+	// click to cue, wheel to zoom
+	addAndMakeVisible(waveformDisplay);
+	waveformDisplay.getPosition = [this] { return audioApp->getPosition(); };
+	waveformDisplay.onSeek = [this](double seconds) { audioApp->setPosition(seconds); };
+
 	lookAndFeelChanged();
 
 	setSize(PLAYER_WIDTH, PLAYER_HEIGHT);
@@ -127,7 +334,7 @@ GroovPlayer::GroovPlayer(GroovRenderer& r) : renderer(r)
 
 GroovPlayer::~GroovPlayer()
 {
-	
+	stopTimer();
 }
 
 void GroovPlayer::initialize()
@@ -147,7 +354,11 @@ void GroovPlayer::initialize()
 	bgSatSlider.setValue(0.75);
 	bgValSlider.setValue(1.0);
 
+	setAutoTempo(true);
+
 	loadShaders();
+
+	startTimer(250);
 }
 
 
@@ -159,17 +370,63 @@ void GroovPlayer::resized()
 
 	auto area = getLocalBounds().reduced(4);
 
-	auto top = area.removeFromTop(PLAYER_HEIGHT - PARAM_HEIGHT);
+	auto top = area.removeFromTop(PLAYER_HEIGHT - PARAM_HEIGHT - WAVEFORM_HEIGHT);
+	waveformDisplay.setBounds(area.removeFromTop(WAVEFORM_HEIGHT));
 
-	auto musicControls = top.removeFromLeft((area.getWidth() / 2) - 90);
-	musicControls = musicControls.removeFromTop(PARAM_HEIGHT * 4);
+	auto leftColumn = top.removeFromLeft((area.getWidth() / 2) - 90);
+	auto musicControls = leftColumn.removeFromTop(PARAM_HEIGHT * 4);
 	stopButton.setBounds(musicControls.removeFromBottom(PARAM_HEIGHT));
 	playButton.setBounds(musicControls.removeFromBottom(PARAM_HEIGHT));
-	openButton.setBounds(musicControls.removeFromBottom(PARAM_HEIGHT * 2));
+	auto openRow = musicControls.removeFromBottom(PARAM_HEIGHT);
+	stemsButton.setBounds(openRow.removeFromRight(openRow.getWidth() / 2));
+	openButton.setBounds(openRow);
+	deckAButton.setBounds(musicControls.removeFromLeft(musicControls.getWidth() / 2));
+	deckBButton.setBounds(musicControls);
+
+	crossfaderSlider.setBounds(leftColumn.removeFromTop(PARAM_HEIGHT));
+
+	auto gainRow = leftColumn.removeFromTop(PARAM_HEIGHT);
+	deckAGainSlider.setBounds(gainRow.removeFromLeft(gainRow.getWidth() / 2));
+	deckBGainSlider.setBounds(gainRow);
+
+	analysisStatus.setBounds(leftColumn.removeFromTop(PARAM_HEIGHT));
+	autoTempo.setBounds(leftColumn.removeFromTop(PARAM_HEIGHT));
+
+	auto trackArea = leftColumn.removeFromTop(PARAM_HEIGHT);
+	trackStatus.setBounds(trackArea);
+	trackAnalysisBar.setBounds(trackArea.reduced(2));
+
+	auto loopRow = leftColumn.removeFromTop(PARAM_HEIGHT);
+	auto loopButtonWidth = loopRow.getWidth() / 4;
+
+	for (auto* button : { &beatLoopButton, &loopInButton, &loopOutButton })
+		button->setBounds(loopRow.removeFromLeft(loopButtonWidth));
+
+	exitLoopButton.setBounds(loopRow);
+
+	auto cueRow = leftColumn.removeFromTop(PARAM_HEIGHT);
+	auto cueButtonWidth = cueRow.getWidth() / Deck::numHotCues;
+
+	for (auto* button : cueButtons)
+		button->setBounds(cueRow.removeFromLeft(cueButtonWidth));
+
+	queueButton.setBounds(leftColumn.removeFromTop(PARAM_HEIGHT));
+	crossfadeSlider.setBounds(leftColumn.removeFromTop(PARAM_HEIGHT));
+	readAheadBox.setBounds(leftColumn.removeFromTop(PARAM_HEIGHT).reduced(2));
+	bufferStatus.setBounds(leftColumn.removeFromTop(PARAM_HEIGHT));
+	avTrimSlider.setBounds(leftColumn.removeFromTop(PARAM_HEIGHT));
+	avStatus.setBounds(leftColumn.removeFromTop(PARAM_HEIGHT));
+	callbackStatus.setBounds(leftColumn.removeFromTop(PARAM_HEIGHT));
+
+	auto cacheRow = leftColumn.removeFromTop(PARAM_HEIGHT);
+	decodeCacheInt16.setBounds(cacheRow.removeFromRight(cacheRow.getWidth() / 3));
+	decodeCacheBox.setBounds(cacheRow.reduced(2));
 
 	auto controls = top.removeFromRight(area.getWidth() / 2);
 	freeze.setBounds(controls.removeFromBottom(PARAM_HEIGHT));
-	enableScaleBounce.setBounds(controls.removeFromBottom(PARAM_HEIGHT));
+	auto toggleRow = controls.removeFromBottom(PARAM_HEIGHT);
+	enableScaleBounce.setBounds(toggleRow.removeFromLeft(toggleRow.getWidth() / 2));
+	keyColours.setBounds(toggleRow);
 	bgSatSlider.setBounds(controls.removeFromBottom(PARAM_HEIGHT));
 	bgValSlider.setBounds(controls.removeFromBottom(PARAM_HEIGHT));
 	bgHueSlider.setBounds(controls.removeFromBottom(PARAM_HEIGHT));
@@ -180,6 +437,17 @@ void GroovPlayer::resized()
 	spinSpeedSlider.setBounds(controls.removeFromBottom(PARAM_HEIGHT));
 	sizeSlider.setBounds(controls.removeFromBottom(PARAM_HEIGHT));
 	bpmSlider.setBounds(controls.removeFromBottom(PARAM_HEIGHT));
+	spectralBandBox.setBounds(controls.removeFromBottom(PARAM_HEIGHT).reduced(2));
+
+	auto inputRow = controls.removeFromBottom(PARAM_HEIGHT);
+	monitorLineIn.setBounds(inputRow.removeFromLeft(inputRow.getWidth() / 2));
+	bufferSizeBox.setBounds(inputRow.reduced(2));
+	sourceBox.setBounds(controls.removeFromBottom(PARAM_HEIGHT).reduced(2));
+	modulationButton.setBounds(controls.removeFromBottom(PARAM_HEIGHT).reduced(2));
+
+	auto syncRow = controls.removeFromBottom(PARAM_HEIGHT);
+	syncBox.setBounds(syncRow.removeFromLeft(syncRow.getWidth() / 2).reduced(2));
+	midiInputBox.setBounds(syncRow.reduced(2));
 
 	top.removeFromRight(70);
 }
@@ -213,16 +481,96 @@ void GroovPlayer::loadShaders()
 
 void GroovPlayer::sliderValueChanged(Slider*)
 {
-	renderer.scale =  (float)sizeSlider.getValue();
-	renderer.rotationSpeed = (float)spinSpeedSlider.getValue();
+	// Base values for the modulation matrix; whatever's routed to them moves them from here.
+	auto& modulation = renderer.modulation;
+	modulation.setBaseValue(ModulationMatrix::zoom, (float)sizeSlider.getValue());
+	modulation.setBaseValue(ModulationMatrix::spinSpeed, (float)spinSpeedSlider.getValue());
+	modulation.setBaseValue(ModulationMatrix::wiggle, (float)wiggleSlider.getValue());
+	modulation.setBaseValue(ModulationMatrix::saturation, (float)colorSatSlider.getValue());
+	modulation.setBaseValue(ModulationMatrix::brightness, (float)colorValSlider.getValue());
+	modulation.setBaseValue(ModulationMatrix::bgHue, (float)bgHueSlider.getValue());
+	modulation.setBaseValue(ModulationMatrix::bgSpeed, (float)bgSpeedSlider.getValue());
+	modulation.setBaseValue(ModulationMatrix::bgSaturation, (float)bgSatSlider.getValue());
+	modulation.setBaseValue(ModulationMatrix::bgBrightness, (float)bgValSlider.getValue());
+
 	renderer.bpm = (int)bpmSlider.getValue();
-	renderer.wiggleSpeed = (float)wiggleSlider.getValue();
-	renderer.colorSat = (float)colorSatSlider.getValue();
-	renderer.colorVal = (float)colorValSlider.getValue();
-	renderer.bgHue = (float)bgHueSlider.getValue();
-	renderer.bgSpeed = (int)bgSpeedSlider.getValue();
-	renderer.bgSat = (float)bgSatSlider.getValue();
-	renderer.bgVal = (float)bgValSlider.getValue();
+}
+
+void GroovPlayer::sliderDragStarted(Slider* slider)
+{
+	if (slider == &bpmSlider && autoTempo.getToggleState())
+		setAutoTempo(false);
+}
+
+void GroovPlayer::timerCallback()
+{
+	auto& analyser = audioApp->getAnalyser(audioApp->getSelectedDeck());
+
+	auto progress = audioApp->getAnalysisProgress();
+	trackAnalysisProgress = progress;
+	trackAnalysisBar.setVisible(progress >= 0.0f);
+
+	String trackText("no track loaded");
+
+	if (auto track = audioApp->getTrackAnalysis())
+		trackText = String(track->tempo, 1) + " BPM, " + ChromaExtractor::getKeyName(track->key) + ", "
+			+ String(track->loudness.integrated, 1) + " LUFS, " + String((int)track->sections.size()) + " sections";
+	else if (audioApp->getCurrentFile() != File())
+		trackText = audioApp->getCurrentFile().getFileNameWithoutExtension();
+
+	if (auto numQueued = audioApp->getNumQueued())
+		trackText << ", " << numQueued << " queued";
+
+	trackStatus.setText(audioApp->getDeck(audioApp->getSelectedDeck()).name + ": " + trackText, dontSendNotification);
+
+	if (renderer.followPluginFeed)
+		trackStatus.setText(renderer.isPluginFeedLive() ? "Plugin feed: live" : "Plugin feed: waiting for the Groov plugin",
+			dontSendNotification);
+
+	exitLoopButton.setEnabled(audioApp->isLooping());
+
+	for (int i = 0; i < Deck::numHotCues; ++i)
+	{
+		auto seconds = audioApp->getHotCue(i);
+		cueButtons[i]->setButtonText(seconds < 0.0 ? "Cue " + String(i + 1)
+			: String((int)seconds / 60) + ":" + String(seconds - 60.0 * ((int)seconds / 60), 1).paddedLeft('0', 4));
+	}
+
+	waveformDisplay.setWaveform(audioApp->getInputMode() == GroovAudioApp::FilePlayback ? audioApp->getWaveform() : nullptr);
+
+	// Show what the tracker is following, so switching to manual starts from there.
+	if (autoTempo.getToggleState() && analyser.getTempoConfidence() > 0.0f)
+		bpmSlider.setValue(analyser.getDetectedTempo(), dontSendNotification);
+
+	// A MIDI clock outranks the tracker in the renderer, so it does here too.
+	if (audioApp->getMidiSync().getMode() == MidiClockSync::midiClock)
+		if (auto clockTempo = audioApp->getMidiSync().getClockTempo())
+			bpmSlider.setValue(clockTempo, dontSendNotification);
+
+	analysisStatus.setText("Analysis: " + String(analyser.getNumDroppedBlocks()) + " of "
+		+ String(analyser.getNumPushedBlocks() + analyser.getNumDroppedBlocks()) + " blocks dropped",
+		dontSendNotification);
+
+	auto fill = audioApp->getReadAheadFill();
+
+	if (audioApp->getInputMode() == GroovAudioApp::LineIn)
+		bufferStatus.setText("Line in: " + String(audioApp->getBufferSize()) + " sample blocks, input latency "
+			+ String(roundToInt(audioApp->getInputLatency() * 1000.0)) + " ms", dontSendNotification);
+	else
+		bufferStatus.setText(fill < 0.0f ? String("Buffer: off")
+			: "Buffer: " + String(roundToInt(fill * 100.0f)) + "% full, " + String(audioApp->getNumUnderruns()) + " underruns",
+			dontSendNotification);
+
+	// What the renderer compensates for: sound leaves this late, pictures this late.
+	auto outputMs = roundToInt((audioApp->getOutputLatency() + audioApp->getAvTrim()) * 1000.0);
+	auto displayMs = roundToInt(renderer.getDisplayLatency() * 1000.0);
+	avStatus.setText("A/V offset: " + String(outputMs - displayMs) + " ms (audio " + String(outputMs)
+		+ " ms, display " + String(displayMs) + " ms)", dontSendNotification);
+
+	// Audio callback load, to size the buffer for this rig: p99 near 100% means glitches.
+	auto xruns = audioApp->getNumXruns();
+	callbackStatus.setText(audioApp->getCallbackStats().getSummary() + (xruns > 0 ? ", " + String(xruns) + " xruns" : String()),
+		dontSendNotification);
 }
 
 void GroovPlayer::lookAndFeelChanged()
@@ -235,6 +583,8 @@ void GroovPlayer::freezeBlocks()
 {
 	if (!frozen)
 	{
+		autoTempoBeforeFreeze = autoTempo.getToggleState();
+		setAutoTempo(false);
 		lastBPM = bpmSlider.getValue();
 		bpmSlider.setValue(0);
 		frozen = true;
@@ -242,11 +592,22 @@ void GroovPlayer::freezeBlocks()
 	else
 	{
 		bpmSlider.setValue(lastBPM);
+		setAutoTempo(autoTempoBeforeFreeze);
 		frozen = false;
 	}
 	
 }
 
+void GroovPlayer::setAutoTempo(bool shouldFollow)
+{
+	autoTempo.setToggleState(shouldFollow, dontSendNotification);
+	renderer.autoTempo = shouldFollow;
+
+	// Hand back to whatever the slider shows.
+	if (!shouldFollow)
+		renderer.bpm = (int)bpmSlider.getValue();
+}
+
 void GroovPlayer::openButtonClicked()
 {
 	DBG("clicked");
@@ -258,6 +619,42 @@ void GroovPlayer::openButtonClicked()
 	}
 }
 
+void GroovPlayer::stemsButtonClicked()
+{
+	FileChooser chooser ("Choose a folder of stems", getProgramDirectory().getChildFile("Assets"));
+
+	if (chooser.browseForDirectory())
+	{
+		auto result = audioApp->playStems(chooser.getResult());
+
+		if (result.failed())
+			AlertWindow::showMessageBoxAsync(AlertWindow::WarningIcon, "Couldn't load all the stems", result.getErrorMessage());
+	}
+}
+
+void GroovPlayer::cueButtonClicked(int index)
+{
+	auto modifiers = ModifierKeys::getCurrentModifiers();
+
+	if (modifiers.isAltDown())
+		audioApp->clearHotCue(index);
+	else if (modifiers.isShiftDown() || !audioApp->jumpToHotCue(index))
+		audioApp->setHotCue(index);
+
+	timerCallback();
+}
+
+void GroovPlayer::queueButtonClicked()
+{
+	FileChooser chooser ("Choose Mp3 or Wav Files to play next", getProgramDirectory().getChildFile("Assets"), "*.wav; *.mp3");
+
+	if (chooser.browseForMultipleFilesToOpen())
+	{
+		for (auto& file : chooser.getResults())
+			audioApp->queueFile(file);
+	}
+}
+
 void GroovPlayer::playButtonClicked()
 {
 	audioApp->transportStateChanged(GroovAudioApp::TransportState::Starting);
@@ -267,7 +664,54 @@ void GroovPlayer::playButtonClicked()
 void GroovPlayer::stopButtonClicked()
 {
 	audioApp->transportStateChanged(GroovAudioApp::TransportState::Stopping);
-	renderer.stopPlaying();
+
+	// The other deck may still be going.
+	if (!audioApp->isPlaying())
+		renderer.stopPlaying();
+}
+
+void GroovPlayer::deckSelected(int deckIndex)
+{
+	audioApp->setSelectedDeck(deckIndex);
+
+	// Show the newly picked deck straight away rather than at the next tick.
+	timerCallback();
+}
+
+void GroovPlayer::sourceChanged()
+{
+	// The plugin does its own listening, so the device goes back to plain playback under it.
+	auto pluginFeed = sourceBox.getSelectedId() == pluginFeedSourceId;
+	auto mode = pluginFeed ? GroovAudioApp::FilePlayback : (GroovAudioApp::InputMode)(sourceBox.getSelectedId() - 1);
+	auto result = audioApp->setInputMode(mode);
+
+	if (result.failed())
+	{
+		sourceBox.setSelectedId(renderer.followPluginFeed ? (int)pluginFeedSourceId : audioApp->getInputMode() + 1, dontSendNotification);
+		AlertWindow::showMessageBoxAsync(AlertWindow::WarningIcon, "Couldn't open the line in", result.getErrorMessage());
+		return;
+	}
+
+	renderer.followPluginFeed = pluginFeed;
+
+	// The transport has nothing to do while the mixer or the host is playing.
+	auto lineIn = mode == GroovAudioApp::LineIn || pluginFeed;
+
+	if (pluginFeed)
+		for (int i = 0; i < GroovAudioApp::numDecks; ++i)
+			audioApp->getDeck(i).stop();
+
+	changeButtonEnabled(OpenButton, !lineIn);
+	changeButtonEnabled(PlayButton, !lineIn);
+	changeButtonEnabled(StopButton, false);
+	queueButton.setEnabled(!lineIn);
+
+	if (lineIn)
+		renderer.startPlaying();
+	else
+		renderer.stopPlaying();
+
+	bufferSizeBox.setSelectedId(audioApp->getBufferSize(), dontSendNotification);
 }
 
 void GroovPlayer::changeButtonEnabled(ButtonName buttonName, bool state)
@@ -277,6 +721,7 @@ void GroovPlayer::changeButtonEnabled(ButtonName buttonName, bool state)
 	{
 	case OpenButton:
 		openButton.setEnabled(newState);
+		stemsButton.setEnabled(newState);
 		break;
 	case PlayButton:
 		playButton.setEnabled(newState);
@@ -287,3 +732,18 @@ void GroovPlayer::changeButtonEnabled(ButtonName buttonName, bool state)
 	}
 }
 
+void GroovPlayer::showModulationEditor()
+{
+	auto* editor = new ModulationEditor(renderer.modulation);
+	editor->onRoutesChanged = [this]
+	{
+		audioApp->getSettings().setValue("modulationRoutes", ModulationMatrix::routesToString(renderer.modulation.getRoutes()));
+	};
+
+	DialogWindow::LaunchOptions options;
+	options.content.setOwned(editor);
+	options.dialogTitle = "Modulation";
+	options.dialogBackgroundColour = getLookAndFeel().findColour(ResizableWindow::backgroundColourId);
+	options.resizable = false;
+	options.launchAsync();
+}
@@ -11,7 +11,8 @@
 #pragma once
 
 #include "Mesh.h"
-#include "../JuceLibraryCode/JuceHeader.h"
+#include <JuceHeader.h>
+#include "WaveformDisplay.h"
 
 //==============================================================================
 /*
@@ -21,40 +22,13 @@ class GroovRenderer;
 class GroovAudioApp;
 
 class GroovPlayer    :  public Component,
-						private Slider::Listener
+						private Slider::Listener,
+						private Timer
 {
 public:
     GroovPlayer(GroovRenderer& r);
 	~GroovPlayer();
 
-	//==============================================================================
-	//void prepareToPlay(double, int) override {}
-	//void releaseResources() override {}
-	//void processBlock(AudioSampleBuffer&, MidiBuffer&) override {}
-
-	////==============================================================================
-	//AudioProcessorEditor* createEditor() override { return nullptr; }
-	//bool hasEditor() const override { return false; }
-
-	////==============================================================================
-	//const String getName() const override { return {}; }
-	//bool acceptsMidi() const override { return false; }
-	//bool producesMidi() const override { return false; }
-	//double getTailLengthSeconds() const override { return 0; }
-
-	////==============================================================================
-	//int getNumPrograms() override { return 0; }
-	//int getCurrentProgram() override { return 0; }
-	//void setCurrentProgram(int) override {}
-	//const String getProgramName(int) override { return {}; }
-	//void changeProgramName(int, const String&) override {}
-
-	////==============================================================================
-	//void getStateInformation(MemoryBlock&) override {}
-	//void setStateInformation(const void*, int) override {}
-	////==============================================================================
-
-
 	void initialize();
 	void resized() override;
 
@@ -74,22 +48,33 @@ public:
 	void loadShaders();
 
 	const int PLAYER_WIDTH = 600;
-	const int PLAYER_HEIGHT = 325;
+	const int PLAYER_HEIGHT = 580;
 
 private:
 	void sliderValueChanged(Slider*) override;
+	void sliderDragStarted(Slider*) override;
+	void timerCallback() override;
 
 	enum { shaderLinkDelay = 500 };
+	enum { pluginFeedSourceId = 3 };	// In sourceBox, after the input modes
 
 	void lookAndFeelChanged() override;
 
 	void openButtonClicked();
+	void stemsButtonClicked();
+	void queueButtonClicked();
+	void cueButtonClicked(int index);
 	void playButtonClicked();
 	void stopButtonClicked();
+	void sourceChanged();
+	void deckSelected(int deckIndex);
+	void showModulationEditor();
 
 	void freezeBlocks();
+	void setAutoTempo(bool shouldFollow);
 	int lastBPM;
 	bool frozen;
+	bool autoTempoBeforeFreeze = true;
 
 	GroovRenderer& renderer;
 	std::unique_ptr<GroovAudioApp> audioApp;
@@ -104,7 +89,12 @@ private:
 		zoomLabel{ {}, "Zoom: " },
 		bpmLabel{ {}, "BPM: " },
 		bgSpeedLabel{ {}, "BG Speed" },
-		bgValLabel{ {}, "BG Val" };
+		bgValLabel{ {}, "BG Val" },
+		analysisStatus{ {}, "Analysis: idle" },
+		trackStatus{ {}, "No track loaded" },
+		bufferStatus{ {}, "Buffer: off" },
+		avStatus{ {}, "A/V offset: -" },
+		callbackStatus{ {}, "Callback: not running" };
 
 	CodeDocument 
 		vertexDocument, 
@@ -124,14 +114,48 @@ private:
 
 	ToggleButton 
 		enableScaleBounce{ "Enable Bouncing" },
-		freeze{ "FREEZE!" };
+		freeze{ "FREEZE!" },
+		autoTempo{ "Auto BPM" },
+		keyColours{ "Key colours" },
+		monitorLineIn{ "Monitor input" },
+		decodeCacheInt16{ "16-bit cache" },
+		deckAButton{ "Deck A" },
+		deckBButton{ "Deck B" };
 
 	TextButton 
 		openButton, 
+		stemsButton,
+		queueButton,
 		playButton, 
-		stopButton;
+		stopButton,
+		modulationButton;
+
+	// Beat-quantised loops on the selected deck, and its hot cues.
+	TextButton
+		beatLoopButton{ "Loop 4" },
+		loopInButton{ "In" },
+		loopOutButton{ "Out" },
+		exitLoopButton{ "Exit" };
+	OwnedArray<TextButton> cueButtons;	// One per Deck::numHotCues
+
+	Slider crossfadeSlider, avTrimSlider;
+
+	// Crossfader between the decks, and each deck's gain ahead of it.
+	Slider crossfaderSlider, deckAGainSlider, deckBGainSlider;
+
+	ComboBox readAheadBox, spectralBandBox, sourceBox, bufferSizeBox, decodeCacheBox;
+
+	// Following MIDI clock or timecode instead of the music, and from which input.
+	ComboBox syncBox, midiInputBox;
+
+	// Track pre-analysis progress, polled from audioApp in timerCallback.
+	double trackAnalysisProgress = 0.0;
+	ProgressBar trackAnalysisBar{ trackAnalysisProgress };
+
+	WaveformDisplay waveformDisplay;
 
 	const int PARAM_HEIGHT = 25;
+	const int WAVEFORM_HEIGHT = 80;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (GroovPlayer)
 };
\ No newline at end of file
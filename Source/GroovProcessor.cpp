@@ -9,3 +9,98 @@
 */
 
 #include "GroovProcessor.h"
+
+GroovProcessor::GroovProcessor()
+	: AudioProcessor(BusesProperties().withInput("Input", AudioChannelSet::stereo(), true)
+									  .withOutput("Output", AudioChannelSet::stereo(), true))
+{
+}
+
+GroovProcessor::~GroovProcessor()
+{
+	releaseResources();
+}
+
+void GroovProcessor::prepareToPlay(double sampleRate, int maximumExpectedSamplesPerBlock)
+{
+	analyser.prepare(sampleRate, maximumExpectedSamplesPerBlock, getTotalNumInputChannels());
+
+	// The host never calls this while processBlock() is running.
+	if (!feed.isOpen())
+	{
+		feedResult = feed.open(FeatureRing::getDefaultFile());
+
+		if (feedResult.failed())
+			DBG("Groov plugin feed: " + feedResult.getErrorMessage());
+	}
+
+	feedOpen = feed.isOpen();
+}
+
+void GroovProcessor::releaseResources()
+{
+	feedOpen = false;
+	feed.close();
+}
+
+void GroovProcessor::processBlock(AudioBuffer<float>& buffer, MidiBuffer&)
+{
+	ScopedNoDenormals noDenormals;
+
+	for (auto ch = getTotalNumInputChannels(); ch < getTotalNumOutputChannels(); ++ch)
+		buffer.clear(ch, 0, buffer.getNumSamples());
+
+	analyser.pushBlock(buffer, 0, buffer.getNumSamples());
+
+	if (!feedOpen.load(std::memory_order_relaxed))
+		return;
+
+	// The analysis comes a hop or so behind the block, just as it does behind a deck.
+	// This thread is the analyser's only reader.
+	auto* slot = feed.getWriteBuffer();
+
+	if (slot == nullptr)
+		return;
+
+	auto& frame = *slot;
+	frame.features = analyser.getLatestFrame();
+	frame.blockTime = Time::getMillisecondCounterHiRes() * 0.001;
+
+	// Plugins aren't told how far the host's output is behind; the player's A/V trim covers it.
+	frame.latency = 0.0;
+
+	AudioPlayHead::CurrentPositionInfo transport;
+	transport.resetToDefault();
+
+	if (auto* playHead = getPlayHead())
+		if (!playHead->getCurrentPosition(transport))
+			transport.resetToDefault();
+
+	frame.isPlaying = transport.isPlaying;
+	frame.position = transport.timeInSeconds;
+	frame.tempo = transport.bpm;
+	frame.ppqPosition = transport.bpm > 0.0 ? transport.ppqPosition : -1.0;
+	frame.ppqLastBarStart = transport.ppqPositionOfLastBarStart;
+
+	feed.publish();
+}
+
+bool GroovProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
+{
+	auto output = layouts.getMainOutputChannelSet();
+
+	if (output != AudioChannelSet::mono() && output != AudioChannelSet::stereo())
+		return false;
+
+	return layouts.getMainInputChannelSet() == output;
+}
+
+//==============================================================================
+// Only Plugin/GroovPlugin.jucer exports the entry point; the app compiles the class but never makes one.
+// Each project puts its own JuceLibraryCode on the header path, so this sees whichever AppConfig.h is building it.
+#if JUCE_MODULE_AVAILABLE_juce_audio_plugin_client
+AudioProcessor* JUCE_CALLTYPE createPluginFilter()
+{
+	return new GroovProcessor();
+}
+#endif
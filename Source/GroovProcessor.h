@@ -10,4 +10,65 @@
 
 #pragma once
 
-#include "../JuceLibraryCode/JuceHeader.h"
\ No newline at end of file
+#include <JuceHeader.h>
+#include "FeatureRing.h"
+#include "GroovAnalyser.h"
+
+//==============================================================================
+/**
+	Groov's live analysis as a plugin, for the DJ's host: the audio passes
+	through untouched, and every block's newest analysis frame goes into a
+	FeatureRing with the host's transport, for Groov to render from in its own
+	process ("Source: plugin feed").
+
+	The analysis runs on a GroovAnalyser of its own, exactly as it does behind
+	a deck, so the visuals can't tell the two apart. The plugin itself has no
+	parameters or editor.
+*/
+class GroovProcessor : public AudioProcessor
+{
+public:
+	GroovProcessor();
+	~GroovProcessor();
+
+	//==============================================================================
+	void prepareToPlay(double sampleRate, int maximumExpectedSamplesPerBlock) override;
+	void releaseResources() override;
+	void processBlock(AudioBuffer<float>& buffer, MidiBuffer& midiMessages) override;
+
+	bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
+
+	//==============================================================================
+	AudioProcessorEditor* createEditor() override		{ return nullptr; }
+	bool hasEditor() const override						{ return false; }
+
+	//==============================================================================
+	const String getName() const override				{ return "Groov"; }
+	bool acceptsMidi() const override					{ return false; }
+	bool producesMidi() const override					{ return false; }
+	double getTailLengthSeconds() const override		{ return 0.0; }
+
+	//==============================================================================
+	int getNumPrograms() override						{ return 1; }
+	int getCurrentProgram() override					{ return 0; }
+	void setCurrentProgram(int) override				{}
+	const String getProgramName(int) override			{ return {}; }
+	void changeProgramName(int, const String&) override	{}
+
+	//==============================================================================
+	void getStateInformation(MemoryBlock&) override		{}
+	void setStateInformation(const void*, int) override	{}
+
+	/** Why the ring couldn't be opened at the last prepareToPlay(), if it couldn't. */
+	Result getFeedResult() const						{ return feedResult; }
+
+private:
+	GroovAnalyser analyser;
+	FeatureRing::Writer feed;
+	Result feedResult{ Result::ok() };
+
+	// Audio thread only, but opened and closed around it.
+	std::atomic<bool> feedOpen{ false };
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GroovProcessor)
+};
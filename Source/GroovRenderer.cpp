@@ -8,9 +8,10 @@
   ==============================================================================
 */
 
-#include "../JuceLibraryCode/JuceHeader.h"
+#include <JuceHeader.h>
 #include "GroovRenderer.h"
 #include "GroovPlayer.h"
+#include "GroovAudioApp.h"
 
 #include <gtc/matrix_transform.hpp>
 #define GLM_ENABLE_EXPERIMENTAL
@@ -156,6 +157,294 @@ void GroovRenderer::renderOpenGL()
 	std::chrono::duration<double> diff = _curTime - _lastTime;
 	double rdt = diff.count();
 
+	// With vsync, what we draw now is shown at the next refresh, about one frame
+	// period from here. Smoothed so a single slow frame doesn't shift the beat.
+	framePeriod += (jlimit(0.0, 0.1, rdt) - framePeriod) * 0.05;
+	displayLatency = framePeriod;
+	auto presentTime = Time::getMillisecondCounterHiRes() * 0.001 + framePeriod;
+	auto deviceRunning = false;
+	auto deviceTime = 0.0;
+
+	// Pick up the newest frame from each deck's analysis thread. Each orbital
+	// wiggles with its own slice of the band meters: the X orbitals take the
+	// lower half of the bands, the Y orbitals the upper. The envelopes are
+	// already smoothed, so a single loud hop doesn't make them jump.
+	double effectiveBpm = bpm;
+	double targetLooper = 0.0;
+	bool tempoLocked = false;
+	bool phaseExact = false;
+	double targetHue = -1.0;
+
+	// A plugin in the DJ's host stands in for our own decks while it's publishing.
+	auto* feedFrame = followPluginFeed ? readPluginFeed() : nullptr;
+	pluginFeedLive = feedFrame != nullptr;
+
+	if (audioApp != nullptr)
+	{
+		// The feed plays the part of deck A on line in: live, with no track behind it.
+		GroovAudioApp::PlaybackState feedPlayback;
+		const auto& devicePlayback = audioApp->getPlaybackState();
+
+		// Whatever the beat comes from, the device's clock times it.
+		deviceRunning = devicePlayback.blockTime > 0.0 && presentTime - devicePlayback.blockTime < GV_DEVICE_TIMEOUT;
+		deviceTime = devicePlayback.getDeviceTime(presentTime);
+
+		if (feedFrame != nullptr)
+		{
+			feedPlayback.deckWeights[0] = 1.0f;
+			feedPlayback.deckPositions[0] = feedPlayback.position = feedFrame->position;
+			feedPlayback.isPlaying = true;
+			feedPlayback.blockTime = feedFrame->blockTime;
+			feedPlayback.outputLatency = feedFrame->latency + audioApp->getAvTrim();
+		}
+
+		const auto& playback = feedFrame != nullptr ? feedPlayback : devicePlayback;
+		const AnalysisFrame* deckFeatures[GroovAudioApp::numDecks];
+		auto hasNewFrame = false;
+
+		if (feedFrame != nullptr)
+		{
+			static const AnalysisFrame silence;
+			deckFeatures[0] = &feedFrame->features;
+			deckFeatures[1] = &silence;
+
+			// Every block is published, but the features only change once a hop.
+			hasNewFrame = feedFrame->features.samplePosition != lastFeedSamplePosition;
+			lastFeedSamplePosition = feedFrame->features.samplePosition;
+		}
+		else
+		{
+			for (int deck = 0; deck < GroovAudioApp::numDecks; ++deck)
+			{
+				auto& analyser = audioApp->getAnalyser(deck);
+				deckFeatures[deck] = &analyser.getLatestFrame();
+
+				hasNewFrame = hasNewFrame || analyser.getLatestVersion() != lastAnalysisVersions[deck];
+				lastAnalysisVersions[deck] = analyser.getLatestVersion();
+			}
+		}
+
+		// Tempo and key come from the lead deck alone; a blend of two would match neither.
+		const auto& features = *deckFeatures[playback.leadDeck];
+
+		// Levels go through decibels for the modulation sources, so quiet passages
+		// still move whatever they're routed to.
+		auto toUnit = [this](float gain) { return jlimit(0.0f, 1.0f, 1.0f - Decibels::gainToDecibels(gain, GV_MODULATION_FLOOR_DB) / GV_MODULATION_FLOOR_DB); };
+
+		if (hasNewFrame)
+		{
+			auto numOrbitals = 2 * GV_NUM_ORBITALS;
+
+			for (int i = 0; i < numOrbitals; ++i)
+				orbitalLevels[i] = 0.0f;
+
+			// Bring every deck to one loudness, so a quiet master moves things as much as a
+			// loud one: by the track's integrated loudness once it's analysed, and until then
+			// (or on line in) by the live short-term loudness, which the slow glide keeps from
+			// flattening out breakdowns.
+			for (int deck = 0; deck < GroovAudioApp::numDecks; ++deck)
+			{
+				auto track = audioApp->getTrackAnalysis(playback.deckTrackIds[deck]);
+				auto loudness = track != nullptr ? track->loudness.integrated : deckFeatures[deck]->shortTermLoudness;
+
+				if (loudness > LoudnessMeter::silence)
+				{
+					auto gainDb = jlimit(-GV_MAX_LOUDNESS_GAIN_DB, GV_MAX_LOUDNESS_GAIN_DB, GV_REFERENCE_LOUDNESS - loudness);
+					loudnessGains[deck] += (Decibels::decibelsToGain(gainDb) - loudnessGains[deck]) * GV_LOUDNESS_GLIDE;
+				}
+			}
+
+			// Each deck moves the orbitals as much as the crossfader and gains let it into the mix.
+			for (int deck = 0; deck < GroovAudioApp::numDecks; ++deck)
+			{
+				const auto& frame = *deckFeatures[deck];
+				auto weight = playback.deckWeights[deck] * loudnessGains[deck];
+
+				if (weight <= 0.0f)
+					continue;
+
+				for (int i = 0; i < numOrbitals; ++i)
+				{
+					auto firstBand = i * frame.numBands / numOrbitals;
+					auto lastBand = jmax(firstBand + 1, (i + 1) * frame.numBands / numOrbitals);
+					auto level = 0.0f;
+
+					for (int band = firstBand; band < lastBand; ++band)
+						level = jmax(level, frame.bandEnvelope[band]);
+
+					orbitalLevels[i] += weight * level;
+				}
+			}
+
+			// Modulation sources, mixed the same way.
+			float bandEnergies[3] = {}, level = 0.0f, onset = 0.0f;
+
+			for (int deck = 0; deck < GroovAudioApp::numDecks; ++deck)
+			{
+				const auto& frame = *deckFeatures[deck];
+				auto weight = playback.deckWeights[deck];
+				auto levelWeight = weight * loudnessGains[deck];
+
+				if (weight <= 0.0f)
+					continue;
+
+				for (int third = 0; third < 3; ++third)
+				{
+					auto firstBand = third * frame.numBands / 3;
+					auto lastBand = jmax(firstBand + 1, (third + 1) * frame.numBands / 3);
+					auto energy = 0.0f;
+
+					for (int band = firstBand; band < lastBand; ++band)
+						energy += frame.bandEnvelope[band] / (lastBand - firstBand);
+
+					bandEnergies[third] += levelWeight * energy;
+				}
+
+				level += levelWeight * jmax(frame.rms[0], frame.rms[1]);
+				onset += weight * frame.onsetStrength;
+			}
+
+			modulationSources[ModulationMatrix::bass] = toUnit(bandEnergies[0]);
+			modulationSources[ModulationMatrix::mids] = toUnit(bandEnergies[1]);
+			modulationSources[ModulationMatrix::highs] = toUnit(bandEnergies[2]);
+			modulationSources[ModulationMatrix::level] = toUnit(level);
+			modulationSources[ModulationMatrix::onset] = onset;
+		}
+
+		// A stem set's stems are read from their pre-analysed envelopes at the
+		// position being heard, mixed across the decks like the live sources.
+		for (int stem = 0; stem < StemSet::numStems; ++stem)
+		{
+			auto level = 0.0f;
+
+			for (int deck = 0; deck < GroovAudioApp::numDecks; ++deck)
+			{
+				auto weight = playback.deckWeights[deck] * loudnessGains[deck];
+				auto analysis = weight > 0.0f ? audioApp->getStemAnalysis(playback.deckTrackIds[deck], (StemSet::Stem)stem) : nullptr;
+
+				if (analysis != nullptr)
+					level += weight * analysis->getEnergyAt(playback.getAudiblePosition(deck, presentTime));
+			}
+
+			modulationSources[ModulationMatrix::drumsStem + stem] = toUnit(level);
+		}
+
+		// The key for the whole track is steadier than the live estimate, which
+		// drifts with every chord change.
+		if (keyColours)
+		{
+			auto track = audioApp->getTrackAnalysis(playback.trackId);
+
+			if (track != nullptr && track->key >= 0 && track->keyConfidence >= GV_KEY_CONFIDENCE)
+				targetHue = ChromaExtractor::getKeyHue(track->key);
+			else if (features.harmonicHue >= 0.0f)
+				targetHue = features.harmonicHue;
+		}
+
+		// The DJ's own clock outranks anything worked out from the audio, and runs
+		// whether or not we're playing anything. Its loop has already taken the jitter
+		// out, so the phase is followed exactly rather than eased onto. Timecode has
+		// no tempo of its own, so the BPM slider says how fast its seconds go by.
+		auto& midiSync = audioApp->getMidiSync();
+		const auto& syncState = midiSync.getState();
+		auto syncTime = presentTime - audioApp->getAvTrim();
+
+		if (syncState.mode != MidiClockSync::off && syncState.mode == midiSync.getMode() && syncState.isLocked(syncTime))
+		{
+			auto position = syncState.getPositionAt(syncTime);
+			auto beats = position;
+
+			if (syncState.mode == MidiClockSync::midiClock)
+				effectiveBpm = syncState.getTempo();
+			else
+				beats = position * bpm / 60.0;
+
+			if (syncState.isRunning)
+			{
+				targetLooper = glm::pi<double>() * std::fmod(jmax(0.0, beats), 2.0);
+				tempoLocked = phaseExact = true;
+			}
+		}
+		// The host's transport is as exact as a MIDI clock, and knows where its bars start.
+		else if (autoTempo && feedFrame != nullptr && feedFrame->isPlaying && feedFrame->ppqPosition >= 0.0)
+		{
+			auto beats = feedFrame->ppqPosition - feedFrame->ppqLastBarStart
+					   + feedFrame->tempo / 60.0 * playback.getTimeSinceAudible(presentTime);
+
+			effectiveBpm = feedFrame->tempo;
+			targetLooper = glm::pi<double>() * std::fmod(jmax(0.0, beats), 2.0);
+			tempoLocked = phaseExact = true;
+		}
+		// looper goes through 2*pi every two beats. Prefer the pre-analysed beat grid,
+		// which is exact; fall back on the live tracker while it's still being built.
+		// Either way, aim for the beat that will be heard when this frame is on screen.
+		else if (autoTempo && !audioStopped)
+		{
+			auto track = audioApp->getTrackAnalysis(playback.trackId);
+
+			if (track != nullptr && track->beats.size() > 1)
+			{
+				auto position = playback.getAudiblePosition(playback.leadDeck, presentTime);
+				effectiveBpm = track->getTempoAt(position);
+				targetLooper = glm::pi<double>() * std::fmod(track->getBarAlignedBeatPosition(position), 2.0);
+
+				// The position comes from the deck's sample count, so it's exact, loops
+				// and all; the grid decides where it is.
+				tempoLocked = phaseExact = true;
+			}
+			else if (features.tempoConfidence >= GV_TEMPO_CONFIDENCE)
+			{
+				// The live frame is roughly as old as the newest block, so the same offset applies.
+				effectiveBpm = features.tempo;
+				targetLooper = glm::pi<double>() * std::fmod(features.beatPosition + features.tempo / 60.0 * playback.getTimeSinceAudible(presentTime), 2.0);
+				tempoLocked = true;
+			}
+		}
+	}
+
+	// Nothing playing, nothing to follow; the LFOs carry on regardless.
+	if (audioStopped)
+		for (auto source : { ModulationMatrix::bass, ModulationMatrix::mids, ModulationMatrix::highs, ModulationMatrix::level, ModulationMatrix::onset,
+							 ModulationMatrix::drumsStem, ModulationMatrix::bassStem, ModulationMatrix::melodyStem, ModulationMatrix::vocalsStem })
+			modulationSources[source] = 0.0f;
+
+	// looper comes straight from the clock: where an exact source (the beat grid
+	// under the transport, MIDI clock, the host) says it is, or running on at the
+	// tempo from where it was, eased onto the live tracker's beat so its corrections
+	// never show as a jump. Freeze is a tempo of 0.
+	advanceClock(deviceRunning ? deviceTime : presentTime, deviceRunning);
+	beatRamp.setRate(glm::pi<double>() * effectiveBpm / 60.0, clockTime);
+
+	if (resetPeriod)
+		beatRamp.reset(0.0, clockTime);
+
+	if (tempoLocked)
+		beatRamp.anchorPhase += std::remainder(targetLooper - beatRamp.getPhase(clockTime), 2 * glm::pi<double>())
+							  * (phaseExact ? 1.0 : GV_PHASE_PULL);
+
+	looper = std::fmod(beatRamp.getPhase(clockTime), 2 * glm::pi<double>());
+
+	if (looper < 0.0)
+		looper += 2 * glm::pi<double>();
+
+	// looper is two beats round, so its phase over one is the beat phase.
+	auto beatPhase = (float)std::fmod(looper / glm::pi<double>(), 1.0);
+	modulationSources[ModulationMatrix::beatPhase] = beatPhase;
+	modulationSources[ModulationMatrix::beatPulse] = (1.0f - beatPhase) * (1.0f - beatPhase);
+
+	float parameters[ModulationMatrix::numTargets];
+	modulation.process(modulationSources, jlimit(0.0, 0.1, rdt), parameters);
+
+	scale = parameters[ModulationMatrix::zoom];
+	rotationSpeed = parameters[ModulationMatrix::spinSpeed];
+	wiggleSpeed = parameters[ModulationMatrix::wiggle];
+	colorSat = parameters[ModulationMatrix::saturation];
+	colorVal = parameters[ModulationMatrix::brightness];
+	bgHue = parameters[ModulationMatrix::bgHue];
+	bgSpeed = roundToInt(parameters[ModulationMatrix::bgSpeed]);
+	bgSat = parameters[ModulationMatrix::bgSaturation];
+	bgVal = parameters[ModulationMatrix::bgBrightness];
+
 	// Set up view matrix + eye position
 	glm::vec3 eye_world = glm::vec3(0.0, 3.0, 25.0);
 	glm::mat4 view = glm::lookAt(eye_world, glm::vec3(0, 0, 0), glm::vec3(0, 1, 0));
@@ -197,8 +486,23 @@ void GroovRenderer::renderOpenGL()
 		}
 	}
 
-	glm::vec3 userColor = angleToRGB(glm::degrees(looper), colorSat, colorVal);
-	glm::vec3 bgColor = angleToRGB(bgHue, bgSat, bgVal);
+	// Glide the shortest way round the colour wheel, so a key change is a fade, not a jump.
+	if (targetHue >= 0.0)
+		harmonicHue = wrapHue(harmonicHue + std::remainder(targetHue - harmonicHue, 360.0) * GV_HUE_GLIDE);
+
+	glm::vec3 userColor, bgColor;
+
+	if (keyColours)
+	{
+		// Swing a fifth either way with the beat, so the colour still moves.
+		userColor = angleToRGB(wrapHue(harmonicHue + GV_HUE_BEAT_SWING * std::sin(looper)), colorSat, colorVal);
+		bgColor = angleToRGB(wrapHue(harmonicHue + bgHue), bgSat, bgVal);
+	}
+	else
+	{
+		userColor = angleToRGB(glm::degrees(looper), colorSat, colorVal);
+		bgColor = angleToRGB(bgHue, bgSat, bgVal);
+	}
 
 	// Hack to get the background cube to not scale with our scale parameter.
 	float tempScale = scale;
@@ -270,22 +574,16 @@ void GroovRenderer::renderOpenGL()
 	// Set up an identity model matrix
 	glm::mat4 oModelMatrix = glm::mat4(1.0);
 
-	double toAdd = (glm::pi<double>() * (bpm / 60.0) * rdt);
-	double bgToAdd = (glm::pi<double>() * (bgSpeed / 60.0) * rdt);
+	// The sky's own time runs on the same clock, at a quarter of its speed in beats.
+	bgRamp.setRate(glm::pi<double>() * (bgSpeed / 60.0) / 4.0, clockTime);
 
-	if (looper > 2 * glm::pi<double>()) {
-		looper += (toAdd - 2 * glm::pi<double>());
-		beatTime += bgToAdd / 4.0;
-	}
-	else if (resetPeriod) {
-		looper = toAdd;
-		beatTime = bgToAdd;
+	if (resetPeriod)
+	{
+		bgRamp.reset(0.0, clockTime);
 		resetPeriod = false;
 	}
-	else {
-		looper += toAdd;
-		beatTime += bgToAdd / 4.0;
-	}
+
+	beatTime = bgRamp.getPhase(clockTime);
 
 	// Sinusoidal interpolation between 0 and 1 based on looper.
 	if (looper < (glm::pi<double>() ))/// 2.0))
@@ -326,7 +624,7 @@ void GroovRenderer::drawXOrbitals(glm::mat4 model)
 
 	for (int i = 0; i < GV_NUM_ORBITALS; i++) {
 		glm::mat4 baseModel = model;
-		float wiggleDistance = (audioStopped) ? 1000.0f : GV_INV_WIGGLE_DISTANCE;
+		float wiggleDistance = (audioStopped) ? 1000.0f : GV_INV_WIGGLE_DISTANCE / (1.0f + orbitalLevels[i] * GV_LEVEL_WIGGLE_GAIN);
 		transMat = glm::translate(glm::mat4(1.0), glm::vec3(GV_ORBITAL_DISTANCE * cos(curveLooper + (i*glm::pi<float>() / 2.0)), cos(looper*wiggleSpeed) / wiggleDistance, GV_ORBITAL_DISTANCE * sin(curveLooper + (i*glm::pi<float>() / 2.0))));
 		baseModel = transMat * baseModel;
 
@@ -361,7 +659,7 @@ void GroovRenderer::drawYOrbitals(glm::mat4 model)
 
 	for (int i = 0; i < GV_NUM_ORBITALS; i++) {
 		glm::mat4 baseModel = model;
-		float wiggleDistance = (audioStopped) ? 1000.0f : GV_INV_WIGGLE_DISTANCE;
+		float wiggleDistance = (audioStopped) ? 1000.0f : GV_INV_WIGGLE_DISTANCE / (1.0f + orbitalLevels[GV_NUM_ORBITALS + i] * GV_LEVEL_WIGGLE_GAIN);
 		transMat = glm::translate(glm::mat4(1.0), glm::vec3(cos(looper*wiggleSpeed) / wiggleDistance, GV_ORBITAL_DISTANCE * cos(curveLooper + (i*glm::pi<float>() / 2.0) + (glm::pi<float>() / 4.0)), GV_ORBITAL_DISTANCE * sin(curveLooper + (i*glm::pi<float>() / 2.0) + (glm::pi<float>() / 4.0))));
 		baseModel = transMat * baseModel;
 
@@ -534,6 +832,47 @@ void GroovRenderer::initOrbitals() {
 	}
 }
 
+double GroovRenderer::advanceClock(double sourceTime, bool followsDevice)
+{
+	// Switching between the device and the wall clock picks up where the other left off.
+	if (followsDevice != clockFollowsDevice)
+	{
+		clockOffset = clockTime - sourceTime;
+		clockFollowsDevice = followsDevice;
+	}
+
+	// Never backwards, even across a device restart.
+	clockTime = jmax(clockTime, sourceTime + clockOffset);
+	return clockTime;
+}
+
+const FeatureRing::Frame* GroovRenderer::readPluginFeed()
+{
+	auto now = Time::getMillisecondCounterHiRes() * 0.001;
+
+	// A read the writer lapped leaves the last frame in place, which will do if it's recent.
+	if (!pluginFeed.read(feedFrame) && pluginFeed.getReadVersion() > 0 && now - feedFrame.blockTime <= GV_FEED_TIMEOUT)
+		return &feedFrame;
+
+	// A plugin that's been removed, or replaced by one that made a new ring, goes
+	// quiet here; look for its successor now and then.
+	if (now - feedFrame.blockTime > GV_FEED_TIMEOUT)
+	{
+		if (now - lastFeedAttempt < GV_FEED_TIMEOUT)
+			return nullptr;
+
+		lastFeedAttempt = now;
+
+		if (pluginFeed.open(FeatureRing::getDefaultFile()).failed())
+			return nullptr;
+
+		if (!pluginFeed.read(feedFrame) || now - feedFrame.blockTime > GV_FEED_TIMEOUT)
+			return nullptr;
+	}
+
+	return &feedFrame;
+}
+
 void GroovRenderer::startPlaying() {
 	resetPeriod = true;
 	audioStopped = false;
@@ -543,6 +882,12 @@ void GroovRenderer::stopPlaying() {
 	audioStopped = true;
 }
 
+double GroovRenderer::wrapHue(double degrees)
+{
+	degrees = std::fmod(degrees, 360.0);
+	return degrees < 0.0 ? degrees + 360.0 : degrees;
+}
+
 // Adapted from https://stackoverflow.com/questions/3018313/algorithm-to-convert-rgb-to-hsv-and-hsv-to-rgb-in-range-0-255-for-both
 // Takes h in degrees, mind you! Make sure to convert with glm::radians();
 // colorVal and colorSat are parameterized controls. Maybe hue's range will be too, at some point? Not sure.
@@ -10,17 +10,20 @@
 
 #pragma once
 
-#include "../JuceLibraryCode/JuceHeader.h"
+#include <JuceHeader.h>
 #include <glm.hpp>
 #include <chrono>
+#include "FeatureRing.h"
 #include "GLMHelpers.h"
 #include "Mesh.h"
+#include "ModulationMatrix.h"
 
 //==============================================================================
 /*
 */
 
 class GroovPlayer;
+class GroovAudioApp;
 
 class GroovRenderer    : public Component, 
 						 private OpenGLRenderer
@@ -49,16 +52,41 @@ public:
 	std::unique_ptr<GroovPlayer> controlsOverlay;
 
 	bool doScaleBounce = false;
+
+	// Base values for the parameters below, from the player's sliders, plus whatever
+	// the music is routed onto them. Evaluated at the start of every frame.
+	ModulationMatrix modulation;
+
+	// This frame's values, out of modulation. Render thread only.
 	float scale = 0.5f, rotationSpeed = 0.0f, wiggleSpeed = 4.0f, colorSat = 0.5f, colorVal = 1.0f, bgHue = 0.0f;
 
 	// If we change this, we have to change the initial value of initialBPM in private.
 	int bpm = 120;
+	// When set, tempo and beat phase come from the track's beat grid, or the live beat
+	// tracker until that's ready, and bpm is only used while neither is available.
+	bool autoTempo = true;
+	// When set, hue follows the music's key round the circle of fifths, the track's
+	// pre-analysed key or the live harmony until that's ready, and bgHue is an offset from it.
+	bool keyColours = false;
 	int bgSpeed = 125;
 	float bgSat = 0.75;
 	float bgVal = 1.0;
 	void startPlaying();
 	void stopPlaying();
 
+	// Where renderOpenGL picks up audio features and the track position. Set once, before the GL context is attached.
+	void setAudioApp(GroovAudioApp* a) { audioApp = a; }
+
+	// When set, features and the transport come from a GroovProcessor in the DJ's host
+	// while it's publishing, in place of our own decks, and fall back to them when it stops.
+	// Set on the message thread, read on the GL thread.
+	std::atomic<bool> followPluginFeed{ false };
+	// True while the plugin feed is what's being rendered. Safe from any thread.
+	bool isPluginFeedLive() const { return pluginFeedLive.load(); }
+
+	// Estimated time from drawing a frame to it being on screen, in seconds. Safe from any thread.
+	double getDisplayLatency() const { return displayLatency.load(); }
+
 private:	
 	void initOrbitals();
 
@@ -68,6 +96,36 @@ private:
 	float loopingScale = 1.0f;
 	double looper = 0.0;
 	double beatTime = 0.0;
+
+	// A phase running at a steady rate from an anchor. Changing the rate re-anchors
+	// it where it is, so it never jumps, and nothing is added up frame by frame, so
+	// a slow or dropped frame can't shift it.
+	struct PhaseRamp
+	{
+		double anchorPhase = 0.0, anchorTime = 0.0;	// Radians, seconds on the clock below
+		double rate = 0.0;							// Radians per second
+
+		double getPhase(double time) const noexcept	{ return anchorPhase + rate * (time - anchorTime); }
+
+		void setRate(double newRate, double time) noexcept
+		{
+			if (newRate == rate)
+				return;
+
+			anchorPhase = getPhase(time);
+			anchorTime = time;
+			rate = newRate;
+		}
+
+		void reset(double phase, double time) noexcept	{ anchorPhase = phase; anchorTime = time; }
+	};
+
+	// looper's and beatTime's ramps run on the audio device's clock, or on the wall
+	// clock carrying on from it while there's no device.
+	double advanceClock(double sourceTime, bool followsDevice);
+	PhaseRamp beatRamp, bgRamp;
+	double clockTime = 0.0, clockOffset = 0.0;
+	bool clockFollowsDevice = false;
 	double curveLooper = 0.0;
 	double bounceDistance = 1.0;
 	bool resetPeriod = false;
@@ -81,6 +139,27 @@ private:
 	// If we change this, we have to change the initial value of bpm in public.
 	int initialBPM = 120;
 
+	// Live audio features
+	GroovAudioApp* audioApp = nullptr;
+	uint64 lastAnalysisVersions[2] = {};	// One per deck
+	float orbitalLevels[8] = {};	// Band envelope per orbital, X then Y: 2 * GV_NUM_ORBITALS
+	double harmonicHue = 0.0;		// Degrees, glides towards the key's hue
+	float modulationSources[ModulationMatrix::numSources] = {};	// All 0..1
+	float loudnessGains[2] = { 1.0f, 1.0f };	// Per deck, levelling its features to GV_REFERENCE_LOUDNESS
+
+	// Render thread only: the newest frame from the plugin feed, copied into
+	// feedFrame, or nullptr if it's gone quiet.
+	const FeatureRing::Frame* readPluginFeed();
+	FeatureRing::Reader pluginFeed;
+	FeatureRing::Frame feedFrame;
+	double lastFeedAttempt = 0.0;
+	int64 lastFeedSamplePosition = -1;
+	std::atomic<bool> pluginFeedLive{ false };
+
+	// Smoothed frame interval, used to predict when a frame reaches the screen
+	double framePeriod = 1.0 / 60.0;
+	std::atomic<double> displayLatency{ 1.0 / 60.0 };
+
 	std::unique_ptr<OpenGLShaderProgram> shader;
 	std::unique_ptr<OpenGLShaderProgram> skyShader;
 	std::unique_ptr<Mesh::Shape> skyCube;
@@ -112,10 +191,24 @@ private:
 	void drawYOrbitals(glm::mat4 model);
 
 	glm::vec3 angleToRGB(double h, float sat, float val);
+	// Into 0..360, which is all angleToRGB takes.
+	static double wrapHue(double degrees);
 
 	const int GV_NUM_ORBITALS = 4;
 	const float GV_ORBITAL_DISTANCE = 1.35;
 	const float GV_INV_WIGGLE_DISTANCE = 10.0f;
+	const float GV_LEVEL_WIGGLE_GAIN = 2.0f;
+	const float GV_TEMPO_CONFIDENCE = 0.3f;
+	const double GV_PHASE_PULL = 0.1;
+	const double GV_HUE_GLIDE = 0.02;
+	const double GV_HUE_BEAT_SWING = 30.0;
+	const float GV_KEY_CONFIDENCE = 0.5f;
+	const float GV_MODULATION_FLOOR_DB = -60.0f;
+	const float GV_REFERENCE_LOUDNESS = -9.0f;	// LUFS, about where club masters sit, so they look as they always have
+	const float GV_MAX_LOUDNESS_GAIN_DB = 12.0f;
+	const float GV_LOUDNESS_GLIDE = 0.005f;
+	const double GV_FEED_TIMEOUT = 1.0;		// Seconds without a frame before the plugin feed counts as gone
+	const double GV_DEVICE_TIMEOUT = 0.5;	// Seconds without a block before the audio clock counts as stopped
 
 
 	// Author: Stefan Gustavson (stegu@itn.liu.se) 2004
@@ -0,0 +1,241 @@
+/*
+  ==============================================================================
+
+    LoudnessMeter.cpp
+    Created: 18 Oct 2026 12:07:33am
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#include "LoudnessMeter.h"
+
+constexpr float LoudnessMeter::silence, LoudnessMeter::histogramFloor, LoudnessMeter::histogramStep;
+
+namespace
+{
+	const float relativeGate = -10.0f;		// LU below the ungated level, for integrated loudness
+	const float rangeGate = -20.0f;			// The same for loudness range
+}
+
+void LoudnessMeter::prepare(double sampleRate, int numChannels)
+{
+	cascade.setNumChannels(numChannels);
+
+	// BS.1770's filters are only given at 48kHz; these are their analogue
+	// prototypes, bilinear transformed for any rate.
+	{
+		// High shelf, about +4 dB above 1.5kHz: the acoustic effect of the head.
+		auto k = std::tan(MathConstants<double>::pi * 1681.974450955533 / sampleRate);
+		auto q = 0.7071752369554196;
+		auto vh = std::pow(10.0, 3.999843853973347 / 20.0);
+		auto vb = std::pow(vh, 0.4996667741545416);
+		auto a0 = 1.0 + k / q + k * k;
+
+		cascade.setStage(0, (vh + vb * k / q + k * k) / a0, 2.0 * (k * k - vh) / a0, (vh - vb * k / q + k * k) / a0,
+						 2.0 * (k * k - 1.0) / a0, (1.0 - k / q + k * k) / a0);
+	}
+
+	{
+		// The RLB high-pass at 38Hz.
+		auto k = std::tan(MathConstants<double>::pi * 38.13547087602444 / sampleRate);
+		auto q = 0.5003270373238773;
+		auto a0 = 1.0 + k / q + k * k;
+
+		cascade.setStage(1, 1.0, -2.0, 1.0, 2.0 * (k * k - 1.0) / a0, (1.0 - k / q + k * k) / a0);
+	}
+
+	stepSamples = jmax(1, roundToInt(sampleRate * 0.1));
+	reset();
+}
+
+void LoudnessMeter::reset()
+{
+	cascade.reset();
+	samplesThisStep = 0;
+	nextStep = 0;
+	numSteps = 0;
+
+	for (auto& sum : stepSumSquares)
+		sum = 0.0f;
+
+	for (auto& power : stepPowers)
+		power = 0.0;
+
+	momentaryLoudness = shortTermLoudness = maxShortTermLoudness = silence;
+
+	for (int bin = 0; bin < numHistogramBins; ++bin)
+	{
+		blockCounts[bin] = shortTermCounts[bin] = 0;
+		blockPowers[bin] = shortTermPowers[bin] = 0.0;
+	}
+}
+
+void LoudnessMeter::process(const float* const* channels, int numSamples) noexcept
+{
+	const float* offsetChannels[BiquadCascade::maxChannels] = {};
+	int done = 0;
+
+	while (done < numSamples)
+	{
+		auto num = jmin(numSamples - done, stepSamples - samplesThisStep);
+
+		for (int ch = 0; ch < cascade.getNumChannels(); ++ch)
+			offsetChannels[ch] = channels[ch] + done;
+
+		kernels.filterCascade(cascade, offsetChannels, num, stepSumSquares);
+
+		done += num;
+		samplesThisStep += num;
+
+		if (samplesThisStep == stepSamples)
+			finishStep();
+	}
+}
+
+void LoudnessMeter::finishStep() noexcept
+{
+	// Every channel weighs the same for mono and stereo; only surrounds differ.
+	auto sum = 0.0;
+
+	for (auto& channelSum : stepSumSquares)
+	{
+		sum += channelSum;
+		channelSum = 0.0f;
+	}
+
+	stepPowers[nextStep] = sum / stepSamples;
+	nextStep = (nextStep + 1) % stepsPerShortTerm;
+	samplesThisStep = 0;
+	++numSteps;
+
+	auto windowPower = [this](int numWindowSteps)
+	{
+		auto total = 0.0;
+
+		for (int i = 1; i <= numWindowSteps; ++i)
+			total += stepPowers[(nextStep - i + stepsPerShortTerm) % stepsPerShortTerm];
+
+		return total / numWindowSteps;
+	};
+
+	// Until there's a full window, the live readings cover what there is.
+	auto blockPower = windowPower((int)jmin((int64)stepsPerBlock, numSteps));
+	auto shortTermPower = windowPower((int)jmin((int64)stepsPerShortTerm, numSteps));
+	momentaryLoudness = powerToLoudness(blockPower);
+	shortTermLoudness = powerToLoudness(shortTermPower);
+
+	// Only whole windows count towards the totals, and nothing under the absolute gate.
+	if (numSteps >= stepsPerBlock)
+	{
+		auto bin = getHistogramBin(momentaryLoudness);
+
+		if (bin >= 0)
+		{
+			++blockCounts[bin];
+			blockPowers[bin] += blockPower;
+		}
+	}
+
+	if (numSteps >= stepsPerShortTerm)
+	{
+		maxShortTermLoudness = jmax(maxShortTermLoudness, shortTermLoudness);
+		auto bin = getHistogramBin(shortTermLoudness);
+
+		if (bin >= 0)
+		{
+			++shortTermCounts[bin];
+			shortTermPowers[bin] += shortTermPower;
+		}
+	}
+}
+
+float LoudnessMeter::getIntegratedLoudness() const noexcept
+{
+	auto totalPower = 0.0;
+	uint64 totalCount = 0;
+
+	for (int bin = 0; bin < numHistogramBins; ++bin)
+	{
+		totalPower += blockPowers[bin];
+		totalCount += blockCounts[bin];
+	}
+
+	if (totalCount == 0)
+		return silence;
+
+	// The mean of every block over the absolute gate sets the relative gate;
+	// the answer is the mean of the blocks above that.
+	auto firstBin = jmax(0, getHistogramBin(powerToLoudness(totalPower / (double)totalCount) + relativeGate));
+	auto gatedPower = 0.0;
+	uint64 gatedCount = 0;
+
+	for (int bin = firstBin; bin < numHistogramBins; ++bin)
+	{
+		gatedPower += blockPowers[bin];
+		gatedCount += blockCounts[bin];
+	}
+
+	return gatedCount > 0 ? powerToLoudness(gatedPower / (double)gatedCount) : silence;
+}
+
+float LoudnessMeter::getLoudnessRange() const noexcept
+{
+	auto totalPower = 0.0;
+	uint64 totalCount = 0;
+
+	for (int bin = 0; bin < numHistogramBins; ++bin)
+	{
+		totalPower += shortTermPowers[bin];
+		totalCount += shortTermCounts[bin];
+	}
+
+	if (totalCount == 0)
+		return 0.0f;
+
+	auto firstBin = jmax(0, getHistogramBin(powerToLoudness(totalPower / (double)totalCount) + rangeGate));
+	uint64 gatedCount = 0;
+
+	for (int bin = firstBin; bin < numHistogramBins; ++bin)
+		gatedCount += shortTermCounts[bin];
+
+	// From the 10th to the 95th percentile of what's left.
+	auto low = (float)gatedCount * 0.1f, high = (float)gatedCount * 0.95f;
+	auto lowLoudness = silence, highLoudness = silence;
+	uint64 counted = 0;
+
+	for (int bin = firstBin; bin < numHistogramBins; ++bin)
+	{
+		counted += shortTermCounts[bin];
+
+		if (lowLoudness == silence && (float)counted > low)
+			lowLoudness = getHistogramLoudness(bin);
+
+		if ((float)counted >= high)
+		{
+			highLoudness = getHistogramLoudness(bin);
+			break;
+		}
+	}
+
+	return lowLoudness != silence && highLoudness != silence ? highLoudness - lowLoudness : 0.0f;
+}
+
+float LoudnessMeter::powerToLoudness(double power) noexcept
+{
+	return power > 0.0 ? jmax(silence, (float)(-0.691 + 10.0 * std::log10(power))) : silence;
+}
+
+int LoudnessMeter::getHistogramBin(float loudness) noexcept
+{
+	// -1 for anything under the absolute gate.
+	if (loudness < histogramFloor)
+		return -1;
+
+	return jmin((int)numHistogramBins - 1, (int)((loudness - histogramFloor) / histogramStep));
+}
+
+float LoudnessMeter::getHistogramLoudness(int bin) noexcept
+{
+	return histogramFloor + ((float)bin + 0.5f) * histogramStep;
+}
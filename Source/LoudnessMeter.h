@@ -0,0 +1,88 @@
+/*
+  ==============================================================================
+
+    LoudnessMeter.h
+    Created: 18 Oct 2026 12:07:33am
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "MeterKernels.h"
+
+//==============================================================================
+/**
+	Loudness as ITU-R BS.1770-4 and EBU R128 define it: K-weighted, summed over
+	the channels and measured in LUFS.
+
+	Momentary (400 ms) and short-term (3 s) loudness update every 100 ms.
+	Integrated loudness and loudness range cover everything since reset(),
+	gated as the standards say. They come out of fixed 0.1 LU histograms
+	rather than a list of blocks, so the meter never allocates and can run for
+	hours on the analysis thread as well as over a whole track offline.
+
+	The K-weighting filters run through MeterKernels.
+*/
+class LoudnessMeter
+{
+public:
+	/** Uses the fastest kernels by default. */
+	explicit LoudnessMeter(const MeterKernels& kernelsToUse = MeterKernels::get()) : kernels(kernelsToUse) {}
+
+	void prepare(double sampleRate, int numChannels);
+	void reset();
+	int getNumChannels() const noexcept		{ return cascade.getNumChannels(); }
+
+	/** Feeds numSamples of each channel; channels holds getNumChannels() pointers. */
+	void process(const float* const* channels, int numSamples) noexcept;
+
+	// In LUFS, or silence until there's anything to measure.
+	float getMomentaryLoudness() const noexcept			{ return momentaryLoudness; }
+	float getShortTermLoudness() const noexcept			{ return shortTermLoudness; }
+	float getMaxShortTermLoudness() const noexcept		{ return maxShortTermLoudness; }
+	float getIntegratedLoudness() const noexcept;
+
+	/** Spread between quiet and loud passages in LU, per EBU Tech 3342. */
+	float getLoudnessRange() const noexcept;
+
+	static constexpr float silence = -100.0f;
+
+private:
+	enum
+	{
+		stepsPerBlock = 4,			// 400 ms gating blocks, overlapping by 75%
+		stepsPerShortTerm = 30,		// 3 s
+		numHistogramBins = 800		// -70 to +10 LUFS
+	};
+
+	static constexpr float histogramFloor = -70.0f, histogramStep = 0.1f;
+
+	void finishStep() noexcept;
+
+	static float powerToLoudness(double power) noexcept;
+	static int getHistogramBin(float loudness) noexcept;
+	static float getHistogramLoudness(int bin) noexcept;
+
+	const MeterKernels& kernels;
+	BiquadCascade cascade;
+
+	int stepSamples = 4410;
+	int samplesThisStep = 0;
+	float stepSumSquares[BiquadCascade::maxChannels] = {};
+
+	// Mean square of the last stepsPerShortTerm 100 ms steps, written circularly.
+	double stepPowers[stepsPerShortTerm] = {};
+	int nextStep = 0;
+	int64 numSteps = 0;
+
+	float momentaryLoudness = silence, shortTermLoudness = silence, maxShortTermLoudness = silence;
+
+	// Count and summed power of the gating blocks and short-term windows in each bin.
+	uint32 blockCounts[numHistogramBins] = {}, shortTermCounts[numHistogramBins] = {};
+	double blockPowers[numHistogramBins] = {}, shortTermPowers[numHistogramBins] = {};
+
+	JUCE_DECLARE_NON_COPYABLE(LoudnessMeter)
+};
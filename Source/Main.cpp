@@ -8,9 +8,13 @@
   ==============================================================================
 */
 
-#include "../JuceLibraryCode/JuceHeader.h"
+#include <JuceHeader.h>
 #include "GroovRenderer.h"
 #include "GroovPlayer.h"
+#include "MeterBenchmark.h"
+#include "AnalysisBenchmark.h"
+#include "BatchAnalyser.h"
+#include <iostream>
 
 //==============================================================================
 class GroovApplication : public JUCEApplication
@@ -27,6 +31,28 @@ public:
 	void initialise(const String& commandLine) override
 	{
 		// This method is where you should put your application's initialisation code..
+		if (commandLine.contains("--benchmark-meters"))
+		{
+			std::cout << MeterBenchmark::run() << std::flush;
+			quit();
+			return;
+		}
+
+		if (commandLine.contains("--benchmark-analysis"))
+		{
+			setApplicationReturnValue(AnalysisBenchmark::runFromCommandLine(commandLine, std::cout));
+			quit();
+			return;
+		}
+
+		if (commandLine.contains("--analyse-library"))
+		{
+			auto numFailed = BatchAnalyser::runFromCommandLine(commandLine, std::cout);
+			setApplicationReturnValue(numFailed > 0 ? 1 : 0);
+			quit();
+			return;
+		}
+
 		renderer.reset(new GroovRenderer());
 		mainWindow.reset(new MainWindow(getApplicationName(), renderer.get()));
 		displayWindow.reset(new DisplayWindow(getApplicationName() + " Display", renderer.get()));
@@ -0,0 +1,155 @@
+/*
+  ==============================================================================
+
+    MeterBenchmark.cpp
+    Created: 17 Oct 2026 5:41:07pm
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#include "MeterBenchmark.h"
+#include "BandMeter.h"
+#include "LoudnessMeter.h"
+
+namespace
+{
+	const double sampleRate = 48000.0;
+	const int blockSize = 512;
+	const int numBlocks = 64;			// Cycled through, so the input stays in cache like a live block would
+	const int samplesPerRun = 1 << 22;	// About 87 seconds of audio at 48kHz
+
+	HeapBlock<float> makeNoise()
+	{
+		HeapBlock<float> noise((size_t)(blockSize * numBlocks));
+		Random random(0x67726f6f);
+
+		for (int i = 0; i < blockSize * numBlocks; ++i)
+			noise[i] = random.nextFloat() * 2.0f - 1.0f;
+
+		return noise;
+	}
+
+	// Million input samples per second through a BandMeter, one hop per block.
+	double timeBands(const MeterKernels& kernels, const float* noise, int numBands)
+	{
+		BandMeter meter(kernels);
+		meter.prepare(sampleRate, numBands);
+
+		auto start = Time::getHighResolutionTicks();
+
+		for (int done = 0; done < samplesPerRun; done += blockSize)
+		{
+			meter.process(noise + (done / blockSize % numBlocks) * blockSize, blockSize);
+			meter.finishHop();
+		}
+
+		auto seconds = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start);
+		return samplesPerRun / seconds * 1.0e-6;
+	}
+
+	// The same for the level meters: RMS and peak of one channel.
+	double timeLevels(const MeterKernels& kernels, const float* noise)
+	{
+		auto start = Time::getHighResolutionTicks();
+		auto total = 0.0f;
+
+		for (int done = 0; done < samplesPerRun; done += blockSize)
+		{
+			auto* block = noise + (done / blockSize % numBlocks) * blockSize;
+			total += kernels.sumSquares(block, blockSize) + kernels.peak(block, blockSize);
+		}
+
+		auto seconds = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start);
+
+		// Keeps the loop from being optimised away.
+		return total > 0.0f ? samplesPerRun / seconds * 1.0e-6 : 0.0;
+	}
+
+	// The loudness meter's K-weighting, on a stereo pair; counted in samples per channel.
+	double timeLoudness(const MeterKernels& kernels, const float* noise)
+	{
+		LoudnessMeter meter(kernels);
+		meter.prepare(sampleRate, 2);
+
+		auto start = Time::getHighResolutionTicks();
+
+		for (int done = 0; done < samplesPerRun; done += blockSize)
+		{
+			auto* block = noise + (done / blockSize % numBlocks) * blockSize;
+			const float* channels[] = { block, block };
+			meter.process(channels, blockSize);
+		}
+
+		auto seconds = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start);
+		return meter.getIntegratedLoudness() > LoudnessMeter::silence ? samplesPerRun / seconds * 1.0e-6 : 0.0;
+	}
+
+	// And the deck mixer: one channel of a deck added into the output under a gain ramp.
+	double timeMix(const MeterKernels& kernels, const float* noise)
+	{
+		HeapBlock<float> output((size_t)blockSize, true);
+		auto gain = 0.0f;
+
+		auto start = Time::getHighResolutionTicks();
+
+		for (int done = 0; done < samplesPerRun; done += blockSize)
+		{
+			auto nextGain = gain < 1.0f ? gain + 0.01f : 0.0f;
+			kernels.addWithGainRamp(output, noise + (done / blockSize % numBlocks) * blockSize, blockSize, gain, nextGain);
+			gain = nextGain;
+		}
+
+		auto seconds = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start);
+		return output[0] != 0.0f ? samplesPerRun / seconds * 1.0e-6 : 0.0;
+	}
+}
+
+String MeterBenchmark::run()
+{
+	auto noise = makeNoise();
+
+	String report;
+	report << "Meter kernels, mono input at " << sampleRate / 1000.0 << " kHz in " << blockSize
+		   << "-sample blocks, million input samples per second" << newLine << newLine;
+
+	report << "Bands     ";
+
+	for (int set = 0; set < MeterKernels::numInstructionSets; ++set)
+		if (auto* kernels = MeterKernels::forInstructionSet((MeterKernels::InstructionSet)set))
+			report << String(kernels->name).paddedLeft(' ', 10);
+
+	report << newLine;
+
+	for (auto numBands : { 8, 16, 24, 32 })
+	{
+		report << String(numBands).paddedRight(' ', 10);
+
+		for (int set = 0; set < MeterKernels::numInstructionSets; ++set)
+			if (auto* kernels = MeterKernels::forInstructionSet((MeterKernels::InstructionSet)set))
+				report << String(timeBands(*kernels, noise, numBands), 1).paddedLeft(' ', 10);
+
+		report << newLine;
+	}
+
+	report << String("RMS+peak").paddedRight(' ', 10);
+
+	for (int set = 0; set < MeterKernels::numInstructionSets; ++set)
+		if (auto* kernels = MeterKernels::forInstructionSet((MeterKernels::InstructionSet)set))
+			report << String(timeLevels(*kernels, noise), 1).paddedLeft(' ', 10);
+
+	report << newLine << String("Loudness").paddedRight(' ', 10);
+
+	for (int set = 0; set < MeterKernels::numInstructionSets; ++set)
+		if (auto* kernels = MeterKernels::forInstructionSet((MeterKernels::InstructionSet)set))
+			report << String(timeLoudness(*kernels, noise), 1).paddedLeft(' ', 10);
+
+	report << newLine << String("Mix ramp").paddedRight(' ', 10);
+
+	for (int set = 0; set < MeterKernels::numInstructionSets; ++set)
+		if (auto* kernels = MeterKernels::forInstructionSet((MeterKernels::InstructionSet)set))
+			report << String(timeMix(*kernels, noise), 1).paddedLeft(' ', 10);
+
+	report << newLine << newLine << "Live analysis and the mixer use " << MeterKernels::get().name << newLine;
+	return report;
+}
@@ -0,0 +1,24 @@
+/*
+  ==============================================================================
+
+    MeterBenchmark.h
+    Created: 17 Oct 2026 5:41:07pm
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+	Times the meter kernels on a few seconds of noise, for every instruction
+	set this CPU supports, and reports input samples per second for each band
+	count. Run it with "Groov --benchmark-meters".
+*/
+struct MeterBenchmark
+{
+	static String run();
+};
@@ -0,0 +1,578 @@
+/*
+  ==============================================================================
+
+    MeterKernels.cpp
+    Created: 17 Oct 2026 5:02:14pm
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#include "MeterKernels.h"
+
+#if JUCE_USE_SSE_INTRINSICS
+ #include <immintrin.h>
+#endif
+
+// MSVC lets any function use AVX intrinsics; GCC and Clang have to be told per function.
+#if JUCE_USE_SSE_INTRINSICS && (JUCE_GCC || JUCE_CLANG)
+ #define GROOV_TARGET_AVX __attribute__((target("avx")))
+#else
+ #define GROOV_TARGET_AVX
+#endif
+
+//==============================================================================
+void BiquadBank::setNumBands(int newNumBands)
+{
+	numBands = jlimit(0, (int)maxBands, newNumBands);
+
+	for (auto* coefficients : { b0, b1, b2, a1, a2 })
+		FloatVectorOperations::clear(coefficients, maxBands);
+
+	reset();
+}
+
+void BiquadBank::setBandPass(int band, double sampleRate, double centreFrequency, double q)
+{
+	jassert(isPositiveAndBelow(band, numBands));
+
+	auto w0 = MathConstants<double>::twoPi * jlimit(1.0, sampleRate * 0.49, centreFrequency) / sampleRate;
+	auto alpha = std::sin(w0) / (2.0 * q);
+	auto a0 = 1.0 + alpha;
+
+	b0[band] = (float)(alpha / a0);
+	b1[band] = 0.0f;
+	b2[band] = (float)(-alpha / a0);
+	a1[band] = (float)(-2.0 * std::cos(w0) / a0);
+	a2[band] = (float)((1.0 - alpha) / a0);
+}
+
+void BiquadBank::reset()
+{
+	FloatVectorOperations::clear(z1, maxBands);
+	FloatVectorOperations::clear(z2, maxBands);
+}
+
+//==============================================================================
+void BiquadCascade::setNumChannels(int newNumChannels)
+{
+	numChannels = jlimit(0, (int)maxChannels, newNumChannels);
+
+	for (auto* coefficients : { b0, b1, b2, a1, a2 })
+		FloatVectorOperations::clear(coefficients, numLanes);
+
+	reset();
+}
+
+void BiquadCascade::setStage(int stage, double newB0, double newB1, double newB2, double newA1, double newA2)
+{
+	jassert(stage == 0 || stage == 1);
+
+	for (int ch = 0; ch < numChannels; ++ch)
+	{
+		auto lane = stage * maxChannels + ch;
+		b0[lane] = (float)newB0;
+		b1[lane] = (float)newB1;
+		b2[lane] = (float)newB2;
+		a1[lane] = (float)newA1;
+		a2[lane] = (float)newA2;
+	}
+}
+
+void BiquadCascade::reset()
+{
+	FloatVectorOperations::clear(z1, numLanes);
+	FloatVectorOperations::clear(z2, numLanes);
+	FloatVectorOperations::clear(pending, maxChannels);
+}
+
+//==============================================================================
+namespace
+{
+	namespace Scalar
+	{
+		void filterBands(BiquadBank& bank, const float* input, int numSamples, float* sumSquares, float* peak)
+		{
+			for (int band = 0; band < bank.getNumBands(); ++band)
+			{
+				auto b0 = bank.b0[band], b1 = bank.b1[band], b2 = bank.b2[band];
+				auto a1 = bank.a1[band], a2 = bank.a2[band];
+				auto z1 = bank.z1[band], z2 = bank.z2[band];
+				auto sum = 0.0f, top = peak[band];
+
+				for (int i = 0; i < numSamples; ++i)
+				{
+					auto x = input[i];
+					auto y = b0 * x + z1;
+					z1 = b1 * x - a1 * y + z2;
+					z2 = b2 * x - a2 * y;
+
+					sum += y * y;
+					top = jmax(top, std::abs(y));
+				}
+
+				bank.z1[band] = z1;
+				bank.z2[band] = z2;
+				sumSquares[band] += sum;
+				peak[band] = top;
+			}
+		}
+
+		void filterCascade(BiquadCascade& cascade, const float* const* channels, int numSamples, float* sumSquares)
+		{
+			for (int ch = 0; ch < cascade.getNumChannels(); ++ch)
+			{
+				auto first = ch, second = ch + BiquadCascade::maxChannels;
+				auto* input = channels[ch];
+				auto pending = cascade.pending[ch];
+				auto z1a = cascade.z1[first], z2a = cascade.z2[first];
+				auto z1b = cascade.z1[second], z2b = cascade.z2[second];
+				auto sum = 0.0f;
+
+				// Same order as the vector version: the second stage takes the first's previous output.
+				for (int i = 0; i < numSamples; ++i)
+				{
+					auto x = input[i];
+					auto ya = cascade.b0[first] * x + z1a;
+					auto yb = cascade.b0[second] * pending + z1b;
+
+					z1a = cascade.b1[first] * x - cascade.a1[first] * ya + z2a;
+					z2a = cascade.b2[first] * x - cascade.a2[first] * ya;
+					z1b = cascade.b1[second] * pending - cascade.a1[second] * yb + z2b;
+					z2b = cascade.b2[second] * pending - cascade.a2[second] * yb;
+
+					pending = ya;
+					sum += yb * yb;
+				}
+
+				cascade.pending[ch] = pending;
+				cascade.z1[first] = z1a;
+				cascade.z2[first] = z2a;
+				cascade.z1[second] = z1b;
+				cascade.z2[second] = z2b;
+				sumSquares[ch] += sum;
+			}
+		}
+
+		float sumSquares(const float* input, int numSamples)
+		{
+			auto sum = 0.0f;
+
+			for (int i = 0; i < numSamples; ++i)
+				sum += input[i] * input[i];
+
+			return sum;
+		}
+
+		float peak(const float* input, int numSamples)
+		{
+			auto top = 0.0f;
+
+			for (int i = 0; i < numSamples; ++i)
+				top = jmax(top, std::abs(input[i]));
+
+			return top;
+		}
+
+		void followEnvelopes(float* envelopes, const float* levels, int num, float attack, float release)
+		{
+			for (int i = 0; i < num; ++i)
+				envelopes[i] += (levels[i] - envelopes[i]) * (levels[i] > envelopes[i] ? attack : release);
+		}
+
+		void holdPeaks(float* held, float* age, const float* peaks, int num, float elapsed, float holdTime, float decay)
+		{
+			for (int i = 0; i < num; ++i)
+			{
+				age[i] = peaks[i] >= held[i] ? 0.0f : age[i] + elapsed;
+				held[i] = jmax(peaks[i], age[i] > holdTime ? held[i] * decay : held[i]);
+			}
+		}
+
+		void addWithGainRamp(float* dest, const float* source, int num, float startGain, float endGain)
+		{
+			auto step = num > 0 ? (endGain - startGain) / (float)num : 0.0f;
+
+			for (int i = 0; i < num; ++i)
+				dest[i] += source[i] * (startGain + step * (float)i);
+		}
+	}
+
+   #if JUCE_USE_SSE_INTRINSICS
+	//==============================================================================
+	namespace SSE
+	{
+		inline float horizontalSum(__m128 v)
+		{
+			v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+			v = _mm_add_ss(v, _mm_shuffle_ps(v, v, 1));
+			return _mm_cvtss_f32(v);
+		}
+
+		inline float horizontalMax(__m128 v)
+		{
+			v = _mm_max_ps(v, _mm_movehl_ps(v, v));
+			v = _mm_max_ss(v, _mm_shuffle_ps(v, v, 1));
+			return _mm_cvtss_f32(v);
+		}
+
+		// Eight bands per pass in two independent registers, so one band's
+		// recursion runs while the other waits on its multiplies.
+		void filterBands(BiquadBank& bank, const float* input, int numSamples, float* sumSquares, float* peak)
+		{
+			const auto signMask = _mm_set1_ps(-0.0f);
+
+			for (int band = 0; band < bank.getNumPaddedBands(); band += 8)
+			{
+				auto b0a = _mm_loadu_ps(bank.b0 + band), b0b = _mm_loadu_ps(bank.b0 + band + 4);
+				auto b1a = _mm_loadu_ps(bank.b1 + band), b1b = _mm_loadu_ps(bank.b1 + band + 4);
+				auto b2a = _mm_loadu_ps(bank.b2 + band), b2b = _mm_loadu_ps(bank.b2 + band + 4);
+				auto a1a = _mm_loadu_ps(bank.a1 + band), a1b = _mm_loadu_ps(bank.a1 + band + 4);
+				auto a2a = _mm_loadu_ps(bank.a2 + band), a2b = _mm_loadu_ps(bank.a2 + band + 4);
+				auto z1a = _mm_loadu_ps(bank.z1 + band), z1b = _mm_loadu_ps(bank.z1 + band + 4);
+				auto z2a = _mm_loadu_ps(bank.z2 + band), z2b = _mm_loadu_ps(bank.z2 + band + 4);
+
+				auto suma = _mm_setzero_ps(), sumb = _mm_setzero_ps();
+				auto topa = _mm_loadu_ps(peak + band), topb = _mm_loadu_ps(peak + band + 4);
+
+				for (int i = 0; i < numSamples; ++i)
+				{
+					auto x = _mm_set1_ps(input[i]);
+
+					auto ya = _mm_add_ps(_mm_mul_ps(b0a, x), z1a);
+					auto yb = _mm_add_ps(_mm_mul_ps(b0b, x), z1b);
+					z1a = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(b1a, x), _mm_mul_ps(a1a, ya)), z2a);
+					z1b = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(b1b, x), _mm_mul_ps(a1b, yb)), z2b);
+					z2a = _mm_sub_ps(_mm_mul_ps(b2a, x), _mm_mul_ps(a2a, ya));
+					z2b = _mm_sub_ps(_mm_mul_ps(b2b, x), _mm_mul_ps(a2b, yb));
+
+					suma = _mm_add_ps(suma, _mm_mul_ps(ya, ya));
+					sumb = _mm_add_ps(sumb, _mm_mul_ps(yb, yb));
+					topa = _mm_max_ps(topa, _mm_andnot_ps(signMask, ya));
+					topb = _mm_max_ps(topb, _mm_andnot_ps(signMask, yb));
+				}
+
+				_mm_storeu_ps(bank.z1 + band, z1a);
+				_mm_storeu_ps(bank.z1 + band + 4, z1b);
+				_mm_storeu_ps(bank.z2 + band, z2a);
+				_mm_storeu_ps(bank.z2 + band + 4, z2b);
+				_mm_storeu_ps(sumSquares + band, _mm_add_ps(_mm_loadu_ps(sumSquares + band), suma));
+				_mm_storeu_ps(sumSquares + band + 4, _mm_add_ps(_mm_loadu_ps(sumSquares + band + 4), sumb));
+				_mm_storeu_ps(peak + band, topa);
+				_mm_storeu_ps(peak + band + 4, topb);
+			}
+		}
+
+		// Both stages of both channels in one register. A mono cascade leaves
+		// lanes 1 and 3 with zero coefficients, so they stay silent.
+		void filterCascade(BiquadCascade& cascade, const float* const* channels, int numSamples, float* sumSquares)
+		{
+			if (cascade.getNumChannels() == 0)
+				return;
+
+			auto* left = channels[0];
+			auto* right = cascade.getNumChannels() > 1 ? channels[1] : channels[0];
+
+			auto b0 = _mm_loadu_ps(cascade.b0), b1 = _mm_loadu_ps(cascade.b1), b2 = _mm_loadu_ps(cascade.b2);
+			auto a1 = _mm_loadu_ps(cascade.a1), a2 = _mm_loadu_ps(cascade.a2);
+			auto z1 = _mm_loadu_ps(cascade.z1), z2 = _mm_loadu_ps(cascade.z2);
+
+			// Lanes 0 and 1 of y always hold the first stage's latest output.
+			auto y = _mm_setr_ps(cascade.pending[0], cascade.pending[1], 0.0f, 0.0f);
+			auto sum = _mm_setzero_ps();
+
+			for (int i = 0; i < numSamples; ++i)
+			{
+				auto input = _mm_unpacklo_ps(_mm_load_ss(left + i), _mm_load_ss(right + i));
+				auto x = _mm_movelh_ps(input, y);
+
+				y = _mm_add_ps(_mm_mul_ps(b0, x), z1);
+				z1 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(b1, x), _mm_mul_ps(a1, y)), z2);
+				z2 = _mm_sub_ps(_mm_mul_ps(b2, x), _mm_mul_ps(a2, y));
+
+				sum = _mm_add_ps(sum, _mm_mul_ps(y, y));
+			}
+
+			float sums[BiquadCascade::numLanes], outputs[BiquadCascade::numLanes];
+			_mm_storeu_ps(sums, sum);
+			_mm_storeu_ps(outputs, y);
+			_mm_storeu_ps(cascade.z1, z1);
+			_mm_storeu_ps(cascade.z2, z2);
+
+			for (int ch = 0; ch < cascade.getNumChannels(); ++ch)
+			{
+				cascade.pending[ch] = outputs[ch];
+				sumSquares[ch] += sums[ch + BiquadCascade::maxChannels];
+			}
+		}
+
+		float sumSquares(const float* input, int numSamples)
+		{
+			auto sum = _mm_setzero_ps();
+			int i = 0;
+
+			for (; i + 4 <= numSamples; i += 4)
+			{
+				auto x = _mm_loadu_ps(input + i);
+				sum = _mm_add_ps(sum, _mm_mul_ps(x, x));
+			}
+
+			return horizontalSum(sum) + Scalar::sumSquares(input + i, numSamples - i);
+		}
+
+		float peak(const float* input, int numSamples)
+		{
+			const auto signMask = _mm_set1_ps(-0.0f);
+			auto top = _mm_setzero_ps();
+			int i = 0;
+
+			for (; i + 4 <= numSamples; i += 4)
+				top = _mm_max_ps(top, _mm_andnot_ps(signMask, _mm_loadu_ps(input + i)));
+
+			return jmax(horizontalMax(top), Scalar::peak(input + i, numSamples - i));
+		}
+
+		void followEnvelopes(float* envelopes, const float* levels, int num, float attack, float release)
+		{
+			const auto attackCoeff = _mm_set1_ps(attack), releaseCoeff = _mm_set1_ps(release);
+			int i = 0;
+
+			for (; i + 4 <= num; i += 4)
+			{
+				auto envelope = _mm_loadu_ps(envelopes + i);
+				auto level = _mm_loadu_ps(levels + i);
+				auto rising = _mm_cmpgt_ps(level, envelope);
+				auto coeff = _mm_or_ps(_mm_and_ps(rising, attackCoeff), _mm_andnot_ps(rising, releaseCoeff));
+
+				_mm_storeu_ps(envelopes + i, _mm_add_ps(envelope, _mm_mul_ps(_mm_sub_ps(level, envelope), coeff)));
+			}
+
+			Scalar::followEnvelopes(envelopes + i, levels + i, num - i, attack, release);
+		}
+
+		void holdPeaks(float* held, float* age, const float* peaks, int num, float elapsed, float holdTime, float decay)
+		{
+			const auto elapsedStep = _mm_set1_ps(elapsed), hold = _mm_set1_ps(holdTime), decayCoeff = _mm_set1_ps(decay);
+			int i = 0;
+
+			for (; i + 4 <= num; i += 4)
+			{
+				auto peak = _mm_loadu_ps(peaks + i);
+				auto level = _mm_loadu_ps(held + i);
+				auto newPeak = _mm_cmpge_ps(peak, level);
+				auto newAge = _mm_andnot_ps(newPeak, _mm_add_ps(_mm_loadu_ps(age + i), elapsedStep));
+				auto expired = _mm_cmpgt_ps(newAge, hold);
+				auto kept = _mm_or_ps(_mm_and_ps(expired, _mm_mul_ps(level, decayCoeff)), _mm_andnot_ps(expired, level));
+
+				_mm_storeu_ps(age + i, newAge);
+				_mm_storeu_ps(held + i, _mm_max_ps(peak, kept));
+			}
+
+			Scalar::holdPeaks(held + i, age + i, peaks + i, num - i, elapsed, holdTime, decay);
+		}
+
+		void addWithGainRamp(float* dest, const float* source, int num, float startGain, float endGain)
+		{
+			auto step = num > 0 ? (endGain - startGain) / (float)num : 0.0f;
+			const auto laneOffsets = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+			const auto gainStep = _mm_set1_ps(step), start = _mm_set1_ps(startGain);
+			int i = 0;
+
+			// Each gain from its index rather than a running sum, so a long block doesn't drift.
+			for (; i + 4 <= num; i += 4)
+			{
+				auto gain = _mm_add_ps(start, _mm_mul_ps(gainStep, _mm_add_ps(_mm_set1_ps((float)i), laneOffsets)));
+				_mm_storeu_ps(dest + i, _mm_add_ps(_mm_loadu_ps(dest + i), _mm_mul_ps(_mm_loadu_ps(source + i), gain)));
+			}
+
+			Scalar::addWithGainRamp(dest + i, source + i, num - i, startGain + step * (float)i, endGain);
+		}
+	}
+
+	//==============================================================================
+	namespace AVX
+	{
+		GROOV_TARGET_AVX inline __m128 combineHalves(__m256 v, bool useMax)
+		{
+			auto low = _mm256_castps256_ps128(v), high = _mm256_extractf128_ps(v, 1);
+			return useMax ? _mm_max_ps(low, high) : _mm_add_ps(low, high);
+		}
+
+		GROOV_TARGET_AVX void filterBands(BiquadBank& bank, const float* input, int numSamples, float* sumSquares, float* peak)
+		{
+			const auto signMask = _mm256_set1_ps(-0.0f);
+
+			for (int band = 0; band < bank.getNumPaddedBands(); band += 8)
+			{
+				auto b0 = _mm256_loadu_ps(bank.b0 + band), b1 = _mm256_loadu_ps(bank.b1 + band), b2 = _mm256_loadu_ps(bank.b2 + band);
+				auto a1 = _mm256_loadu_ps(bank.a1 + band), a2 = _mm256_loadu_ps(bank.a2 + band);
+				auto z1 = _mm256_loadu_ps(bank.z1 + band), z2 = _mm256_loadu_ps(bank.z2 + band);
+
+				auto sum = _mm256_setzero_ps();
+				auto top = _mm256_loadu_ps(peak + band);
+
+				for (int i = 0; i < numSamples; ++i)
+				{
+					auto x = _mm256_set1_ps(input[i]);
+					auto y = _mm256_add_ps(_mm256_mul_ps(b0, x), z1);
+					z1 = _mm256_add_ps(_mm256_sub_ps(_mm256_mul_ps(b1, x), _mm256_mul_ps(a1, y)), z2);
+					z2 = _mm256_sub_ps(_mm256_mul_ps(b2, x), _mm256_mul_ps(a2, y));
+
+					sum = _mm256_add_ps(sum, _mm256_mul_ps(y, y));
+					top = _mm256_max_ps(top, _mm256_andnot_ps(signMask, y));
+				}
+
+				_mm256_storeu_ps(bank.z1 + band, z1);
+				_mm256_storeu_ps(bank.z2 + band, z2);
+				_mm256_storeu_ps(sumSquares + band, _mm256_add_ps(_mm256_loadu_ps(sumSquares + band), sum));
+				_mm256_storeu_ps(peak + band, top);
+			}
+
+			// Leave the upper halves clean for whatever SSE code runs next.
+			_mm256_zeroupper();
+		}
+
+		GROOV_TARGET_AVX float sumSquares(const float* input, int numSamples)
+		{
+			auto sum = _mm256_setzero_ps();
+			int i = 0;
+
+			for (; i + 8 <= numSamples; i += 8)
+			{
+				auto x = _mm256_loadu_ps(input + i);
+				sum = _mm256_add_ps(sum, _mm256_mul_ps(x, x));
+			}
+
+			auto total = SSE::horizontalSum(combineHalves(sum, false));
+			_mm256_zeroupper();
+
+			return total + Scalar::sumSquares(input + i, numSamples - i);
+		}
+
+		GROOV_TARGET_AVX float peak(const float* input, int numSamples)
+		{
+			const auto signMask = _mm256_set1_ps(-0.0f);
+			auto top = _mm256_setzero_ps();
+			int i = 0;
+
+			for (; i + 8 <= numSamples; i += 8)
+				top = _mm256_max_ps(top, _mm256_andnot_ps(signMask, _mm256_loadu_ps(input + i)));
+
+			auto result = SSE::horizontalMax(combineHalves(top, true));
+			_mm256_zeroupper();
+
+			return jmax(result, Scalar::peak(input + i, numSamples - i));
+		}
+
+		GROOV_TARGET_AVX void followEnvelopes(float* envelopes, const float* levels, int num, float attack, float release)
+		{
+			const auto attackCoeff = _mm256_set1_ps(attack), releaseCoeff = _mm256_set1_ps(release);
+			int i = 0;
+
+			for (; i + 8 <= num; i += 8)
+			{
+				auto envelope = _mm256_loadu_ps(envelopes + i);
+				auto level = _mm256_loadu_ps(levels + i);
+				auto coeff = _mm256_blendv_ps(releaseCoeff, attackCoeff, _mm256_cmp_ps(level, envelope, _CMP_GT_OQ));
+
+				_mm256_storeu_ps(envelopes + i, _mm256_add_ps(envelope, _mm256_mul_ps(_mm256_sub_ps(level, envelope), coeff)));
+			}
+
+			_mm256_zeroupper();
+			SSE::followEnvelopes(envelopes + i, levels + i, num - i, attack, release);
+		}
+
+		GROOV_TARGET_AVX void holdPeaks(float* held, float* age, const float* peaks, int num, float elapsed, float holdTime, float decay)
+		{
+			const auto elapsedStep = _mm256_set1_ps(elapsed), hold = _mm256_set1_ps(holdTime), decayCoeff = _mm256_set1_ps(decay);
+			int i = 0;
+
+			for (; i + 8 <= num; i += 8)
+			{
+				auto peak = _mm256_loadu_ps(peaks + i);
+				auto level = _mm256_loadu_ps(held + i);
+				auto newPeak = _mm256_cmp_ps(peak, level, _CMP_GE_OQ);
+				auto newAge = _mm256_andnot_ps(newPeak, _mm256_add_ps(_mm256_loadu_ps(age + i), elapsedStep));
+				auto expired = _mm256_cmp_ps(newAge, hold, _CMP_GT_OQ);
+				auto kept = _mm256_blendv_ps(level, _mm256_mul_ps(level, decayCoeff), expired);
+
+				_mm256_storeu_ps(age + i, newAge);
+				_mm256_storeu_ps(held + i, _mm256_max_ps(peak, kept));
+			}
+
+			_mm256_zeroupper();
+			SSE::holdPeaks(held + i, age + i, peaks + i, num - i, elapsed, holdTime, decay);
+		}
+
+		GROOV_TARGET_AVX void addWithGainRamp(float* dest, const float* source, int num, float startGain, float endGain)
+		{
+			auto step = num > 0 ? (endGain - startGain) / (float)num : 0.0f;
+			const auto laneOffsets = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+			const auto gainStep = _mm256_set1_ps(step), start = _mm256_set1_ps(startGain);
+			int i = 0;
+
+			for (; i + 8 <= num; i += 8)
+			{
+				auto gain = _mm256_add_ps(start, _mm256_mul_ps(gainStep, _mm256_add_ps(_mm256_set1_ps((float)i), laneOffsets)));
+				_mm256_storeu_ps(dest + i, _mm256_add_ps(_mm256_loadu_ps(dest + i), _mm256_mul_ps(_mm256_loadu_ps(source + i), gain)));
+			}
+
+			_mm256_zeroupper();
+			SSE::addWithGainRamp(dest + i, source + i, num - i, startGain + step * (float)i, endGain);
+		}
+	}
+   #endif
+
+	//==============================================================================
+	const MeterKernels scalarKernels
+	{
+		MeterKernels::scalar, "Scalar",
+		Scalar::filterBands, Scalar::filterCascade, Scalar::sumSquares, Scalar::peak, Scalar::followEnvelopes, Scalar::holdPeaks,
+		Scalar::addWithGainRamp
+	};
+
+   #if JUCE_USE_SSE_INTRINSICS
+	const MeterKernels sseKernels
+	{
+		MeterKernels::sse, "SSE",
+		SSE::filterBands, SSE::filterCascade, SSE::sumSquares, SSE::peak, SSE::followEnvelopes, SSE::holdPeaks,
+		SSE::addWithGainRamp
+	};
+
+	// A stereo cascade fills exactly one SSE register, so AVX has nothing to add there.
+	const MeterKernels avxKernels
+	{
+		MeterKernels::avx, "AVX",
+		AVX::filterBands, SSE::filterCascade, AVX::sumSquares, AVX::peak, AVX::followEnvelopes, AVX::holdPeaks,
+		AVX::addWithGainRamp
+	};
+   #endif
+}
+
+//==============================================================================
+const MeterKernels* MeterKernels::forInstructionSet(InstructionSet set)
+{
+	switch (set)
+	{
+		case scalar:	return &scalarKernels;
+	   #if JUCE_USE_SSE_INTRINSICS
+		case sse:		return SystemStats::hasSSE2() ? &sseKernels : nullptr;
+		case avx:		return SystemStats::hasAVX() ? &avxKernels : nullptr;
+	   #endif
+		default:		return nullptr;
+	}
+}
+
+const MeterKernels& MeterKernels::get()
+{
+	static const MeterKernels& best = []() -> const MeterKernels&
+	{
+		for (int set = numInstructionSets - 1; set > scalar; --set)
+			if (auto* kernels = forInstructionSet((InstructionSet)set))
+				return *kernels;
+
+		return scalarKernels;
+	}();
+
+	return best;
+}
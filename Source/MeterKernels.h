@@ -0,0 +1,125 @@
+/*
+  ==============================================================================
+
+    MeterKernels.h
+    Created: 17 Oct 2026 5:02:14pm
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+	Coefficients and state for a bank of biquads that all filter the same
+	input, one per band.
+
+	Kept as structure-of-arrays and padded to a whole number of AVX registers,
+	so the vector kernels run one band per lane and never need a scalar tail.
+	Padding bands have zero coefficients and always output silence. The
+	kernels use unaligned loads, since heap objects aren't guaranteed 32-byte
+	alignment before C++17; alignas only helps where the compiler honours it.
+*/
+struct BiquadBank
+{
+	enum { maxBands = 32, bandsPerBlock = 8 };
+
+	/** Clears the coefficients and state and sets how many bands are in use. */
+	void setNumBands(int newNumBands);
+	int getNumBands() const noexcept		{ return numBands; }
+	int getNumPaddedBands() const noexcept	{ return (numBands + bandsPerBlock - 1) & ~(bandsPerBlock - 1); }
+
+	/** RBJ band-pass with 0 dB peak gain. */
+	void setBandPass(int band, double sampleRate, double centreFrequency, double q);
+	void reset();
+
+	// Transposed direct form II, normalised so a0 is 1.
+	alignas(32) float b0[maxBands], b1[maxBands], b2[maxBands], a1[maxBands], a2[maxBands];
+	alignas(32) float z1[maxBands], z2[maxBands];
+
+private:
+	int numBands = 0;
+};
+
+//==============================================================================
+/**
+	Two biquads in series for each of up to two channels, as K-weighting needs.
+
+	Laid out so one SSE register holds both stages of both channels: lanes 0
+	and 1 are the first stage of each channel, lanes 2 and 3 the second. The
+	second stage filters what the first produced a sample earlier, so all four
+	run at once and the output comes one sample late, which no meter notices.
+*/
+struct BiquadCascade
+{
+	enum { maxChannels = 2, numLanes = 2 * maxChannels };
+
+	/** Clears the coefficients and state and sets how many channels are in use. */
+	void setNumChannels(int newNumChannels);
+	int getNumChannels() const noexcept		{ return numChannels; }
+
+	/** Sets stage 0 or 1 for every channel in use. Coefficients normalised so a0 is 1. */
+	void setStage(int stage, double b0, double b1, double b2, double a1, double a2);
+	void reset();
+
+	// Transposed direct form II, as in BiquadBank.
+	alignas(16) float b0[numLanes], b1[numLanes], b2[numLanes], a1[numLanes], a2[numLanes];
+	alignas(16) float z1[numLanes], z2[numLanes];
+	float pending[maxChannels];		// The first stage's latest output, due into the second
+
+private:
+	int numChannels = 0;
+};
+
+//==============================================================================
+/**
+	The inner loops behind the level, band and loudness meters and the deck mixer, in
+	scalar, SSE and AVX versions.
+
+	get() picks the fastest version the CPU supports the first time it's
+	called. The others stay reachable through forInstructionSet() so the
+	benchmark can compare them. Every kernel is allocation-free and safe on the
+	audio thread.
+*/
+struct MeterKernels
+{
+	enum InstructionSet { scalar, sse, avx, numInstructionSets };
+
+	/** The best version this CPU can run. */
+	static const MeterKernels& get();
+	/** A specific version, or nullptr if this CPU or build can't run it. */
+	static const MeterKernels* forInstructionSet(InstructionSet set);
+
+	InstructionSet instructionSet;
+	const char* name;
+
+	/** Runs numSamples of input through every band of the bank, adding each
+		band's sum of squares to sumSquares[band] and raising peak[band] to its
+		largest absolute output. Both arrays need getNumPaddedBands() elements. */
+	void (*filterBands)(BiquadBank& bank, const float* input, int numSamples, float* sumSquares, float* peak);
+
+	/** Runs numSamples of each channel through the cascade, adding the sum of
+		squares of each channel's output to sumSquares[channel]. channels holds
+		getNumChannels() pointers. */
+	void (*filterCascade)(BiquadCascade& cascade, const float* const* channels, int numSamples, float* sumSquares);
+
+	/** Sum of the squares of numSamples samples. */
+	float (*sumSquares)(const float* input, int numSamples);
+	/** Largest absolute value in numSamples samples. */
+	float (*peak)(const float* input, int numSamples);
+
+	/** One step of an attack/release follower per element: each envelope moves
+		towards its level by attack when rising and by release when falling. */
+	void (*followEnvelopes)(float* envelopes, const float* levels, int num, float attack, float release);
+
+	/** Peak hold per element: a new peak is held for holdTime seconds, then
+		multiplied by decay every step. elapsed is the time one step covers. */
+	void (*holdPeaks)(float* held, float* age, const float* peaks, int num, float elapsed, float holdTime, float decay);
+
+	/** Adds num samples of source into dest with a gain stepping linearly from
+		startGain towards endGain, as AudioBuffer::addFromWithRamp does. */
+	void (*addWithGainRamp)(float* dest, const float* source, int num, float startGain, float endGain);
+};
@@ -0,0 +1,313 @@
+/*
+  ==============================================================================
+
+    MidiClockSync.cpp
+    Created: 18 Oct 2026 1:12:48am
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#include "MidiClockSync.h"
+
+const char* const MidiClockSync::virtualPortName = "Groov virtual input";
+
+namespace
+{
+	// Loop bandwidth in Hz: wide to pull in quickly, then narrow to average the jitter away.
+	const double lockBandwidth = 4.0, trackBandwidth = 0.5;
+	const int ticksToSettle = 48;		// Two beats of clock
+	const int ticksToLock = 4;			// Enough to trust the period at all
+	const double dropoutTime = 0.5;		// Seconds without a tick before the sender's taken to be gone
+	const int clockTicksPerBeat = 24;
+
+	// MTC's frame rate codes are the same as MidiMessage::SmpteTimecodeType.
+	double timecodeToSeconds(int hours, int minutes, int seconds, int frames, int rateCode) noexcept
+	{
+		if (rateCode == MidiMessage::fps30drop)
+		{
+			// 29.97 drop frame skips frame numbers 0 and 1 every minute but each tenth,
+			// which keeps the count to real time.
+			auto totalMinutes = 60 * hours + minutes;
+			auto frameNumber = (3600 * hours + 60 * minutes + seconds) * 30 + frames - 2 * (totalMinutes - totalMinutes / 10);
+			return frameNumber * 1001.0 / 30000.0;
+		}
+
+		const double rates[] = { 24.0, 25.0, 30000.0 / 1001.0, 30.0 };
+		return 3600.0 * hours + 60.0 * minutes + seconds + frames / rates[rateCode & 3];
+	}
+
+	double getSecondsPerQuarterFrame(int rateCode) noexcept
+	{
+		const double rates[] = { 24.0, 25.0, 30000.0 / 1001.0, 30.0 };
+		return 0.25 / rates[rateCode & 3];
+	}
+}
+
+//==============================================================================
+bool MidiClockSync::State::isLocked(double wallTime) const noexcept
+{
+	if (mode == off || numTicks < ticksToLock || wallTime - tickTime > dropoutTime)
+		return false;
+
+	// Timecode has nothing to give until it's running; a stopped clock still has its tempo.
+	return mode == midiClock || isRunning;
+}
+
+double MidiClockSync::State::getPositionAt(double wallTime) const noexcept
+{
+	if (!isRunning || nextTickTime <= tickTime)
+		return tickPosition;
+
+	return tickPosition + unitsPerTick * (wallTime - tickTime) / (nextTickTime - tickTime);
+}
+
+double MidiClockSync::State::getTempo() const noexcept
+{
+	if (mode != midiClock || nextTickTime <= tickTime)
+		return 0.0;
+
+	return 60.0 * unitsPerTick / (nextTickTime - tickTime);
+}
+
+//==============================================================================
+bool MidiClockSync::TickFilter::addTick(double time) noexcept
+{
+	if (numTicks > 0 && time - lastArrival > dropoutTime)
+		numTicks = 0;
+
+	lastArrival = time;
+
+	if (numTicks == 0)
+	{
+		tickTime = nextTickTime = time;
+		period = 0.0;
+		numTicks = 1;
+		return false;
+	}
+
+	if (numTicks == 1)
+	{
+		period = time - tickTime;
+		tickTime = time;
+		nextTickTime = time + period;
+		numTicks = 2;
+		return true;
+	}
+
+	auto error = time - nextTickTime;
+
+	// A jump that big is a new tempo or a stalled driver, not jitter; start again from here.
+	if (std::abs(error) > 2.0 * period)
+	{
+		tickTime = nextTickTime = time;
+		numTicks = 1;
+		return false;
+	}
+
+	// Critically damped, with the bandwidth scaled to the tick rate. Capped so a slow
+	// clock can't push the loop unstable while it's still pulling in.
+	auto bandwidth = numTicks < ticksToSettle ? lockBandwidth : trackBandwidth;
+	auto omega = jmin(0.5, MathConstants<double>::twoPi * bandwidth * period);
+
+	tickTime = nextTickTime;
+	nextTickTime += std::sqrt(2.0) * omega * error + period;
+	period += omega * omega * error;
+	++numTicks;
+	return true;
+}
+
+//==============================================================================
+MidiClockSync::MidiClockSync()
+{
+	publish();
+}
+
+MidiClockSync::~MidiClockSync()
+{
+	// Stop the callbacks before anything they use goes.
+	input.reset();
+}
+
+double MidiClockSync::getClockTempo() const noexcept
+{
+	auto now = Time::getMillisecondCounterHiRes() * 0.001;
+	return now - lastTickTime.load() < dropoutTime ? clockTempo.load() : 0.0;
+}
+
+StringArray MidiClockSync::getInputNames()
+{
+	auto names = MidiInput::getDevices();
+
+   #if JUCE_MAC || JUCE_LINUX
+	names.add(virtualPortName);
+   #endif
+
+	return names;
+}
+
+Result MidiClockSync::setInput(const String& name)
+{
+	input.reset();
+	inputName = {};
+
+	if (name.isEmpty())
+		return Result::ok();
+
+	MidiInput* newInput = nullptr;
+
+   #if JUCE_MAC || JUCE_LINUX
+	// For a software clock on this machine to connect to.
+	if (name == virtualPortName)
+		newInput = MidiInput::createNewDevice(name, this);
+	else
+   #endif
+	{
+		auto index = MidiInput::getDevices().indexOf(name);
+
+		if (index >= 0)
+			newInput = MidiInput::openDevice(index, this);
+	}
+
+	if (newInput == nullptr)
+		return Result::fail("Couldn't open the MIDI input " + name);
+
+	input.reset(newInput);
+	input->start();
+	inputName = name;
+	return Result::ok();
+}
+
+//==============================================================================
+void MidiClockSync::handleIncomingMidiMessage(MidiInput*, const MidiMessage& message)
+{
+	auto currentMode = mode.load();
+
+	// Nothing from the old mode carries over.
+	if (currentMode != lastMode)
+	{
+		lastMode = currentMode;
+		filter.reset();
+		isRunning = false;
+		tickPosition = nextPosition = 0.0;
+		piecesInOrder = 0;
+		publish();
+	}
+
+	if (currentMode == midiClock)
+		handleClock(message);
+	else if (currentMode == timecode)
+		handleTimecode(message);
+}
+
+void MidiClockSync::handleClock(const MidiMessage& message)
+{
+	if (message.isMidiClock())
+	{
+		filter.addTick(message.getTimeStamp());
+		tickPosition = nextPosition;
+
+		// A stopped clock keeps ticking for its tempo, but doesn't move.
+		if (isRunning)
+			nextPosition += 1.0 / clockTicksPerBeat;
+	}
+	else if (message.isMidiStart())
+	{
+		// The first tick after a start is the downbeat.
+		isRunning = true;
+		nextPosition = 0.0;
+	}
+	else if (message.isMidiContinue())
+	{
+		isRunning = true;
+	}
+	else if (message.isMidiStop())
+	{
+		isRunning = false;
+	}
+	else if (message.isSongPositionPointer())
+	{
+		// In sixteenths, for the next tick to land on.
+		nextPosition = message.getSongPositionPointerMidiBeat() / 4.0;
+	}
+	else
+	{
+		return;
+	}
+
+	publish();
+}
+
+void MidiClockSync::handleTimecode(const MidiMessage& message)
+{
+	if (message.isQuarterFrame())
+	{
+		// Each quarter frame is a tick. Until a whole timecode has come in since the
+		// loop last (re)started, there's a tempo of sorts but no position.
+		if (!filter.addTick(message.getTimeStamp()))
+			isRunning = false;
+
+		auto piece = message.getQuarterFrameSequenceNumber();
+		quarterFrames[piece] = message.getQuarterFrameValue();
+
+		// Running backwards, or a piece lost, spoils the set.
+		piecesInOrder = piece == (lastPiece + 1) % 8 ? piecesInOrder + 1 : (piece == 0 ? 1 : 0);
+		lastPiece = piece;
+
+		tickPosition = nextPosition;
+
+		if (isRunning)
+			nextPosition += secondsPerQuarterFrame;
+
+		if (piece == 7 && piecesInOrder >= 8)
+		{
+			auto rateCode = (quarterFrames[7] >> 1) & 3;
+			auto frames = quarterFrames[0] | (quarterFrames[1] & 1) << 4;
+			auto seconds = quarterFrames[2] | (quarterFrames[3] & 3) << 4;
+			auto minutes = quarterFrames[4] | (quarterFrames[5] & 3) << 4;
+			auto hours = quarterFrames[6] | (quarterFrames[7] & 1) << 4;
+
+			// The timecode is when piece 0 arrived, seven quarter frames ago.
+			secondsPerQuarterFrame = getSecondsPerQuarterFrame(rateCode);
+			tickPosition = timecodeToSeconds(hours, minutes, seconds, frames, rateCode) + 7.0 * secondsPerQuarterFrame;
+			nextPosition = tickPosition + secondsPerQuarterFrame;
+			isRunning = true;
+		}
+	}
+	else if (message.isFullFrame())
+	{
+		// A locate: the sender has jumped, and quarter frames follow once it's rolling.
+		int hours = 0, minutes = 0, seconds = 0, frames = 0;
+		MidiMessage::SmpteTimecodeType rate;
+		message.getFullFrameParameters(hours, minutes, seconds, frames, rate);
+
+		secondsPerQuarterFrame = getSecondsPerQuarterFrame(rate);
+		tickPosition = nextPosition = timecodeToSeconds(hours, minutes, seconds, frames, rate);
+		isRunning = false;
+		piecesInOrder = 0;
+		filter.reset();
+	}
+	else
+	{
+		return;
+	}
+
+	publish();
+}
+
+void MidiClockSync::publish()
+{
+	// The slot may hold any older snapshot, so it's always written in full.
+	auto& state = states.getWriteBuffer();
+	state.mode = lastMode;
+	state.isRunning = isRunning;
+	state.numTicks = filter.numTicks;
+	state.tickTime = filter.tickTime;
+	state.nextTickTime = filter.nextTickTime;
+	state.tickPosition = tickPosition;
+	state.unitsPerTick = lastMode == midiClock ? 1.0 / clockTicksPerBeat : secondsPerQuarterFrame;
+
+	clockTempo = state.numTicks >= ticksToLock ? state.getTempo() : 0.0;
+	lastTickTime = state.tickTime;
+	states.publish();
+}
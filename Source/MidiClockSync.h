@@ -0,0 +1,119 @@
+/*
+  ==============================================================================
+
+    MidiClockSync.h
+    Created: 18 Oct 2026 1:12:48am
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "SnapshotBuffer.h"
+#include <atomic>
+
+//==============================================================================
+/**
+	Follows the DJ's own gear over MIDI: MIDI clock (24 ticks a beat, with
+	start, stop, continue and song position) or MIDI Time Code quarter frames.
+
+	Tick arrival times jitter by a millisecond or more between the sender, the
+	driver and the timestamp, so every tick goes through a second-order
+	delay-locked loop. Its output is a smooth tick time and period that the
+	render thread extrapolates to any moment, and which sits well under a
+	millisecond off the sender's clock once the loop has settled.
+
+	MIDI messages arrive on the device's own thread, which is the only one that
+	touches the loop; the render thread reads the result through getState().
+	Everything else is message thread only.
+*/
+class MidiClockSync : private MidiInputCallback
+{
+public:
+	MidiClockSync();
+	~MidiClockSync();
+
+	enum Mode
+	{
+		off,
+		midiClock,
+		timecode
+	};
+
+	void setMode(Mode newMode) noexcept { mode = newMode; }
+	Mode getMode() const noexcept { return mode.load(); }
+
+	/** The MIDI inputs there are, plus virtualPortName where the platform lets us make our own. */
+	static StringArray getInputNames();
+	static const char* const virtualPortName;
+
+	/** Opens an input by one of the names above, closing the last; an empty name just closes it. */
+	Result setInput(const String& name);
+	String getInputName() const { return inputName; }
+
+	struct State
+	{
+		Mode mode = off;
+		bool isRunning = false;		// Clock started and not stopped, or timecode moving
+		int numTicks = 0;			// Since the loop last started, so the first few can be ignored
+
+		double tickTime = 0.0;		// Filtered time of the newest tick, on Time::getMillisecondCounterHiRes() in seconds...
+		double nextTickTime = 0.0;	// ...and when the next is due
+		double tickPosition = 0.0;	// Beats for clock, seconds for timecode, at tickTime
+		double unitsPerTick = 0.0;	// 1/24 beat, or a quarter frame in seconds
+
+		/** True while ticks are still coming and the loop has had time to lock. */
+		bool isLocked(double wallTime) const noexcept;
+		/** Beats or seconds at wallTime; only meaningful while isLocked(). */
+		double getPositionAt(double wallTime) const noexcept;
+		/** Clock only; timecode carries no tempo. */
+		double getTempo() const noexcept;
+	};
+
+	// Render thread only.
+	const State& getState() noexcept { return states.read(); }
+
+	/** The clock's tempo for display, or 0 without one. Safe from any thread. */
+	double getClockTempo() const noexcept;
+
+private:
+	void handleIncomingMidiMessage(MidiInput*, const MidiMessage& message) override;
+
+	void handleClock(const MidiMessage& message);
+	void handleTimecode(const MidiMessage& message);
+	void publish();
+
+	/** The delay-locked loop, after Fons Adriaensen's "Using a DLL to filter time". */
+	struct TickFilter
+	{
+		void reset() noexcept { numTicks = 0; }
+		/** Takes a tick's raw arrival time; returns false when it restarted the loop instead. */
+		bool addTick(double time) noexcept;
+
+		int numTicks = 0;
+		double lastArrival = 0.0;
+		double tickTime = 0.0, nextTickTime = 0.0, period = 0.0;
+	};
+
+	std::atomic<Mode> mode{ off };
+
+	// MIDI thread only.
+	Mode lastMode = off;
+	TickFilter filter;
+	bool isRunning = false;
+	double tickPosition = 0.0;		// Where the newest tick landed, in beats or seconds...
+	double nextPosition = 0.0;		// ...and where the next will
+	int quarterFrames[8] = {};		// Timecode pieces as they arrive
+	int lastPiece = 7, piecesInOrder = 0;
+	double secondsPerQuarterFrame = 1.0 / 100.0;
+
+	SnapshotBuffer<State> states;
+	std::atomic<double> clockTempo{ 0.0 }, lastTickTime{ 0.0 };
+
+	std::unique_ptr<MidiInput> input;
+	String inputName;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MidiClockSync)
+};
@@ -0,0 +1,169 @@
+/*
+  ==============================================================================
+
+    ModulationEditor.cpp
+    Created: 17 Oct 2026 11:20:51pm
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#include "ModulationEditor.h"
+
+namespace
+{
+	const int boxWidth = 110, buttonWidth = 30;
+}
+
+ModulationEditor::RouteRow::RouteRow()
+{
+	for (int source = 0; source < ModulationMatrix::numSources; ++source)
+		sourceBox.addItem(ModulationMatrix::getSourceName((ModulationMatrix::Source)source), source + 1);
+
+	for (int target = 0; target < ModulationMatrix::numTargets; ++target)
+		targetBox.addItem(ModulationMatrix::getTargetName((ModulationMatrix::Target)target), target + 1);
+
+	depthSlider.setRange(-1.0, 1.0, 0.01);
+	depthSlider.setDoubleClickReturnValue(true, 0.5);
+	offsetSlider.setRange(-1.0, 1.0, 0.01);
+	offsetSlider.setDoubleClickReturnValue(true, 0.0);
+	smoothingSlider.setRange(0.0, 2.0, 0.01);
+	smoothingSlider.setSkewFactor(0.5);
+	smoothingSlider.setTextValueSuffix(" s");
+
+	for (auto* slider : { &depthSlider, &offsetSlider, &smoothingSlider })
+		slider->setTextBoxStyle(Slider::TextBoxLeft, false, 50, rowHeight - 5);
+
+	for (auto* child : std::initializer_list<Component*>{ &sourceBox, &targetBox, &depthSlider, &offsetSlider, &smoothingSlider, &removeButton })
+		addAndMakeVisible(child);
+}
+
+void ModulationEditor::RouteRow::resized()
+{
+	auto area = getLocalBounds();
+	sourceBox.setBounds(area.removeFromLeft(boxWidth).reduced(2));
+	targetBox.setBounds(area.removeFromLeft(boxWidth).reduced(2));
+	removeButton.setBounds(area.removeFromRight(buttonWidth).reduced(2));
+
+	auto sliderWidth = area.getWidth() / 3;
+	depthSlider.setBounds(area.removeFromLeft(sliderWidth));
+	offsetSlider.setBounds(area.removeFromLeft(sliderWidth));
+	smoothingSlider.setBounds(area);
+}
+
+//==============================================================================
+ModulationEditor::ModulationEditor(ModulationMatrix& matrixToEdit)
+	: matrix(matrixToEdit),
+	  routes(matrixToEdit.getRoutes())
+{
+	for (auto* name : { "Source", "Target", "Depth", "Offset", "Smoothing" })
+	{
+		auto* heading = headings.add(new Label({}, name));
+		heading->setFont(Font(12.0f));
+		addAndMakeVisible(heading);
+	}
+
+	addAndMakeVisible(addButton);
+	addButton.onClick = [this] { addRoute(); };
+
+	rebuildRows();
+	setSize(640, rowHeight * (ModulationMatrix::maxRoutes + 2));
+}
+
+void ModulationEditor::resized()
+{
+	auto area = getLocalBounds().reduced(4);
+
+	auto headingRow = area.removeFromTop(rowHeight);
+	headings[0]->setBounds(headingRow.removeFromLeft(boxWidth));
+	headings[1]->setBounds(headingRow.removeFromLeft(boxWidth));
+	headingRow.removeFromRight(buttonWidth);
+
+	auto sliderWidth = headingRow.getWidth() / 3;
+	headings[2]->setBounds(headingRow.removeFromLeft(sliderWidth));
+	headings[3]->setBounds(headingRow.removeFromLeft(sliderWidth));
+	headings[4]->setBounds(headingRow);
+
+	for (auto* row : rows)
+		row->setBounds(area.removeFromTop(rowHeight));
+
+	addButton.setBounds(area.removeFromTop(rowHeight).removeFromLeft(boxWidth).reduced(2));
+}
+
+void ModulationEditor::rebuildRows()
+{
+	rows.clear();
+
+	for (int i = 0; i < routes.size(); ++i)
+	{
+		auto* row = rows.add(new RouteRow());
+		const auto& route = routes.getReference(i);
+
+		row->sourceBox.setSelectedId(route.source + 1, dontSendNotification);
+		row->targetBox.setSelectedId(route.target + 1, dontSendNotification);
+		row->depthSlider.setValue(route.depth, dontSendNotification);
+		row->offsetSlider.setValue(route.offset, dontSendNotification);
+		row->smoothingSlider.setValue(route.smoothing, dontSendNotification);
+
+		row->sourceBox.onChange = [this, i] { rowEdited(i); };
+		row->targetBox.onChange = [this, i] { rowEdited(i); };
+		row->depthSlider.onValueChange = [this, i] { rowEdited(i); };
+		row->offsetSlider.onValueChange = [this, i] { rowEdited(i); };
+		row->smoothingSlider.onValueChange = [this, i] { rowEdited(i); };
+
+		// The row goes with its button, so it can't be removed from inside the click.
+		row->removeButton.onClick = [this, i]
+		{
+			SafePointer<ModulationEditor> editor(this);
+			MessageManager::callAsync([editor, i] { if (editor != nullptr) editor->removeRoute(i); });
+		};
+
+		addAndMakeVisible(row);
+	}
+
+	addButton.setEnabled(routes.size() < ModulationMatrix::maxRoutes);
+	resized();
+}
+
+void ModulationEditor::addRoute()
+{
+	if (routes.size() >= ModulationMatrix::maxRoutes)
+		return;
+
+	routes.add(ModulationMatrix::Route());
+	matrix.setRoutes(routes);
+
+	// Takes the new route's id, so later edits keep its smoothing.
+	routes = matrix.getRoutes();
+	rebuildRows();
+
+	if (onRoutesChanged != nullptr)
+		onRoutesChanged();
+}
+
+void ModulationEditor::removeRoute(int index)
+{
+	routes.remove(index);
+	matrix.setRoutes(routes);
+	rebuildRows();
+
+	if (onRoutesChanged != nullptr)
+		onRoutesChanged();
+}
+
+void ModulationEditor::rowEdited(int index)
+{
+	auto* row = rows[index];
+	auto& route = routes.getReference(index);
+
+	route.source = (ModulationMatrix::Source)(row->sourceBox.getSelectedId() - 1);
+	route.target = (ModulationMatrix::Target)(row->targetBox.getSelectedId() - 1);
+	route.depth = (float)row->depthSlider.getValue();
+	route.offset = (float)row->offsetSlider.getValue();
+	route.smoothing = (float)row->smoothingSlider.getValue();
+
+	matrix.setRoutes(routes);
+
+	if (onRoutesChanged != nullptr)
+		onRoutesChanged();
+}
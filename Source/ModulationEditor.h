@@ -0,0 +1,59 @@
+/*
+  ==============================================================================
+
+    ModulationEditor.h
+    Created: 17 Oct 2026 11:20:51pm
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "ModulationMatrix.h"
+#include <functional>
+
+//==============================================================================
+/**
+	Edits a ModulationMatrix's routes: one row per route with its source,
+	target, depth, offset and smoothing. Every edit goes straight to the
+	matrix, so the visuals follow the slider while it's still moving.
+*/
+class ModulationEditor : public Component
+{
+public:
+	explicit ModulationEditor(ModulationMatrix& matrixToEdit);
+
+	// Called after every edit, e.g. to save the routes.
+	std::function<void()> onRoutesChanged;
+
+	void resized() override;
+
+	enum { rowHeight = 25 };
+
+private:
+	struct RouteRow : public Component
+	{
+		RouteRow();
+		void resized() override;
+
+		ComboBox sourceBox, targetBox;
+		Slider depthSlider, offsetSlider, smoothingSlider;
+		TextButton removeButton{ "X" };
+	};
+
+	void rebuildRows();
+	void addRoute();
+	void removeRoute(int index);
+	void rowEdited(int index);
+
+	ModulationMatrix& matrix;
+	Array<ModulationMatrix::Route> routes;
+
+	OwnedArray<RouteRow> rows;
+	OwnedArray<Label> headings;
+	TextButton addButton{ "Add route" };
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ModulationEditor)
+};
@@ -0,0 +1,225 @@
+/*
+  ==============================================================================
+
+    ModulationMatrix.cpp
+    Created: 17 Oct 2026 11:02:14pm
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#include "ModulationMatrix.h"
+
+namespace
+{
+	const char* const sourceNames[ModulationMatrix::numSources] =
+		{ "Bass", "Mids", "Highs", "Level", "Onsets", "Beat phase", "Beat pulse", "LFO 20 s", "LFO 2 s",
+		  "Drums stem", "Bass stem", "Melody stem", "Vocals stem" };
+
+	const char* const targetNames[ModulationMatrix::numTargets] =
+		{ "Zoom", "Speed", "Wiggle", "Saturation", "Brightness", "BG Hue", "BG Speed", "BG Saturation", "BG Val" };
+
+	// Same ranges as the player's sliders.
+	const float targetRanges[ModulationMatrix::numTargets][2] =
+		{ { 1.0f, 3.0f }, { 0.0f, 0.5f }, { 0.0f, 10.0f }, { 0.0f, 1.0f }, { 0.0f, 1.0f },
+		  { 0.0f, 360.0f }, { 0.0f, 250.0f }, { 0.0f, 1.0f }, { 0.0f, 1.0f } };
+
+	// The renderer's own defaults, until the player sets its sliders.
+	const float defaultBaseValues[ModulationMatrix::numTargets] =
+		{ 2.5f, 0.0f, 4.0f, 0.5f, 1.0f, 0.0f, 125.0f, 0.75f, 1.0f };
+
+	const double slowLfoPeriod = 20.0, fastLfoPeriod = 2.0;
+
+	double advancePhase(double phase, double elapsedSeconds, double period) noexcept
+	{
+		return std::fmod(phase + elapsedSeconds / period, 1.0);
+	}
+}
+
+ModulationMatrix::ModulationMatrix()
+{
+	for (int t = 0; t < numTargets; ++t)
+		settings.baseValues[t] = defaultBaseValues[t];
+
+	publish();
+}
+
+String ModulationMatrix::getSourceName(Source source)
+{
+	return isPositiveAndBelow((int)source, (int)numSources) ? sourceNames[source] : "";
+}
+
+String ModulationMatrix::getTargetName(Target target)
+{
+	return isPositiveAndBelow((int)target, (int)numTargets) ? targetNames[target] : "";
+}
+
+Range<float> ModulationMatrix::getTargetRange(Target target) noexcept
+{
+	return { targetRanges[target][0], targetRanges[target][1] };
+}
+
+void ModulationMatrix::setBaseValue(Target target, float value)
+{
+	if (settings.baseValues[target] == value)
+		return;
+
+	settings.baseValues[target] = value;
+	publish();
+}
+
+void ModulationMatrix::setRoutes(const Array<Route>& newRoutes)
+{
+	settings.numRoutes = jmin((int)maxRoutes, newRoutes.size());
+
+	for (int r = 0; r < settings.numRoutes; ++r)
+	{
+		auto& route = settings.routes[r];
+		route = newRoutes[r];
+
+		auto isTaken = [this, &route, r]
+		{
+			for (int i = 0; i < r; ++i)
+				if (settings.routes[i].id == route.id)
+					return true;
+
+			return false;
+		};
+
+		if (route.id <= 0 || isTaken())
+			route.id = ++lastRouteId;
+	}
+
+	publish();
+}
+
+Array<ModulationMatrix::Route> ModulationMatrix::getRoutes() const
+{
+	return Array<Route>(settings.routes, settings.numRoutes);
+}
+
+void ModulationMatrix::publish()
+{
+	// The slot may hold any older snapshot, so it's always written in full.
+	snapshots.getWriteBuffer() = settings;
+	snapshots.publish();
+}
+
+String ModulationMatrix::routesToString(const Array<Route>& routes)
+{
+	StringArray lines;
+
+	for (auto& route : routes)
+		lines.add(String((int)route.source) + " " + String((int)route.target) + " " + String(route.depth)
+			+ " " + String(route.offset) + " " + String(route.smoothing));
+
+	return lines.joinIntoString(";");
+}
+
+Array<ModulationMatrix::Route> ModulationMatrix::routesFromString(const String& text)
+{
+	Array<Route> routes;
+
+	for (auto& line : StringArray::fromTokens(text, ";", ""))
+	{
+		auto fields = StringArray::fromTokens(line, false);
+
+		if (fields.size() != 5)
+			continue;
+
+		auto source = fields[0].getIntValue();
+		auto target = fields[1].getIntValue();
+
+		if (!isPositiveAndBelow(source, (int)numSources) || !isPositiveAndBelow(target, (int)numTargets))
+			continue;
+
+		Route route;
+		route.source = (Source)source;
+		route.target = (Target)target;
+		route.depth = fields[2].getFloatValue();
+		route.offset = fields[3].getFloatValue();
+		route.smoothing = jmax(0.0f, fields[4].getFloatValue());
+		routes.add(route);
+	}
+
+	return routes;
+}
+
+void ModulationMatrix::followRoutes(const Settings& current) noexcept
+{
+	// The routes have been added to, removed or reordered: move each one's
+	// smoothed value to its new index. A new route starts from 0, as every
+	// route does at startup.
+	float previousValues[maxRoutes];
+	int previousIds[maxRoutes];
+	std::copy(std::begin(smoothedRoutes), std::end(smoothedRoutes), previousValues);
+	std::copy(std::begin(smoothedRouteIds), std::end(smoothedRouteIds), previousIds);
+
+	for (int r = 0; r < maxRoutes; ++r)
+	{
+		smoothedRouteIds[r] = r < current.numRoutes ? current.routes[r].id : 0;
+		smoothedRoutes[r] = 0.0f;
+
+		for (int i = 0; i < maxRoutes; ++i)
+		{
+			if (smoothedRouteIds[r] != 0 && previousIds[i] == smoothedRouteIds[r])
+			{
+				smoothedRoutes[r] = previousValues[i];
+				break;
+			}
+		}
+	}
+}
+
+void ModulationMatrix::process(float* sourceValues, double elapsedSeconds, float* targetValues) noexcept
+{
+	const auto& current = snapshots.read();
+
+	slowLfoPhase = advancePhase(slowLfoPhase, elapsedSeconds, slowLfoPeriod);
+	fastLfoPhase = advancePhase(fastLfoPhase, elapsedSeconds, fastLfoPeriod);
+	sourceValues[slowLfo] = 0.5f + 0.5f * (float)std::sin(MathConstants<double>::twoPi * slowLfoPhase);
+	sourceValues[fastLfo] = 0.5f + 0.5f * (float)std::sin(MathConstants<double>::twoPi * fastLfoPhase);
+
+	for (int t = 0; t < numTargets; ++t)
+		targetValues[t] = current.baseValues[t];
+
+	for (int r = 0; r < current.numRoutes; ++r)
+	{
+		if (smoothedRouteIds[r] != current.routes[r].id)
+		{
+			followRoutes(current);
+			break;
+		}
+	}
+
+	for (int r = 0; r < current.numRoutes; ++r)
+	{
+		const auto& route = current.routes[r];
+		auto value = sourceValues[route.source] * route.depth + route.offset;
+
+		// Smoothed per route, so a fast and a slow route to one target keep their own pace.
+		if (route.smoothing > 0.0f)
+			smoothedRoutes[r] += (value - smoothedRoutes[r]) * (float)(1.0 - std::exp(-elapsedSeconds / route.smoothing));
+		else
+			smoothedRoutes[r] = value;
+
+		targetValues[route.target] += smoothedRoutes[r] * getTargetRange(route.target).getLength();
+	}
+
+	for (int t = 0; t < numTargets; ++t)
+	{
+		auto range = getTargetRange((Target)t);
+
+		if (t == bgHue)
+		{
+			targetValues[t] = std::fmod(targetValues[t], range.getEnd());
+
+			if (targetValues[t] < 0.0f)
+				targetValues[t] += range.getEnd();
+		}
+		else
+		{
+			targetValues[t] = range.clipValue(targetValues[t]);
+		}
+	}
+}
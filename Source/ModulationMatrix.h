@@ -0,0 +1,115 @@
+/*
+  ==============================================================================
+
+    ModulationMatrix.h
+    Created: 17 Oct 2026 11:02:14pm
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "SnapshotBuffer.h"
+
+//==============================================================================
+/**
+	Routes audio features and LFOs onto the renderer's parameters.
+
+	Each target starts from the value the player's slider sets. Every route adds
+	(source * depth + offset) times the target's range to it, after an optional
+	one-pole smoothing, and the sum is clamped to the range (hue wraps instead).
+	Sources all run 0..1, so a depth of 1 sweeps the whole range.
+
+	The message thread edits the base values and routes; they reach the render
+	thread through a SnapshotBuffer, and process() evaluates the lot once per
+	frame. That's a few multiply-adds per route, so the number of routes makes
+	no difference worth measuring.
+*/
+class ModulationMatrix
+{
+public:
+	enum Source
+	{
+		bass, mids, highs,		// Band energy, thirds of the spectral bands
+		level,					// RMS
+		onset,					// Onset strength
+		beatPhase,				// Ramps 0..1 over each beat
+		beatPulse,				// 1 on the beat, falling away by the next
+		slowLfo, fastLfo,		// Sines, 20 s and 2 s
+		drumsStem, bassStem,	// Each stem's level, in StemSet order, while
+		melodyStem, vocalsStem,	// a stem set is playing
+		numSources
+	};
+
+	enum Target
+	{
+		zoom, spinSpeed, wiggle,
+		saturation, brightness,
+		bgHue, bgSpeed, bgSaturation, bgBrightness,
+		numTargets
+	};
+
+	enum { maxRoutes = 16 };
+
+	struct Route
+	{
+		Source source = bass;
+		Target target = zoom;
+		float depth = 0.5f;			// Fraction of the target's range with the source at 1
+		float offset = 0.0f;		// Added to source * depth, same units
+		float smoothing = 0.0f;		// Time constant in seconds, 0 for none
+		int id = 0;					// Given out by setRoutes(); the route's smoothing follows it
+	};
+
+	ModulationMatrix();
+
+	static String getSourceName(Source source);
+	static String getTargetName(Target target);
+	static Range<float> getTargetRange(Target target) noexcept;
+
+	/** Message thread. */
+	void setBaseValue(Target target, float value);
+	float getBaseValue(Target target) const noexcept	{ return settings.baseValues[target]; }
+
+	/** Message thread: anything past maxRoutes is dropped. A route without an
+		id, or with one an earlier route has, is given a new one; keep the ids
+		from getRoutes() so edited routes carry on smoothing from where they were. */
+	void setRoutes(const Array<Route>& newRoutes);
+	Array<Route> getRoutes() const;
+
+	/** For saving routes in the settings file, and reading them back. Unreadable
+		routes are skipped. */
+	static String routesToString(const Array<Route>& routes);
+	static Array<Route> routesFromString(const String& text);
+
+	/** Render thread: fills in the LFOs in sourceValues, then works out every
+		target's value for this frame. elapsedSeconds is the time since the last
+		call. Never blocks or allocates. */
+	void process(float* sourceValues, double elapsedSeconds, float* targetValues) noexcept;
+
+private:
+	void publish();
+
+	struct Settings
+	{
+		float baseValues[numTargets] = {};
+		Route routes[maxRoutes];
+		int numRoutes = 0;
+	};
+
+	void followRoutes(const Settings& current) noexcept;
+
+	// Message thread's copy; every change publishes the whole thing.
+	Settings settings;
+	SnapshotBuffer<Settings> snapshots;
+	int lastRouteId = 0;
+
+	// Render thread only. Each route's smoothed value is kept with its id, so it moves with the route.
+	float smoothedRoutes[maxRoutes] = {};
+	int smoothedRouteIds[maxRoutes] = {};
+	double slowLfoPhase = 0.0, fastLfoPhase = 0.0;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ModulationMatrix)
+};
@@ -0,0 +1,440 @@
+/*
+  ==============================================================================
+
+    Mp3SeekIndex.cpp
+    Created: 18 Oct 2026 2:04:19am
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#include "Mp3SeekIndex.h"
+
+namespace
+{
+	const int warmUpFrames = 2;			// Decoded ahead of the target, for the filterbanks' overlap
+	const int maxEntryDistance = 64;	// About 1.5 s of frames to decode before giving up on a jump
+	const float matchTolerance = 1.0e-3f;	// Covers the decode cache's 16-bit rounding
+	const float minProbeLevel = 0.01f;
+
+	struct FrameHeader
+	{
+		int version;			// 0 for MPEG-1, 1 for MPEG-2, 2 for MPEG-2.5
+		int layer;
+		int sampleRate, numChannels;
+		int samplesPerFrame, frameBytes, sideInfoBytes;
+		bool hasCrc;
+	};
+
+	bool parseHeader(const uint8* p, FrameHeader& header) noexcept
+	{
+		if (p[0] != 0xff || (p[1] & 0xe0) != 0xe0)
+			return false;
+
+		auto versionBits = (p[1] >> 3) & 3, layerBits = (p[1] >> 1) & 3;
+		auto bitrateIndex = p[2] >> 4, rateIndex = (p[2] >> 2) & 3;
+
+		if (versionBits == 1 || layerBits == 0 || bitrateIndex == 0 || bitrateIndex == 15 || rateIndex == 3)
+			return false;
+
+		static const int bitrates[2][3][15] =
+		{
+			{ { 0, 32, 64, 96, 128, 160, 192, 224, 256, 288, 320, 352, 384, 416, 448 },
+			  { 0, 32, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384 },
+			  { 0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320 } },
+			{ { 0, 32, 48, 56, 64, 80, 96, 112, 128, 144, 160, 176, 192, 224, 256 },
+			  { 0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160 },
+			  { 0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160 } }
+		};
+		static const int sampleRates[] = { 44100, 48000, 32000 };
+
+		header.version = versionBits == 3 ? 0 : (versionBits == 2 ? 1 : 2);
+		header.layer = 4 - layerBits;
+		header.sampleRate = sampleRates[rateIndex] >> header.version;
+		header.numChannels = (p[3] >> 6) == 3 ? 1 : 2;
+		header.hasCrc = (p[1] & 1) == 0;
+
+		auto bitrate = bitrates[header.version == 0 ? 0 : 1][header.layer - 1][bitrateIndex] * 1000;
+		auto padding = (p[2] >> 1) & 1;
+
+		if (header.layer == 1)
+		{
+			header.samplesPerFrame = 384;
+			header.frameBytes = (12 * bitrate / header.sampleRate + padding) * 4;
+		}
+		else
+		{
+			header.samplesPerFrame = header.layer == 3 && header.version != 0 ? 576 : 1152;
+			header.frameBytes = header.samplesPerFrame / 8 * bitrate / header.sampleRate + padding;
+		}
+
+		header.sideInfoBytes = header.layer != 3 ? 0
+			: header.version == 0 ? (header.numChannels == 1 ? 17 : 32) : (header.numChannels == 1 ? 9 : 17);
+
+		return header.frameBytes > 4 + (header.hasCrc ? 2 : 0) + header.sideInfoBytes;
+	}
+
+	bool isSameStream(const FrameHeader& a, const FrameHeader& b) noexcept
+	{
+		return a.version == b.version && a.layer == b.layer && a.sampleRate == b.sampleRate;
+	}
+
+	// The Xing/Info or VBRI frame some encoders put first, holding the length and
+	// a rough seek table instead of audio.
+	bool isTagFrame(const uint8* p, const FrameHeader& header) noexcept
+	{
+		auto xing = p + 4 + (header.hasCrc ? 2 : 0) + header.sideInfoBytes;
+		auto vbri = p + 36;
+
+		return (header.frameBytes >= xing - p + 4 && (memcmp(xing, "Xing", 4) == 0 || memcmp(xing, "Info", 4) == 0))
+			|| (header.frameBytes >= 40 && memcmp(vbri, "VBRI", 4) == 0);
+	}
+
+	float getPeakDifference(const HeapBlock<float>* a, int aOffset, const HeapBlock<float>* b, int bOffset, int numChannels, int numSamples)
+	{
+		auto peak = 0.0f;
+
+		for (int ch = 0; ch < numChannels; ++ch)
+			for (int i = 0; i < numSamples; ++i)
+				peak = jmax(peak, std::abs(a[ch][aOffset + i] - b[ch][bOffset + i]));
+
+		return peak;
+	}
+}
+
+//==============================================================================
+Mp3SeekIndex::Mp3SeekIndex(const File& mp3File)
+	: mappedFile(mp3File, MemoryMappedFile::readOnly)
+{
+}
+
+std::unique_ptr<Mp3SeekIndex> Mp3SeekIndex::build(const File& mp3File)
+{
+	std::unique_ptr<Mp3SeekIndex> index(new Mp3SeekIndex(mp3File));
+	auto* data = static_cast<const uint8*>(index->mappedFile.getData());
+	auto size = index->mappedFile.getSize();
+
+	// Offsets are stored in 32 bits, which is a few hours of MP3.
+	if (data == nullptr || size < 4 || size > 0xffffffffu)
+		return nullptr;
+
+	size_t position = 0;
+
+	// An ID3v2 tag: 10 bytes, then a size in 7-bit bytes, then maybe a footer.
+	if (size >= 10 && memcmp(data, "ID3", 3) == 0)
+		position = 10 + (size_t)(((data[6] & 0x7f) << 21) | ((data[7] & 0x7f) << 14) | ((data[8] & 0x7f) << 7) | (data[9] & 0x7f))
+			+ ((data[5] & 0x10) != 0 ? 10 : 0);
+
+	FrameHeader first;
+	auto locked = false;
+	uint32 payloadBytes = 0;
+
+	while (position + 4 <= size)
+	{
+		FrameHeader header;
+
+		if (!parseHeader(data + position, header) || position + (size_t)header.frameBytes > size
+			|| (locked && !isSameStream(header, first)))
+		{
+			++position;
+			continue;
+		}
+
+		// Don't believe the first header until the next one agrees; four bytes of
+		// album art can look like a frame header.
+		if (!locked)
+		{
+			FrameHeader next;
+			auto nextPosition = position + (size_t)header.frameBytes;
+
+			if (nextPosition + 4 <= size && (!parseHeader(data + nextPosition, next) || !isSameStream(header, next)))
+			{
+				++position;
+				continue;
+			}
+
+			first = header;
+			locked = true;
+
+			index->sampleRate = header.sampleRate;
+			index->numChannels = header.numChannels;
+			index->samplesPerFrame = header.samplesPerFrame;
+
+			if (isTagFrame(data + position, header))
+			{
+				index->hasTagFrame = true;
+				position += (size_t)header.frameBytes;
+				continue;
+			}
+		}
+
+		Frame frame;
+		frame.offset = (uint32)position;
+		frame.payloadStart = payloadBytes;
+		frame.mainDataBegin = 0;
+
+		auto sideInfo = data + position + 4 + (header.hasCrc ? 2 : 0);
+
+		if (header.layer == 3)
+			frame.mainDataBegin = header.version == 0 ? (uint32)((sideInfo[0] << 1) | (sideInfo[1] >> 7)) : (uint32)sideInfo[0];
+
+		index->frames.push_back(frame);
+		payloadBytes += (uint32)(header.frameBytes - 4 - (header.hasCrc ? 2 : 0) - header.sideInfoBytes);
+		position += (size_t)header.frameBytes;
+		index->endOffset = (uint32)position;
+	}
+
+	if (index->frames.size() < (size_t)(warmUpFrames + 1))
+		return nullptr;
+
+	return index;
+}
+
+//==============================================================================
+int Mp3SeekIndex::findEntryFrame(int targetFrame, bool allowUnreadyEntry) const noexcept
+{
+	if (targetFrame < warmUpFrames)
+		return 0;
+
+	// Each frame from the entry on must find all its data from the entry's data on.
+	auto earliestData = getMainDataStart(targetFrame);
+
+	for (int entry = targetFrame - 1; entry >= jmax(0, targetFrame - maxEntryDistance); --entry)
+	{
+		// The file's own start needs nothing before it.
+		if (entry == 0)
+			return 0;
+
+		if (entry <= targetFrame - warmUpFrames && earliestData >= (int64)frames[(size_t)entry].payloadStart
+			&& (allowUnreadyEntry || frames[(size_t)entry].mainDataBegin == 0))
+			return entry;
+
+		earliestData = jmin(earliestData, getMainDataStart(entry));
+	}
+
+	return -1;
+}
+
+AudioFormatReader* Mp3SeekIndex::createDecoderAt(int entryFrame) const
+{
+	auto offset = frames[(size_t)entryFrame].offset;
+	auto* start = static_cast<const char*>(mappedFile.getData()) + offset;
+
+	MP3AudioFormat format;
+	return format.createReaderFor(new MemoryInputStream(start, endOffset - offset, false), true);
+}
+
+AudioFormatReader* Mp3SeekIndex::createDecoder(int64 startSample, int64& firstSample) const
+{
+	if (!aligned)
+		return nullptr;
+
+	auto target = (int)jlimit((int64)0, (int64)frames.size() - 1, startSample / samplesPerFrame - leadingFrames);
+	auto entry = findEntryFrame(target, unreadyEntriesChecked);
+
+	if (entry < 0)
+		return nullptr;
+
+	auto* decoder = createDecoderAt(entry);
+
+	if (decoder == nullptr)
+		return nullptr;
+
+	auto skipsEntry = frames[(size_t)entry].mainDataBegin > 0 && !unreadyEntryIsPlayed;
+	firstSample = (int64)(entry + leadingFrames + (skipsEntry ? 1 : 0)) * samplesPerFrame;
+	return decoder;
+}
+
+//==============================================================================
+int Mp3SeekIndex::findDecodedShift(int entryFrame, int targetFrame, const ReferenceReader& reference) const
+{
+	// Decode from the entry through the frame after the target, and fetch the
+	// target and the frame after it from the reference. The decoder's block m
+	// matches reference frame r for shift = (r - target) + (target - entry - m):
+	// frames it played before the first indexed one, plus the entry if it skipped it.
+	std::unique_ptr<AudioFormatReader> decoder(createDecoderAt(entryFrame));
+
+	if (decoder == nullptr)
+		return -1;
+
+	auto numDecoded = (targetFrame - entryFrame + 1) * samplesPerFrame;
+	HeapBlock<float> decoded[2], expected[2];
+	float* decodedChannels[2];
+	float* expectedChannels[2];
+
+	for (int ch = 0; ch < 2; ++ch)
+	{
+		decoded[ch].calloc((size_t)numDecoded);
+		expected[ch].calloc((size_t)(2 * samplesPerFrame));
+		decodedChannels[ch] = decoded[ch];
+		expectedChannels[ch] = expected[ch];
+	}
+
+	decoder->readSamples(reinterpret_cast<int**>(decodedChannels), numChannels, 0, 0, numDecoded);
+	reference(expectedChannels, numChannels, (int64)targetFrame * samplesPerFrame, 2 * samplesPerFrame);
+
+	auto shift = -1;
+
+	for (int r = 0; r < 2; ++r)
+	{
+		auto level = 0.0f;
+
+		for (int ch = 0; ch < numChannels; ++ch)
+			level = jmax(level, FloatVectorOperations::findMaximum(expected[ch] + r * samplesPerFrame, samplesPerFrame),
+						 -FloatVectorOperations::findMinimum(expected[ch] + r * samplesPerFrame, samplesPerFrame));
+
+		// Silence matches anything.
+		if (level < minProbeLevel)
+			return -1;
+
+		for (int skipped = 0; skipped < 2; ++skipped)
+		{
+			auto block = targetFrame - entryFrame - skipped;
+
+			if (getPeakDifference(decoded, block * samplesPerFrame, expected, r * samplesPerFrame, numChannels, samplesPerFrame) < matchTolerance)
+			{
+				// Two readings that both fit mean the music repeats frame to frame; trust neither.
+				if (shift >= 0 && shift != r + skipped)
+					return -1;
+
+				shift = r + skipped;
+			}
+		}
+	}
+
+	return shift;
+}
+
+bool Mp3SeekIndex::alignWith(const ReferenceReader& reference, int64 numReferenceSamples)
+{
+	// Every couple of seconds through the reference until a jump checks out,
+	// leaving room for the frame the decoder may play first.
+	auto lastTarget = (int)jmin((int64)frames.size() - 2, numReferenceSamples / samplesPerFrame - 3);
+	auto step = jmax(1, roundToInt(2.0 * sampleRate / samplesPerFrame));
+
+	for (int target = warmUpFrames + 1; target <= lastTarget && !aligned; target += step)
+	{
+		auto entry = findEntryFrame(target, false);
+
+		if (entry < 0)
+			continue;
+
+		// A clean entry is always played, so this is just the leading frames.
+		auto shift = findDecodedShift(entry, target, reference);
+
+		if (shift == 0 || (shift == 1 && hasTagFrame))
+		{
+			leadingFrames = shift;
+			aligned = true;
+		}
+	}
+
+	if (!aligned)
+		return false;
+
+	// Entries whose data reaches back before them are much more common, so find
+	// out what the decoder does with one too. Until then jumps only use clean ones.
+	for (int target = warmUpFrames + 1; target <= lastTarget && !unreadyEntriesChecked; target += step)
+	{
+		auto entry = findEntryFrame(target, true);
+
+		if (entry <= 0 || frames[(size_t)entry].mainDataBegin == 0)
+			continue;
+
+		auto shift = findDecodedShift(entry, target, reference) - leadingFrames;
+
+		if (shift == 0 || shift == 1)
+		{
+			unreadyEntryIsPlayed = shift == 0;
+			unreadyEntriesChecked = true;
+		}
+	}
+
+	return true;
+}
+
+//==============================================================================
+SeekableMp3Reader::SeekableMp3Reader(std::shared_ptr<const Mp3SeekIndex> indexToUse)
+	: AudioFormatReader(nullptr, "MP3 with seek index"),
+	  index(std::move(indexToUse))
+{
+	sampleRate = index->getSampleRate();
+	numChannels = (unsigned int)index->getNumChannels();
+	lengthInSamples = index->getLengthInSamples();
+	bitsPerSample = 32;
+	usesFloatingPointData = true;
+
+	scratch.allocate((size_t)(2 * scratchSize), false);
+}
+
+bool SeekableMp3Reader::seek(int64 sample)
+{
+	int64 firstSample = 0;
+	decoder.reset(index->createDecoder(sample, firstSample));
+
+	if (decoder == nullptr)
+		return false;
+
+	nextSample = firstSample;
+	decoderPosition = 0;
+
+	// Decode up to the target and throw it away.
+	float* scratchChannels[] = { scratch.get(), scratch.get() + scratchSize };
+
+	while (nextSample < sample)
+	{
+		auto num = (int)jmin((int64)scratchSize, sample - nextSample);
+
+		if (!decoder->readSamples(reinterpret_cast<int**>(scratchChannels), 2, 0, decoderPosition, num))
+			return false;
+
+		nextSample += num;
+		decoderPosition += num;
+	}
+
+	return true;
+}
+
+bool SeekableMp3Reader::readSamples(int** destSamples, int numDestChannels, int startOffsetInDestBuffer,
+									int64 startSampleInFile, int numSamples)
+{
+	clearSamplesBeyondAvailableLength(destSamples, numDestChannels, startOffsetInDestBuffer,
+									  startSampleInFile, numSamples, lengthInSamples);
+
+	if (numSamples <= 0)
+		return true;
+
+	if (decoder == nullptr || startSampleInFile != nextSample)
+	{
+		if (!seek(startSampleInFile))
+		{
+			decoder.reset();
+
+			for (int ch = 0; ch < numDestChannels; ++ch)
+				if (destSamples[ch] != nullptr)
+					zeromem(destSamples[ch] + startOffsetInDestBuffer, sizeof(float) * (size_t)numSamples);
+
+			return false;
+		}
+	}
+
+	// A jump into the silence some decoders play before the first frame.
+	auto numSilent = (int)jlimit((int64)0, (int64)numSamples, nextSample - startSampleInFile);
+
+	for (int ch = 0; ch < numDestChannels && numSilent > 0; ++ch)
+		if (destSamples[ch] != nullptr)
+			zeromem(destSamples[ch] + startOffsetInDestBuffer, sizeof(float) * (size_t)numSilent);
+
+	if (numSilent == numSamples)
+	{
+		// Nothing decoded; the next read still starts from the same place.
+		decoder.reset();
+		return true;
+	}
+
+	auto ok = decoder->readSamples(destSamples, numDestChannels, startOffsetInDestBuffer + numSilent,
+								   decoderPosition, numSamples - numSilent);
+	decoderPosition += numSamples - numSilent;
+	nextSample = startSampleInFile + numSamples;
+	return ok;
+}
@@ -0,0 +1,119 @@
+/*
+  ==============================================================================
+
+    Mp3SeekIndex.h
+    Created: 18 Oct 2026 2:04:19am
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <functional>
+#include <vector>
+
+//==============================================================================
+/**
+	Where every frame of an MP3 starts, so playback can jump anywhere in it
+	without the decoder scanning there from the top.
+
+	Building it reads only the frame headers and, for layer III, how far back
+	into earlier frames each frame's data starts (the bit reservoir), so it
+	takes a few milliseconds. A jump then starts a fresh decoder on the
+	memory-mapped file a few frames before the target: at a frame after which
+	every frame's data is in the stream, so the decoder's state is rebuilt by
+	the time it reaches the target.
+
+	The decoder's own sample numbering has to be matched before any of that is
+	trusted, e.g. whether it plays the VBR header frame as silence. alignWith()
+	does that against the same file decoded from the start; until it succeeds,
+	createDecoder() gives nothing.
+*/
+class Mp3SeekIndex
+{
+public:
+	/** nullptr if the file can't be mapped or holds no MPEG audio frames. */
+	static std::unique_ptr<Mp3SeekIndex> build(const File& mp3File);
+
+	/** Reads numSamples of the file decoded from the start, at startSample, as floats. */
+	using ReferenceReader = std::function<void(float* const* dest, int numChannels, int64 startSample, int numSamples)>;
+
+	/** Works out the decoder's numbering by decoding a few jumps and comparing them
+		with the reference, which has to hold numReferenceSamples. False if no
+		jump could be matched, e.g. on a silent reference. */
+	bool alignWith(const ReferenceReader& reference, int64 numReferenceSamples);
+
+	/** A decoder that's been started at or before startSample, whose sample 0 is
+		firstSample in the whole file. Caller owns it. nullptr before alignWith()
+		succeeds, or if there's nowhere clean to start near enough. */
+	AudioFormatReader* createDecoder(int64 startSample, int64& firstSample) const;
+
+	double getSampleRate() const noexcept			{ return sampleRate; }
+	int getNumChannels() const noexcept				{ return numChannels; }
+	int getSamplesPerFrame() const noexcept			{ return samplesPerFrame; }
+	int getNumFrames() const noexcept				{ return (int)frames.size(); }
+	int64 getLengthInSamples() const noexcept		{ return (int64)(getNumFrames() + leadingFrames) * samplesPerFrame; }
+	bool isAligned() const noexcept					{ return aligned; }
+
+private:
+	explicit Mp3SeekIndex(const File& mp3File);
+
+	struct Frame
+	{
+		uint32 offset;			// Of the header, in the file
+		uint32 payloadStart;	// Where its data bytes sit among all the frames' data bytes...
+		uint32 mainDataBegin;	// ...and how far before that its own data starts, from the side info
+	};
+
+	int64 getMainDataStart(int frame) const noexcept	{ return (int64)frames[(size_t)frame].payloadStart - frames[(size_t)frame].mainDataBegin; }
+	int findEntryFrame(int targetFrame, bool allowUnreadyEntry) const noexcept;
+	AudioFormatReader* createDecoderAt(int entryFrame) const;
+	int findDecodedShift(int entryFrame, int targetFrame, const ReferenceReader& reference) const;
+
+	MemoryMappedFile mappedFile;
+	std::vector<Frame> frames;
+	uint32 endOffset = 0;
+
+	double sampleRate = 0.0;
+	int numChannels = 0, samplesPerFrame = 0;
+	bool hasTagFrame = false;
+
+	// Found by alignWith(): frames the decoder plays before the first indexed one,
+	// and whether it makes a frame of output from an entry frame whose data
+	// reaches back before the stream or just skips it.
+	int leadingFrames = 0;
+	bool unreadyEntryIsPlayed = false, unreadyEntriesChecked = false;
+	bool aligned = false;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Mp3SeekIndex)
+};
+
+//==============================================================================
+/**
+	Streams an MP3 through JUCE's decoder, jumping with an aligned Mp3SeekIndex:
+	every seek starts a new decoder near the target rather than asking the old
+	one to scan there. A seek costs one decoder and a handful of frames.
+*/
+class SeekableMp3Reader : public AudioFormatReader
+{
+public:
+	explicit SeekableMp3Reader(std::shared_ptr<const Mp3SeekIndex> indexToUse);
+
+	bool readSamples(int** destSamples, int numDestChannels, int startOffsetInDestBuffer,
+					 int64 startSampleInFile, int numSamples) override;
+
+private:
+	bool seek(int64 sample);
+
+	std::shared_ptr<const Mp3SeekIndex> index;
+	std::unique_ptr<AudioFormatReader> decoder;
+	int64 nextSample = -1;		// What the decoder gives next, in the whole file...
+	int64 decoderPosition = 0;	// ...and in its own numbering
+
+	enum { scratchSize = 4096 };
+	HeapBlock<float> scratch;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SeekableMp3Reader)
+};
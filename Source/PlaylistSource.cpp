@@ -0,0 +1,454 @@
+/*
+  ==============================================================================
+
+    PlaylistSource.cpp
+    Created: 17 Oct 2026 4:12:53pm
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#include "PlaylistSource.h"
+
+PlaylistSource::Track::Track(int trackId, const File& audioFile, AudioFormatReaderSource* readerSourceToUse,
+							 ReadAheadSource* readAheadToUse)
+	: id(trackId),
+	  file(audioFile),
+	  readerSource(readerSourceToUse),
+	  readAhead(readAheadToUse)
+{
+	jassert(readerSource != nullptr);
+}
+
+PositionableAudioSource& PlaylistSource::Track::getSource() const noexcept
+{
+	if (readAhead != nullptr)
+		return *readAhead;
+
+	return *readerSource;
+}
+
+AudioSource& PlaylistSource::Track::getOutput() const noexcept
+{
+	if (resampler != nullptr)
+		return *resampler;
+
+	return getSource();
+}
+
+//==============================================================================
+PlaylistSource::PlaylistSource()
+{
+}
+
+PlaylistSource::~PlaylistSource()
+{
+	deleteTrack(current.exchange(nullptr));
+	deleteTrack(next.exchange(nullptr));
+	deleteTrack(incoming.exchange(nullptr));
+	deleteTrack(loaded.exchange(nullptr));
+	releaseFinishedTracks();
+}
+
+void PlaylistSource::loadTrack(std::unique_ptr<Track> newTrack, int64 startPosition)
+{
+	jassert(newTrack != nullptr);
+
+	if (isPrepared)
+	{
+		prepareTrack(*newTrack);
+		seekTrack(*newTrack, startPosition);
+		wakeDecoder(*newTrack);
+	}
+
+	// A seek meant for the outgoing track mustn't land on this one.
+	pendingSeek = -1;
+	loadedTrackId = newTrack->id;
+
+	// Whatever was waiting here the audio thread never saw, so it's ours to delete.
+	deleteTrack(loaded.exchange(newTrack.release()));
+}
+
+void PlaylistSource::replaceTrack(std::unique_ptr<Track> newTrack, int64 startPosition)
+{
+	jassert(newTrack != nullptr);
+
+	newTrack->replacesCurrent = true;
+	newTrack->seekTarget = startPosition;
+
+	if (isPrepared)
+	{
+		// Its read-ahead starts at the seek, or near where the old one is, in which
+		// case the audio thread keeps it following from there.
+		newTrack->ratio = newTrack->readerSource->getAudioFormatReader()->sampleRate / deviceSampleRate;
+		newTrack->position = startPosition >= 0 ? startPosition : getNextReadPosition();
+		prepareTrack(*newTrack);
+	}
+
+	// An older seek mustn't land on the new track after it's taken over.
+	if (startPosition >= 0)
+		pendingSeek = -1;
+
+	loadedTrackId = newTrack->id;
+	deleteTrack(loaded.exchange(newTrack.release()));
+}
+
+void PlaylistSource::takeLoadedTrack() noexcept
+{
+	auto* track = loaded.exchange(nullptr);
+
+	if (track == nullptr)
+		return;
+
+	if (track->replacesCurrent)
+	{
+		auto* old = current.load();
+
+		if (old == nullptr || old->id != track->id)
+		{
+			// The playlist has moved on; there's nothing left for it to replace.
+			auto id = track->id;
+			loadedTrackId.compare_exchange_strong(id, 0);
+			finishTrack(track);
+			return;
+		}
+
+		auto* readAhead = track->readAhead.get();
+		auto startPosition = track->seekTarget >= 0 ? track->seekTarget : old->position.load();
+		auto filePosition = (int64)((double)startPosition * track->ratio);
+
+		if (readAhead != nullptr && !readAhead->isBufferedAt(filePosition))
+		{
+			// Not caught up yet: keep it following the old one, or waiting at its seek,
+			// and try again next block, unless another track's been loaded behind it meanwhile.
+			if (track->seekTarget < 0)
+				readAhead->followPosition(filePosition);
+
+			Track* expected = nullptr;
+
+			if (!loaded.compare_exchange_strong(expected, track))
+				finishTrack(track);
+
+			return;
+		}
+
+		seekTrack(*track, startPosition);
+	}
+
+	// Leave the id alone if another track has been loaded behind this one.
+	auto id = track->id;
+	loadedTrackId.compare_exchange_strong(id, 0);
+
+	finishTrack(current.exchange(track));
+
+	// A crossfade into the queued track may have begun; it starts over after a new
+	// track or a seek, but carries on through a replacement, which is where the old one was.
+	if (nextStarted && (!track->replacesCurrent || track->seekTarget >= 0))
+	{
+		seekTrack(*next.load(), 0);
+		nextStarted = false;
+	}
+}
+
+bool PlaylistSource::isBuffered() const noexcept
+{
+	auto* track = current.load();
+
+	if (track == nullptr || track->readAhead == nullptr)
+		return true;
+
+	return track->readAhead->isBufferedAt(track->readAhead->getNextReadPosition());
+}
+
+bool PlaylistSource::canSeekWithoutGap(int64 position) const noexcept
+{
+	// A plain load is waiting to start from wherever it's told, but a replacement
+	// taking over later would undo the seek. Tracks are only deleted on this thread.
+	if (auto* pending = loaded.load())
+		return !pending->replacesCurrent;
+
+	auto* track = current.load();
+
+	if (track == nullptr || track->readAhead == nullptr)
+		return true;
+
+	return track->readAhead->isBufferedAt((int64)((double)position * track->ratio));
+}
+
+void PlaylistSource::setNextTrack(std::unique_ptr<Track> newTrack)
+{
+	if (newTrack != nullptr && isPrepared)
+		prepareTrack(*newTrack);
+
+	// Whatever was waiting here the audio thread never saw, so it's ours to delete.
+	deleteTrack(incoming.exchange(newTrack.release()));
+}
+
+int PlaylistSource::releaseFinishedTracks()
+{
+	auto* track = finished.exchange(nullptr);
+
+	while (track != nullptr)
+	{
+		auto* nextTrack = track->nextFinished;
+		deleteTrack(track);
+		track = nextTrack;
+	}
+
+	return boundariesPassed.exchange(0);
+}
+
+int PlaylistSource::getCurrentTrackId() const noexcept
+{
+	if (auto id = loadedTrackId.load())
+		return id;
+
+	auto* track = current.load();
+	return track != nullptr ? track->id : 0;
+}
+
+int PlaylistSource::getNextTrackId() const noexcept
+{
+	if (auto* track = incoming.load())
+		return track->id;
+
+	auto* track = next.load();
+	return track != nullptr ? track->id : 0;
+}
+
+File PlaylistSource::getCurrentFile() const
+{
+	auto* track = loaded.load();
+
+	if (track == nullptr)
+		track = current.load();
+
+	return track != nullptr ? track->file : File();
+}
+
+const ReadAheadSource* PlaylistSource::getCurrentReadAhead() const noexcept
+{
+	auto* track = loaded.load();
+
+	if (track == nullptr)
+		track = current.load();
+
+	return track != nullptr ? track->readAhead.get() : nullptr;
+}
+
+//==============================================================================
+void PlaylistSource::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+	deviceSampleRate = sampleRate;
+	blockSize = samplesPerBlockExpected;
+	fadeBuffer.setSize(2, jmax(1, samplesPerBlockExpected));
+	isPrepared = true;
+
+	for (auto* track : { current.load(), next.load(), incoming.load(), loaded.load() })
+		if (track != nullptr)
+			prepareTrack(*track);
+}
+
+void PlaylistSource::releaseResources()
+{
+	isPrepared = false;
+
+	for (auto* track : { current.load(), next.load(), incoming.load(), loaded.load() })
+		if (track != nullptr)
+			track->getOutput().releaseResources();
+
+	fadeBuffer.setSize(2, 0);
+}
+
+void PlaylistSource::getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill)
+{
+	takeLoadedTrack();
+
+	auto* track = current.load();
+
+	if (track == nullptr || !isPrepared)
+	{
+		bufferToFill.clearActiveBufferRegion();
+		return;
+	}
+
+	auto seek = pendingSeek.exchange(-1);
+
+	if (seek >= 0)
+	{
+		seekTrack(*track, seek);
+
+		if (nextStarted)
+		{
+			seekTrack(*next.load(), 0);
+			nextStarted = false;
+		}
+	}
+
+	// A newly queued track replaces the old one, unless we're already fading into it.
+	if (!nextStarted && incoming.load() != nullptr)
+		finishTrack(next.exchange(incoming.exchange(nullptr)));
+
+	auto& buffer = *bufferToFill.buffer;
+	auto done = 0;
+
+	while (done < bufferToFill.numSamples)
+	{
+		auto* following = next.load();
+		auto position = track->position.load();
+
+		if (following != nullptr && position >= track->length)
+		{
+			// The boundary: the next track carries on from this very sample.
+			current.store(following);
+			next.store(incoming.exchange(nullptr));
+			finishTrack(track);
+			++boundariesPassed;
+
+			track = following;
+			nextStarted = false;
+			continue;
+		}
+
+		auto startSample = bufferToFill.startSample + done;
+		auto numSamples = bufferToFill.numSamples - done;
+
+		if (following == nullptr)
+		{
+			// Nothing queued: play on past the end and let the transport stop.
+			renderTrack(*track, buffer, startSample, numSamples);
+			break;
+		}
+
+		auto fadeLength = jmin(track->length, following->length, (int64)(crossfadeSeconds.load() * deviceSampleRate));
+		auto fadeStart = track->length - fadeLength;
+
+		if (position < fadeStart)
+		{
+			numSamples = (int)jmin((int64)numSamples, fadeStart - position);
+			renderTrack(*track, buffer, startSample, numSamples);
+		}
+		else
+		{
+			numSamples = jmin(numSamples, (int)(track->length - position), fadeBuffer.getNumSamples());
+			renderTrack(*track, buffer, startSample, numSamples);
+			renderTrack(*following, fadeBuffer, 0, numSamples);
+			nextStarted = true;
+
+			// Equal power: cos/sin keep the summed power constant through the fade.
+			const auto halfPi = MathConstants<float>::halfPi;
+			auto fadeFrom = halfPi * (float)(position - fadeStart) / (float)fadeLength;
+			auto fadeTo = halfPi * (float)(position + numSamples - fadeStart) / (float)fadeLength;
+
+			for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+			{
+				buffer.applyGainRamp(ch, startSample, numSamples, std::cos(fadeFrom), std::cos(fadeTo));
+				buffer.addFromWithRamp(ch, startSample, fadeBuffer.getReadPointer(jmin(ch, fadeBuffer.getNumChannels() - 1)),
+					numSamples, std::sin(fadeFrom), std::sin(fadeTo));
+			}
+		}
+
+		done += numSamples;
+	}
+}
+
+void PlaylistSource::setNextReadPosition(int64 newPosition)
+{
+	// The audio thread does the actual seek at the start of its next block. If
+	// we're buffering, get the decoder started on the new position already.
+	pendingSeek.store(newPosition);
+
+	if (auto* track = current.load())
+		if (track->readAhead != nullptr)
+			track->readAhead->setNextReadPosition((int64)((double)newPosition * track->ratio));
+}
+
+void PlaylistSource::wakeDecoder()
+{
+	if (auto* track = current.load())
+		wakeDecoder(*track);
+}
+
+int64 PlaylistSource::getNextReadPosition() const
+{
+	auto seek = pendingSeek.load();
+
+	if (seek >= 0)
+		return seek;
+
+	auto* track = current.load();
+	return track != nullptr ? track->position.load() : 0;
+}
+
+int64 PlaylistSource::getTotalLength() const
+{
+	auto* track = current.load();
+	return track != nullptr ? track->length : 0;
+}
+
+//==============================================================================
+void PlaylistSource::prepareTrack(Track& track)
+{
+	auto fileSampleRate = track.readerSource->getAudioFormatReader()->sampleRate;
+
+	// Keep the track's place in the file if the device rate has changed.
+	auto filePosition = (double)track.position.load() * track.ratio;
+
+	track.ratio = fileSampleRate / deviceSampleRate;
+	track.length = (int64)((double)track.getSource().getTotalLength() / track.ratio);
+
+	if (std::abs(track.ratio - 1.0) > 1.0e-9)
+	{
+		if (track.resampler == nullptr)
+			track.resampler.reset(new ResamplingAudioSource(&track.getSource(), false, 2));
+
+		track.resampler->setResamplingRatio(track.ratio);
+	}
+	else
+	{
+		track.resampler.reset();
+	}
+
+	// Before preparing, so a read-ahead starts decoding from there.
+	seekTrack(track, (int64)(filePosition / track.ratio));
+	track.getOutput().prepareToPlay(blockSize, deviceSampleRate);
+}
+
+void PlaylistSource::seekTrack(Track& track, int64 newPosition)
+{
+	track.position = newPosition;
+	track.getSource().setNextReadPosition((int64)((double)newPosition * track.ratio));
+
+	if (track.resampler != nullptr)
+		track.resampler->flushBuffers();
+}
+
+void PlaylistSource::wakeDecoder(Track& track)
+{
+	if (track.readAhead != nullptr)
+		track.readAhead->wakeDecoder();
+}
+
+void PlaylistSource::renderTrack(Track& track, AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+	track.getOutput().getNextAudioBlock(AudioSourceChannelInfo(&buffer, startSample, numSamples));
+	track.position += numSamples;
+}
+
+void PlaylistSource::finishTrack(Track* track) noexcept
+{
+	if (track == nullptr)
+		return;
+
+	// Lock-free push; releaseFinishedTracks() takes the whole list at once.
+	track->nextFinished = finished.load();
+
+	while (!finished.compare_exchange_weak(track->nextFinished, track))
+	{
+	}
+}
+
+void PlaylistSource::deleteTrack(Track* track)
+{
+	std::unique_ptr<Track> deleter(track);
+}
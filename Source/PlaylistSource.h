@@ -0,0 +1,152 @@
+/*
+  ==============================================================================
+
+    PlaylistSource.h
+    Created: 17 Oct 2026 4:12:53pm
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "ReadAheadSource.h"
+
+//==============================================================================
+/**
+	Plays the current track and, when it ends, carries straight on into the
+	next one at the exact sample, optionally with an equal-power crossfade.
+
+	Everything runs at the device rate: a track recorded at another rate gets
+	its own resampler, so tracks of different rates can follow each other
+	without the transport having to resample. Positions and lengths reported to
+	the transport are always those of the current track.
+
+	Tracks are built and prepared on the message thread and handed to the audio
+	thread through atomics. The audio thread never allocates or frees: finished
+	tracks are pushed onto a lock-free list and deleted by
+	releaseFinishedTracks() on the message thread.
+*/
+class PlaylistSource : public PositionableAudioSource
+{
+public:
+	/** A file ready to play. Build one with the reader source and, optionally,
+		a ReadAheadSource wrapping it. */
+	struct Track
+	{
+		Track(int trackId, const File& audioFile, AudioFormatReaderSource* readerSourceToUse,
+			  ReadAheadSource* readAheadToUse);
+
+		const int id;
+		const File file;
+
+	private:
+		friend class PlaylistSource;
+
+		PositionableAudioSource& getSource() const noexcept;
+		AudioSource& getOutput() const noexcept;
+
+		std::unique_ptr<AudioFormatReaderSource> readerSource;
+		std::unique_ptr<ReadAheadSource> readAhead;
+		std::unique_ptr<ResamplingAudioSource> resampler;
+
+		double ratio = 1.0;					// File samples per device sample
+		int64 length = 0;					// Device samples
+		std::atomic<int64> position{ 0 };	// Device samples played so far
+		bool replacesCurrent = false;		// Loaded by replaceTrack()
+		int64 seekTarget = -1;				// Where a replacement takes over from, -1 for where the old one is
+		Track* nextFinished = nullptr;
+
+		JUCE_DECLARE_NON_COPYABLE(Track)
+	};
+
+	PlaylistSource();
+	~PlaylistSource();
+
+	/** Replaces the current track, starting it at startPosition (in device
+		samples) if the source is prepared. Safe while playing: the audio thread
+		swaps it in at the start of its next block. A queued track stays queued. */
+	void loadTrack(std::unique_ptr<Track> newTrack, int64 startPosition = 0);
+	/** Swaps in a rebuilt copy of the current track (the same id and file, e.g.
+		with different buffering) without losing its place. The audio thread
+		keeps playing the old one until the new one's read-ahead has caught up
+		with it, then carries its position over at the exact sample. Dropped if
+		the playlist has moved on to another track by then.
+
+		With a startPosition it's a seek instead: the old one plays on until the
+		new one is buffered at startPosition, which it then plays from. */
+	void replaceTrack(std::unique_ptr<Track> newTrack, int64 startPosition = -1);
+	/** Audio thread: false while the current track's read-ahead is still filling
+		at the play position, e.g. just after it's loaded. */
+	bool isBuffered() const noexcept;
+	/** Message thread: true if setNextReadPosition(position) would play on straight
+		away, rather than into silence while the current track's read-ahead refills,
+		and there's no replacement waiting that it would be undone by. */
+	bool canSeekWithoutGap(int64 position) const noexcept;
+	/** True until the audio thread has picked up a loaded track. Safe from any thread. */
+	bool isLoadPending() const noexcept { return loaded.load() != nullptr; }
+	/** Audio thread: makes a loaded track current without playing anything, for
+		when the source isn't being pulled. getNextAudioBlock() does this itself. */
+	void takeLoadedTrack() noexcept;
+
+	/** Queues the track to follow the current one. Safe while playing; replaces
+		a queued track that hasn't started fading in yet. */
+	void setNextTrack(std::unique_ptr<Track> newTrack);
+
+	/** 0 for a hard cut at the boundary. Safe from any thread. */
+	void setCrossfadeLength(double seconds) noexcept { crossfadeSeconds.store(jmax(0.0, seconds)); }
+
+	/** Message thread: deletes tracks the audio thread has finished with and
+		returns how many there were, i.e. how many boundaries have passed. */
+	int releaseFinishedTracks();
+
+	/** 0 when there's no track. Includes a loaded track the audio thread hasn't
+		picked up yet. Audio or message thread. */
+	int getCurrentTrackId() const noexcept;
+	/** 0 when nothing is queued. Message thread only. */
+	int getNextTrackId() const noexcept;
+	/** Message thread only. */
+	File getCurrentFile() const;
+	/** The current track's read-ahead, or nullptr if it has none. Message thread only. */
+	const ReadAheadSource* getCurrentReadAhead() const noexcept;
+
+	void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+	void releaseResources() override;
+	void getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill) override;
+
+	/** Never blocks, so a loop can seek from the audio thread. From the message
+		thread, follow it with wakeDecoder() to get the read-ahead there sooner. */
+	void setNextReadPosition(int64 newPosition) override;
+	/** Message thread: moves the current track's read-ahead to the front of the decode thread's queue. */
+	void wakeDecoder();
+	int64 getNextReadPosition() const override;
+	int64 getTotalLength() const override;
+	bool isLooping() const override { return false; }
+
+private:
+	void prepareTrack(Track& track);
+	void seekTrack(Track& track, int64 newPosition);
+	// Message thread only: the read-ahead's wake-up takes the decode thread's lock.
+	static void wakeDecoder(Track& track);
+	void renderTrack(Track& track, AudioBuffer<float>& buffer, int startSample, int numSamples);
+	void finishTrack(Track* track) noexcept;
+	void deleteTrack(Track* track);
+
+	std::atomic<Track*> current{ nullptr }, next{ nullptr }, incoming{ nullptr }, loaded{ nullptr };
+	std::atomic<int> loadedTrackId{ 0 };	// So the audio thread never has to look inside loaded
+	std::atomic<Track*> finished{ nullptr };
+	std::atomic<int64> pendingSeek{ -1 };
+	std::atomic<double> crossfadeSeconds{ 0.0 };
+	std::atomic<int> boundariesPassed{ 0 };
+
+	// Audio thread only
+	bool nextStarted = false;
+
+	AudioBuffer<float> fadeBuffer;
+	double deviceSampleRate = 0.0;
+	int blockSize = 0;
+	bool isPrepared = false;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PlaylistSource)
+};
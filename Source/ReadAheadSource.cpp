@@ -0,0 +1,209 @@
+/*
+  ==============================================================================
+
+    ReadAheadSource.cpp
+    Created: 17 Oct 2026 3:34:18pm
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#include "ReadAheadSource.h"
+
+ReadAheadSource::ReadAheadSource(PositionableAudioSource* sourceToBuffer, bool deleteSourceWhenDone,
+								 TimeSliceThread& decodeThread, int bufferSizeSamples, int channels)
+	: source(sourceToBuffer, deleteSourceWhenDone),
+	  thread(decodeThread),
+	  bufferSize(jmax(samplesPerSlice * 2, bufferSizeSamples)),
+	  numChannels(jmax(1, channels))
+{
+	jassert(source != nullptr);
+}
+
+ReadAheadSource::~ReadAheadSource()
+{
+	releaseResources();
+}
+
+void ReadAheadSource::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+	source->prepareToPlay(samplesPerBlockExpected, sampleRate);
+
+	// Nothing wakes the decoder as the buffer drains, so it looks again well before a quarter of it has played.
+	fullWaitMs = jlimit(1, 20, (int)(250.0 * bufferSize / jmax(1.0, sampleRate)));
+
+	if (!isPrepared)
+	{
+		buffer.setSize(numChannels, bufferSize);
+		buffer.clear();
+
+		// The decode thread hasn't got us yet, so the range is ours to set.
+		validStart = nextPlayPosition.load();
+		validEnd = validStart.load();
+
+		isPrepared = true;
+		thread.addTimeSliceClient(this);
+	}
+
+	// Get the decoder going straight away, without waiting for it here: the deck
+	// holds a start back until isBufferedAt() says so.
+	wakeDecoder();
+}
+
+void ReadAheadSource::releaseResources()
+{
+	if (isPrepared)
+	{
+		// Waits for a slice in progress, so the buffer is ours again afterwards.
+		thread.removeTimeSliceClient(this);
+		isPrepared = false;
+	}
+
+	buffer.setSize(numChannels, 0);
+	source->releaseResources();
+}
+
+void ReadAheadSource::getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill)
+{
+	auto start = nextPlayPosition.load();
+	auto numSamples = bufferToFill.numSamples;
+	auto served = 0;
+
+	// Never wait here: if the decoder is resetting the range, play silence instead.
+	auto generation = rangeGeneration.load(std::memory_order_acquire);
+	auto end = validEnd.load(std::memory_order_acquire);
+
+	if ((generation & 1) == 0 && start >= validStart.load(std::memory_order_acquire) && start < end)
+	{
+		served = (int)jmin((int64)numSamples, end - start);
+
+		auto readIndex = (int)(start % bufferSize);
+		auto size1 = jmin(served, bufferSize - readIndex);
+		auto size2 = served - size1;
+
+		for (int ch = 0; ch < bufferToFill.buffer->getNumChannels(); ++ch)
+		{
+			auto srcChannel = jmin(ch, numChannels - 1);
+			bufferToFill.buffer->copyFrom(ch, bufferToFill.startSample, buffer, srcChannel, readIndex, size1);
+
+			if (size2 > 0)
+				bufferToFill.buffer->copyFrom(ch, bufferToFill.startSample + size1, buffer, srcChannel, 0, size2);
+		}
+
+		// Anything the decoder reset or decoded over while we were copying shows up
+		// here; what was copied then is thrown away rather than played torn.
+		std::atomic_thread_fence(std::memory_order_acquire);
+
+		if (rangeGeneration.load(std::memory_order_relaxed) != generation
+			|| validStart.load(std::memory_order_relaxed) > start)
+			served = 0;
+		else
+			numBuffered.store((int)(end - (start + served)), std::memory_order_relaxed);
+	}
+
+	if (served < numSamples)
+	{
+		bufferToFill.buffer->clear(bufferToFill.startSample + served, numSamples - served);
+
+		if (start + served < getTotalLength())
+			numUnderruns.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	// If a seek came in while we were copying, leave it be.
+	nextPlayPosition.compare_exchange_strong(start, start + numSamples);
+}
+
+void ReadAheadSource::setNextReadPosition(int64 newPosition)
+{
+	nextPlayPosition.store(newPosition);
+}
+
+bool ReadAheadSource::isBufferedAt(int64 position) const noexcept
+{
+	auto generation = rangeGeneration.load(std::memory_order_acquire);
+	auto end = validEnd.load(std::memory_order_acquire);
+
+	if ((generation & 1) != 0 || position < validStart.load(std::memory_order_acquire))
+		return false;
+
+	return end - position >= jmin((int64)samplesPerSlice, getTotalLength() - position);
+}
+
+int64 ReadAheadSource::getNextReadPosition() const
+{
+	return nextPlayPosition.load();
+}
+
+int64 ReadAheadSource::getTotalLength() const
+{
+	return source->getTotalLength();
+}
+
+bool ReadAheadSource::isLooping() const
+{
+	return source->isLooping();
+}
+
+int ReadAheadSource::useTimeSlice()
+{
+	auto playPosition = nextPlayPosition.load();
+
+	// Only this thread writes the range, so it can read it as it likes.
+	auto start = validStart.load(std::memory_order_relaxed);
+	auto writePosition = validEnd.load(std::memory_order_relaxed);
+
+	if (playPosition < start || playPosition > writePosition)
+	{
+		// A seek outside what we've decoded: start again from there. The odd
+		// generation tells the audio thread not to trust the range meanwhile.
+		auto generation = rangeGeneration.load(std::memory_order_relaxed);
+		rangeGeneration.store(generation + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		validStart.store(playPosition, std::memory_order_relaxed);
+		validEnd.store(playPosition, std::memory_order_relaxed);
+		rangeGeneration.store(generation + 2, std::memory_order_release);
+
+		start = writePosition = playPosition;
+	}
+
+	// Up to a buffer ahead of the play position; what's behind it has been played,
+	// or skipped by followPosition(), and can be decoded over.
+	auto numToRead = (int)jmin((int64)samplesPerSlice, jmax(start, playPosition) + bufferSize - writePosition);
+
+	if (!source->isLooping())
+		numToRead = (int)jmin((int64)numToRead, getTotalLength() - writePosition);
+
+	if (numToRead <= 0)
+	{
+		// Full, or decoded up to the end of the track.
+		return fullWaitMs.load();
+	}
+
+	if (source->getNextReadPosition() != writePosition)
+		source->setNextReadPosition(writePosition);
+
+	// Samples this decodes over stop being valid before they're touched.
+	if (writePosition + numToRead - bufferSize > start)
+	{
+		validStart.store(writePosition + numToRead - bufferSize, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+	}
+
+	// The audio thread never reads at or past validEnd, so this part of the
+	// buffer is ours.
+	auto writeIndex = (int)(writePosition % bufferSize);
+	auto size1 = jmin(numToRead, bufferSize - writeIndex);
+	auto size2 = numToRead - size1;
+
+	source->getNextAudioBlock(AudioSourceChannelInfo(&buffer, writeIndex, size1));
+
+	if (size2 > 0)
+		source->getNextAudioBlock(AudioSourceChannelInfo(&buffer, 0, size2));
+
+	validEnd.store(writePosition + numToRead, std::memory_order_release);
+	numBuffered.store((int)jmax((int64)0, writePosition + numToRead - jmax(validStart.load(std::memory_order_relaxed), nextPlayPosition.load())),
+					  std::memory_order_relaxed);
+
+	return 1;
+}
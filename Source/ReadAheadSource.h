@@ -0,0 +1,100 @@
+/*
+  ==============================================================================
+
+    ReadAheadSource.h
+    Created: 17 Oct 2026 3:34:18pm
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+	Decodes a PositionableAudioSource ahead of playback on a TimeSliceThread, so
+	the audio callback only ever copies samples that are already in memory.
+
+	Does the same job as JUCE's BufferingAudioSource, but the audio thread never
+	waits and takes no lock: only the decode thread moves the decoded range, and
+	the audio thread checks after copying that the range didn't move under what
+	it copied. Anything it can't serve is played as silence and counted as an
+	underrun. The fill level and underrun count can be read from any thread.
+
+	The audio thread doesn't wake the decode thread either, since that takes the
+	thread's locks: the decoder polls, sooner the smaller the buffer, and the
+	message thread calls wakeDecoder() after anything that needs it at once.
+
+	Seeking outside the decoded range throws the buffer away and starts
+	decoding again from the new position, and the blocks played meanwhile are
+	silent and counted like any other. Nothing here waits for the decoder, not
+	even prepareToPlay(): whoever starts or seeks playback checks
+	isBufferedAt() first, as PlaylistSource does with a replacement track.
+*/
+class ReadAheadSource : public PositionableAudioSource,
+						private TimeSliceClient
+{
+public:
+	/** bufferSizeSamples is how far ahead of playback to decode. */
+	ReadAheadSource(PositionableAudioSource* sourceToBuffer, bool deleteSourceWhenDone,
+					TimeSliceThread& decodeThread, int bufferSizeSamples, int numChannels);
+	~ReadAheadSource();
+
+	void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+	void releaseResources() override;
+	void getNextAudioBlock(const AudioSourceChannelInfo& bufferToFill) override;
+
+	/** Never blocks, so it's safe on the audio thread; from the message thread,
+		follow it with wakeDecoder(). */
+	void setNextReadPosition(int64 newPosition) override;
+	int64 getNextReadPosition() const override;
+	int64 getTotalLength() const override;
+	bool isLooping() const override;
+
+	/** Moves the read position on without counting it as a seek, for a source
+		that's being kept near another's playhead before it plays. Never blocks. */
+	void followPosition(int64 newPosition) noexcept { nextPlayPosition.store(newPosition); }
+	/** True if the samples from position on are decoded, a slice's worth or up
+		to the end. Never blocks. */
+	bool isBufferedAt(int64 position) const noexcept;
+
+	/** Message thread: puts this source first in the decode thread's queue, for
+		after a seek or a load. Takes the thread's lock, so never from the audio thread. */
+	void wakeDecoder()		{ thread.moveToFrontOfQueue(this); }
+
+	int getBufferSize() const noexcept { return bufferSize; }
+	// Decoded samples waiting ahead of the play position.
+	int getNumBufferedSamples() const noexcept { return numBuffered.load(std::memory_order_relaxed); }
+	// Blocks that weren't fully decoded in time.
+	int getNumUnderruns() const noexcept { return numUnderruns.load(std::memory_order_relaxed); }
+
+private:
+	int useTimeSlice() override;
+
+	OptionalScopedPointer<PositionableAudioSource> source;
+	TimeSliceThread& thread;
+	const int bufferSize, numChannels;
+
+	// Sample n of the source lives at buffer position n % bufferSize.
+	AudioBuffer<float> buffer;
+
+	// [validStart, validEnd) is decoded and ready. Only the decode thread writes
+	// them: validEnd moves on as it decodes, and validStart moves on before it
+	// decodes over samples that have been played. Resetting both for a seek makes
+	// rangeGeneration odd while it's under way, like a sequence lock.
+	std::atomic<int64> validStart{ 0 }, validEnd{ 0 };
+	std::atomic<uint32> rangeGeneration{ 0 };
+
+	std::atomic<int64> nextPlayPosition{ 0 };
+	std::atomic<int> numBuffered{ 0 };
+	std::atomic<int> numUnderruns{ 0 };
+	std::atomic<int> fullWaitMs{ 20 };		// How long a full buffer lets the decoder sleep
+	bool isPrepared = false;
+
+	// Most the decode thread reads in one slice, so it can't starve other clients.
+	enum { samplesPerSlice = 8192 };
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ReadAheadSource)
+};
@@ -0,0 +1,67 @@
+/*
+  ==============================================================================
+
+    SnapshotBuffer.h
+    Created: 17 Oct 2026 10:09:37am
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+
+//==============================================================================
+/**
+	Lock-free triple buffer for handing a large struct from one writer thread to
+	one reader thread.
+
+	The writer fills getWriteBuffer() and calls publish(); the reader calls
+	read() and gets the newest complete snapshot without copying it. Neither
+	side ever waits on the other, and a slow reader simply skips snapshots.
+	Every publish() bumps a version number so the reader can tell whether
+	anything changed since its last look.
+*/
+template <typename SnapshotType>
+class SnapshotBuffer
+{
+public:
+	SnapshotBuffer() = default;
+
+	/** Writer: the slot to fill before calling publish(). */
+	SnapshotType& getWriteBuffer() noexcept { return slots[writeIndex]; }
+
+	/** Writer: makes the write buffer visible to the reader. */
+	void publish() noexcept
+	{
+		versions[writeIndex] = ++lastVersion;
+		writeIndex = middle.exchange(writeIndex | freshFlag, std::memory_order_acq_rel) & indexMask;
+	}
+
+	/** Reader: returns the newest snapshot. The reference stays valid until the
+		next call to read(). */
+	const SnapshotType& read() noexcept
+	{
+		if ((middle.load(std::memory_order_relaxed) & freshFlag) != 0)
+			readIndex = middle.exchange(readIndex, std::memory_order_acq_rel) & indexMask;
+
+		return slots[readIndex];
+	}
+
+	/** Reader: version of the snapshot last returned by read(), 0 if nothing has been published yet. */
+	uint64 getReadVersion() const noexcept { return versions[readIndex]; }
+
+private:
+	enum { indexMask = 3, freshFlag = 4 };
+
+	SnapshotType slots[3];
+	uint64 versions[3] = { 0, 0, 0 };
+	uint64 lastVersion = 0;
+
+	int writeIndex = 0, readIndex = 2;
+	std::atomic<int> middle{ 1 };
+
+	JUCE_DECLARE_NON_COPYABLE(SnapshotBuffer)
+};
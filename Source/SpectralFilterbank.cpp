@@ -0,0 +1,120 @@
+/*
+  ==============================================================================
+
+    SpectralFilterbank.cpp
+    Created: 17 Oct 2026 6:04:33pm
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#include "SpectralFilterbank.h"
+
+constexpr double SpectralFilterbank::melLowest, SpectralFilterbank::melHighest, SpectralFilterbank::constantQLowest;
+constexpr int SpectralFilterbank::bandsPerOctave;
+
+namespace
+{
+	double frequencyToMel(double hz)	{ return 2595.0 * std::log10(1.0 + hz / 700.0); }
+	double melToFrequency(double mel)	{ return 700.0 * (std::pow(10.0, mel / 2595.0) - 1.0); }
+}
+
+void SpectralFilterbank::prepare(double sampleRate, int fftSize)
+{
+	binWidth = sampleRate / fftSize;
+	numBins = fftSize / 2;
+
+	// Band k's triangle runs from edges[k] through edges[k + 1] to edges[k + 2].
+	double edges[numBands + 2];
+	auto nyquist = sampleRate * 0.5;
+
+	auto melLow = frequencyToMel(melLowest);
+	auto melHigh = frequencyToMel(jmin(melHighest, nyquist * 0.95));
+
+	for (int i = 0; i < numBands + 2; ++i)
+		edges[i] = melToFrequency(melLow + (melHigh - melLow) * i / (numBands + 1));
+
+	build(matrices[mel], edges);
+
+	for (int i = 0; i < numBands + 2; ++i)
+		edges[i] = jmin(nyquist, constantQLowest * std::pow(2.0, (i - 1) / (double)bandsPerOctave));
+
+	build(matrices[constantQ], edges);
+}
+
+void SpectralFilterbank::build(Matrix& matrix, const double* edges)
+{
+	matrix.weights.clear();
+
+	for (int band = 0; band < numBands; ++band)
+	{
+		auto low = edges[band], centre = edges[band + 1], high = edges[band + 2];
+		auto& row = matrix.rows[band];
+
+		matrix.centres[band] = centre;
+		row.firstWeight = (int)matrix.weights.size();
+		row.numWeights = 0;
+
+		auto firstBin = jmax(0, (int)std::ceil(low / binWidth));
+		auto lastBin = jmin(numBins - 1, (int)std::floor(high / binWidth));
+
+		for (int bin = firstBin; bin <= lastBin; ++bin)
+		{
+			auto frequency = bin * binWidth;
+			auto weight = frequency <= centre ? (frequency - low) / jmax(1.0e-9, centre - low)
+											  : (high - frequency) / jmax(1.0e-9, high - centre);
+
+			// Only keep the non-zero part of the triangle.
+			if (weight <= 0.0)
+			{
+				if (row.numWeights > 0)
+					break;
+
+				continue;
+			}
+
+			if (row.numWeights == 0)
+				row.firstBin = bin;
+
+			matrix.weights.push_back((float)weight);
+			++row.numWeights;
+		}
+
+		if (row.numWeights == 0)
+		{
+			// Narrower than a bin: interpolate between the two either side of the centre.
+			auto position = jlimit(0.0, (double)(numBins - 2), centre / binWidth);
+			auto bin = (int)position;
+			auto fraction = (float)(position - bin);
+
+			row.firstBin = bin;
+			row.numWeights = 2;
+			matrix.weights.push_back(1.0f - fraction);
+			matrix.weights.push_back(fraction);
+		}
+	}
+}
+
+void SpectralFilterbank::process(Mode mode, const float* magnitudes, float* bands) const noexcept
+{
+	auto& matrix = matrices[mode];
+
+	for (int band = 0; band < numBands; ++band)
+	{
+		auto& row = matrix.rows[band];
+		auto* weight = matrix.weights.data() + row.firstWeight;
+		auto* magnitude = magnitudes + row.firstBin;
+		auto power = 0.0f;
+
+		for (int i = 0; i < row.numWeights; ++i)
+			power += weight[i] * magnitude[i] * magnitude[i];
+
+		// A Hann window spreads a sine's power over 1.5 bins' worth of magnitude.
+		bands[band] = std::sqrt(power * (1.0f / 1.5f));
+	}
+}
+
+const char* SpectralFilterbank::getModeName(Mode mode)
+{
+	return mode == constantQ ? "Constant-Q" : "Mel";
+}
@@ -0,0 +1,76 @@
+/*
+  ==============================================================================
+
+    SpectralFilterbank.h
+    Created: 17 Oct 2026 6:04:33pm
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+
+//==============================================================================
+/**
+	Folds an FFT magnitude spectrum into a fixed number of log-frequency bands,
+	on either the mel scale or a constant-Q (equal bands per octave) layout.
+
+	Each band is a triangle reaching from its lower neighbour's centre to its
+	upper neighbour's. The weights for both layouts are worked out once in
+	prepare() and stored sparsely, as a run of bins per band, so process() only
+	touches the bins a band actually covers. Bands narrower than an FFT bin,
+	which happens at the bottom of the constant-Q layout, fall back to
+	interpolating between the two bins around their centre.
+*/
+class SpectralFilterbank
+{
+public:
+	enum Mode { mel, constantQ, numModes };
+	enum { numBands = 40 };
+
+	SpectralFilterbank() = default;
+
+	/** Builds the weights for both modes. Allocates, so not for the audio thread. */
+	void prepare(double sampleRate, int fftSize);
+
+	/** Fills bands[numBands] from numBins = fftSize / 2 magnitudes. Each band is
+		the root of its weighted power, so it reads in the same units as the
+		spectrum: a full-scale sine at a band's centre comes out around 1.0. */
+	void process(Mode mode, const float* magnitudes, float* bands) const noexcept;
+
+	double getCentreFrequency(Mode mode, int band) const noexcept	{ return matrices[mode].centres[band]; }
+	/** Non-zero weights in a mode's matrix, i.e. multiply-adds per frame. */
+	int getNumWeights(Mode mode) const noexcept						{ return (int)matrices[mode].weights.size(); }
+
+	static const char* getModeName(Mode mode);
+
+	// Band layouts. Mel spans the whole range evenly in mels; constant-Q puts
+	// bandsPerOctave bands in each octave up from constantQLowest.
+	static constexpr double melLowest = 30.0, melHighest = 16000.0;
+	static constexpr double constantQLowest = 55.0;
+	static constexpr int bandsPerOctave = 5;
+
+private:
+	struct Row
+	{
+		int firstBin = 0, firstWeight = 0, numWeights = 0;
+	};
+
+	struct Matrix
+	{
+		Row rows[numBands];
+		std::vector<float> weights;
+		double centres[numBands] = {};
+	};
+
+	void build(Matrix& matrix, const double* edges);
+
+	Matrix matrices[numModes];
+	double binWidth = 0.0;
+	int numBins = 0;
+
+	JUCE_DECLARE_NON_COPYABLE(SpectralFilterbank)
+};
@@ -0,0 +1,160 @@
+/*
+  ==============================================================================
+
+    StemSet.cpp
+    Created: 18 Oct 2026 2:51:37am
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#include "StemSet.h"
+
+namespace
+{
+	const char* const stemNames[StemSet::numStems] = { "Drums", "Bass", "Melody", "Vocals" };
+
+	// Checked in this order, so "Bass Drum" is drums and "Lead Vox" is vocals.
+	const StemSet::Stem matchOrder[] = { StemSet::drums, StemSet::vocals, StemSet::bass, StemSet::melody };
+
+	bool nameMatches(const String& name, StemSet::Stem stem)
+	{
+		static const StringArray keywords[StemSet::numStems] =
+		{
+			StringArray{ "drum", "perc", "kick", "beat" },
+			StringArray{ "bass" },
+			StringArray{ "melod", "inst", "synth", "keys", "lead", "other", "music" },
+			StringArray{ "vocal", "vox", "voice", "acapella", "acappella" }
+		};
+
+		for (auto& keyword : keywords[stem])
+			if (name.contains(keyword))
+				return true;
+
+		return false;
+	}
+}
+
+//==============================================================================
+String StemSet::getStemName(Stem stem)
+{
+	return isPositiveAndBelow((int)stem, (int)numStems) ? stemNames[stem] : "";
+}
+
+StemSet StemSet::fromFolder(const File& folder)
+{
+	StemSet stems;
+
+	if (!folder.isDirectory())
+		return stems;
+
+	auto audioFiles = folder.findChildFiles(File::findFiles, false, "*.wav;*.aif;*.aiff;*.flac;*.ogg;*.mp3");
+	audioFiles.sort();
+
+	for (auto& file : audioFiles)
+	{
+		auto name = file.getFileNameWithoutExtension().toLowerCase();
+
+		// The first file that matches a stem gets it.
+		for (auto stem : matchOrder)
+		{
+			if (nameMatches(name, stem))
+			{
+				if (!stems.hasStem(stem))
+					stems.files[stem] = file;
+
+				break;
+			}
+		}
+	}
+
+	if (stems.getNumStems() < 2)
+		return {};
+
+	return stems;
+}
+
+int StemSet::getNumStems() const noexcept
+{
+	auto count = 0;
+
+	for (auto& file : files)
+		if (file != File())
+			++count;
+
+	return count;
+}
+
+//==============================================================================
+StemMixReader::StemMixReader(const Array<AudioFormatReader*>& stemReaders)
+	: AudioFormatReader(nullptr, "Stem mix"),
+	  scratch(2, scratchSize)
+{
+	for (int i = 0; i < stemReaders.size(); ++i)
+	{
+		auto* reader = stemReaders.getUnchecked(i);
+
+		if (reader == nullptr)
+			continue;
+
+		if (!readers.isEmpty() && reader->sampleRate != readers.getFirst()->sampleRate)
+		{
+			leftOutStems.add(StemSet::getStemName((StemSet::Stem)i) + " (" + String(reader->sampleRate) + " Hz)");
+			delete reader;
+			continue;
+		}
+
+		readers.add(reader);
+	}
+
+	sampleRate = readers.isEmpty() ? 44100.0 : readers.getFirst()->sampleRate;
+	numChannels = 2;
+	bitsPerSample = 32;
+	usesFloatingPointData = true;
+	lengthInSamples = 0;
+
+	for (auto* reader : readers)
+		lengthInSamples = jmax(lengthInSamples, reader->lengthInSamples);
+}
+
+bool StemMixReader::readSamples(int** destSamples, int numDestChannels, int startOffsetInDestBuffer,
+								int64 startSampleInFile, int numSamples)
+{
+	clearSamplesBeyondAvailableLength(destSamples, numDestChannels, startOffsetInDestBuffer,
+									  startSampleInFile, numSamples, lengthInSamples);
+
+	if (numSamples <= 0)
+		return true;
+
+	auto** dest = reinterpret_cast<float**>(destSamples);
+
+	for (int ch = 0; ch < numDestChannels; ++ch)
+		if (dest[ch] != nullptr)
+			FloatVectorOperations::clear(dest[ch] + startOffsetInDestBuffer, numSamples);
+
+	// In chunks, so the scratch buffer never has to grow on whichever thread this is.
+	for (int done = 0; done < numSamples; done += scratchSize)
+	{
+		auto num = jmin((int)scratchSize, numSamples - done);
+
+		for (auto* reader : readers)
+		{
+			// A stem shorter than the mix reads as silence past its end.
+			auto start = startSampleInFile + done;
+
+			if (start >= reader->lengthInSamples)
+				continue;
+
+			// Through read() rather than readSamples(), which converts integer data and
+			// copies a mono stem to both sides.
+			auto numFromStem = (int)jmin((int64)num, reader->lengthInSamples - start);
+			reader->read(&scratch, 0, numFromStem, start, true, true);
+
+			for (int ch = 0; ch < numDestChannels; ++ch)
+				if (dest[ch] != nullptr)
+					FloatVectorOperations::add(dest[ch] + startOffsetInDestBuffer + done, scratch.getReadPointer(jmin(ch, 1)), numFromStem);
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,74 @@
+/*
+  ==============================================================================
+
+    StemSet.h
+    Created: 18 Oct 2026 2:51:37am
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+	A track delivered as separate drums, bass, melody and vocal files, kept
+	together in one folder.
+
+	Which file is which comes from its name ("Kick & Drums.wav", "Lead Vox.mp3",
+	...). A folder with fewer than two recognisable stems isn't a stem set;
+	missing stems are just left out.
+*/
+struct StemSet
+{
+	enum Stem
+	{
+		drums,
+		bass,
+		melody,
+		vocals,
+		numStems
+	};
+
+	static String getStemName(Stem stem);
+
+	/** An empty set if the folder doesn't hold at least two of the stems. */
+	static StemSet fromFolder(const File& folder);
+	static bool isStemFolder(const File& folder) { return fromFolder(folder).getNumStems() > 0; }
+
+	int getNumStems() const noexcept;
+	bool hasStem(Stem stem) const noexcept { return files[stem] != File(); }
+
+	File files[numStems];
+};
+
+//==============================================================================
+/**
+	Plays a stem set's files as one: every read reads each stem and sums them.
+	Stems with a different sample rate from the first are left out, and named
+	by getLeftOutStems(); the length is the longest stem's.
+*/
+class StemMixReader : public AudioFormatReader
+{
+public:
+	/** Takes ownership of the readers, in StemSet order; nullptrs are skipped. */
+	explicit StemMixReader(const Array<AudioFormatReader*>& stemReaders);
+
+	int getNumStemReaders() const noexcept { return readers.size(); }
+	/** Stems whose sample rate didn't match, e.g. "Vocals (48000 Hz)". */
+	const StringArray& getLeftOutStems() const noexcept { return leftOutStems; }
+
+	bool readSamples(int** destSamples, int numDestChannels, int startOffsetInDestBuffer,
+					 int64 startSampleInFile, int numSamples) override;
+
+private:
+	OwnedArray<AudioFormatReader> readers;
+	StringArray leftOutStems;
+	AudioBuffer<float> scratch;
+
+	enum { scratchSize = 8192 };
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StemMixReader)
+};
@@ -0,0 +1,500 @@
+/*
+  ==============================================================================
+
+    TrackAnalysis.cpp
+    Created: 17 Oct 2026 1:05:22pm
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#include "TrackAnalysis.h"
+#include "FeatureExtractor.h"
+#include <algorithm>
+#include <numeric>
+
+//==============================================================================
+constexpr double TrackAnalysis::bandEdges[];
+
+double TrackAnalysis::getBeatPosition(double seconds) const noexcept
+{
+	if (beats.size() < 2)
+		return seconds * tempo / 60.0;
+
+	auto next = std::upper_bound(beats.begin(), beats.end(), seconds);
+
+	// Before the first or after the last beat, carry on at the nearest interval.
+	if (next == beats.begin())
+		return (seconds - beats[0]) / (beats[1] - beats[0]);
+
+	if (next == beats.end())
+	{
+		auto last = beats.size() - 1;
+		return (double)last + (seconds - beats[last]) / (beats[last] - beats[last - 1]);
+	}
+
+	auto i = (size_t)(next - beats.begin()) - 1;
+	return (double)i + (seconds - beats[i]) / (beats[i + 1] - beats[i]);
+}
+
+double TrackAnalysis::getBeatTime(double beatPosition) const noexcept
+{
+	if (beats.size() < 2)
+		return tempo > 0.0 ? beatPosition * 60.0 / tempo : 0.0;
+
+	// Extrapolated the same way as getBeatPosition().
+	auto last = beats.size() - 1;
+	auto i = (size_t)jlimit(0.0, (double)(last - 1), std::floor(beatPosition));
+
+	return beats[i] + (beatPosition - (double)i) * (beats[i + 1] - beats[i]);
+}
+
+double TrackAnalysis::getBarAlignedBeatPosition(double seconds) const noexcept
+{
+	auto position = getBeatPosition(seconds);
+
+	if (!downbeats.empty())
+		position -= (double)downbeats.front();
+
+	return position;
+}
+
+double TrackAnalysis::getTempoAt(double seconds) const noexcept
+{
+	if (beats.size() < 2)
+		return tempo;
+
+	auto next = std::upper_bound(beats.begin(), beats.end(), seconds);
+	auto i = (size_t)jlimit<int64>(1, (int64)beats.size() - 1, (int64)(next - beats.begin()));
+
+	return 60.0 / (beats[i] - beats[i - 1]);
+}
+
+float TrackAnalysis::getEnergyAt(double seconds) const noexcept
+{
+	if (energy.empty())
+		return 0.0f;
+
+	auto index = jlimit<int64>(0, (int64)energy.size() - 1, (int64)(seconds * envelopeRate));
+	return energy[(size_t)index];
+}
+
+float TrackAnalysis::getBandEnergyAt(double seconds, int band) const noexcept
+{
+	auto numPoints = (int64)(bandEnergy.size() / numBands);
+
+	if (numPoints == 0 || !isPositiveAndBelow(band, (int)numBands))
+		return 0.0f;
+
+	auto index = jlimit<int64>(0, numPoints - 1, (int64)(seconds * envelopeRate));
+	return bandEnergy[(size_t)(index * numBands + band)];
+}
+
+int TrackAnalysis::getSectionIndex(double seconds) const noexcept
+{
+	auto next = std::upper_bound(sections.begin(), sections.end(), seconds);
+	return jmax(0, (int)(next - sections.begin()) - 1);
+}
+
+//==============================================================================
+namespace
+{
+	// Where an onset peaks relative to the end of the analysis window. The Hann
+	// window makes the flux rise fastest about a quarter of the way in.
+	const int onsetLatencySamples = AnalysisFrame::fftSize / 4;
+
+	// How strongly the beat tracker sticks to the estimated period (Ellis, 2007).
+	const double beatTightness = 100.0;
+
+	const double bassCutoffHz = 150.0;
+	const int sectionWindowBars = 8;
+	const float sectionThresholdDb = 2.5f;
+}
+
+TrackAnalysisBuilder::TrackAnalysisBuilder(double rate, int hop, int numChannels)
+	: sampleRate(rate), frameRate(rate / (double)hop), hopSize(hop)
+{
+	loudnessMeter.prepare(rate, numChannels);
+}
+
+void TrackAnalysisBuilder::addFrame(const AnalysisFrame& frame)
+{
+	onsetCurve.push_back(frame.onsetFunction);
+	energy.push_back(0.5f * (frame.rms[0] + frame.rms[1]));
+
+	// Louder frames say more about the key than breakdowns and fades.
+	for (int pc = 0; pc < AnalysisFrame::numPitchClasses; ++pc)
+		chromaSum[pc] += frame.chroma[pc] * energy.back();
+
+	auto bassBins = jmax(1, (int)(bassCutoffHz * AnalysisFrame::fftSize / sampleRate));
+	auto bass = 0.0f;
+
+	for (int b = 1; b <= bassBins; ++b)
+		bass += frame.spectrum[b] * frame.spectrum[b];
+
+	bassEnergy.push_back(bass);
+
+	// Band envelopes: RMS of the spectrum between the band edges.
+	auto binWidth = sampleRate / AnalysisFrame::fftSize;
+	auto bandStart = 1;
+
+	for (int band = 0; band < TrackAnalysis::numBands; ++band)
+	{
+		auto bandEnd = band < TrackAnalysis::numBands - 1 ? jmax(bandStart + 1, (int)(TrackAnalysis::bandEdges[band] / binWidth))
+														  : (int)AnalysisFrame::numBins;
+		auto sum = 0.0f;
+
+		for (int b = bandStart; b < bandEnd; ++b)
+			sum += frame.spectrum[b] * frame.spectrum[b];
+
+		bandEnergy.push_back(std::sqrt(sum * 0.5f));
+		bandStart = bandEnd;
+	}
+}
+
+void TrackAnalysisBuilder::addSamples(const AudioBuffer<float>& buffer, int numSamples)
+{
+	auto numChannels = buffer.getNumChannels();
+
+	if (numChannels == 0)
+		return;
+
+	const float* loudnessChannels[BiquadCascade::maxChannels];
+
+	for (int ch = 0; ch < loudnessMeter.getNumChannels(); ++ch)
+		loudnessChannels[ch] = buffer.getReadPointer(jmin(ch, numChannels - 1));
+
+	loudnessMeter.process(loudnessChannels, numSamples);
+
+	for (int i = 0; i < numSamples; ++i)
+	{
+		auto sample = 0.0f;
+		for (int ch = 0; ch < numChannels; ++ch)
+			sample += buffer.getReadPointer(ch)[i];
+
+		sample /= (float)numChannels;
+		samplePeak = jmax(samplePeak, std::abs(sample));
+
+		if (pendingSamples == 0)
+			pendingPoint = { sample, sample, 0.0f };
+
+		pendingPoint.minimum = jmin(pendingPoint.minimum, sample);
+		pendingPoint.maximum = jmax(pendingPoint.maximum, sample);
+		pendingPoint.rms += sample * sample;
+
+		if (++pendingSamples == waveformBaseSamples)
+		{
+			pendingPoint.rms = std::sqrt(pendingPoint.rms / (float)waveformBaseSamples);
+			baseWaveform.push_back(pendingPoint);
+			pendingSamples = 0;
+		}
+	}
+}
+
+double TrackAnalysisBuilder::frameToSeconds(int frame) const noexcept
+{
+	return jmax(0.0, ((double)(frame + 1) * hopSize - onsetLatencySamples) / sampleRate);
+}
+
+int TrackAnalysisBuilder::secondsToFrame(double seconds) const noexcept
+{
+	return jlimit(0, jmax(0, (int)energy.size() - 1), roundToInt((seconds * sampleRate + onsetLatencySamples) / hopSize) - 1);
+}
+
+std::shared_ptr<TrackAnalysis> TrackAnalysisBuilder::build(double lengthInSeconds)
+{
+	auto result = std::make_shared<TrackAnalysis>();
+	result->sampleRate = sampleRate;
+	result->lengthInSeconds = lengthInSeconds;
+	result->envelopeRate = frameRate;
+	result->loudness = measureLoudness();
+
+	auto key = ChromaExtractor::estimateKey(chromaSum);
+	result->key = key.key;
+	result->keyConfidence = key.confidence;
+
+	// Normalise the onset curve so the tracker's tightness means the same thing for every track.
+	if (onsetCurve.size() > 1)
+	{
+		auto mean = std::accumulate(onsetCurve.begin(), onsetCurve.end(), 0.0) / (double)onsetCurve.size();
+		auto variance = 0.0;
+
+		for (auto o : onsetCurve)
+			variance += ((double)o - mean) * ((double)o - mean);
+
+		auto scale = 1.0 / jmax(1.0e-9, std::sqrt(variance / (double)onsetCurve.size()));
+
+		for (auto& o : onsetCurve)
+			o = (float)((double)o * scale);
+	}
+
+	std::vector<double> beats;
+	std::vector<int32> downbeats;
+	std::vector<double> sections{ 0.0 };
+	auto period = estimateBeatPeriod();
+
+	if (period > 0.0)
+	{
+		beats = trackBeats(period);
+		downbeats = findDownbeats(beats, result->beatsPerBar);
+
+		auto boundaries = findSections(beats, downbeats);
+		sections.insert(sections.end(), boundaries.begin(), boundaries.end());
+	}
+
+	if (beats.size() > 1)
+	{
+		std::vector<double> intervals;
+		for (size_t i = 1; i < beats.size(); ++i)
+			intervals.push_back(beats[i] - beats[i - 1]);
+
+		std::nth_element(intervals.begin(), intervals.begin() + (ptrdiff_t)intervals.size() / 2, intervals.end());
+		result->tempo = 60.0 / intervals[intervals.size() / 2];
+	}
+
+	result->beats.assign(std::move(beats));
+	result->downbeats.assign(std::move(downbeats));
+	result->sections.assign(std::move(sections));
+	result->energy.assign(std::vector<float>(energy));
+	result->bandEnergy.assign(std::vector<float>(bandEnergy));
+
+	buildWaveform(*result);
+
+	return result;
+}
+
+double TrackAnalysisBuilder::estimateBeatPeriod() const
+{
+	// Same idea as the live BeatTracker, but over the whole track at once.
+	auto minLag = jmax(2, (int)std::floor(60.0 * frameRate / 200.0));
+	auto maxLag = (int)std::ceil(60.0 * frameRate / 60.0);
+	auto numFrames = (int)onsetCurve.size();
+
+	if (numFrames < 4 * maxLag)
+		return 0.0;
+
+	std::vector<double> acf((size_t)(2 * maxLag + 2), 0.0);
+
+	for (int lag = minLag; lag <= 2 * maxLag + 1; ++lag)
+		for (int n = lag; n < numFrames; ++n)
+			acf[(size_t)lag] += (double)onsetCurve[(size_t)n] * onsetCurve[(size_t)(n - lag)];
+
+	auto score = [&](int lag)
+	{
+		auto octaves = std::log2((60.0 * frameRate / lag) / 120.0) / 0.7;
+		return std::exp(-0.5 * octaves * octaves) * (acf[(size_t)lag] + 0.5 * acf[(size_t)(2 * lag)]);
+	};
+
+	auto bestLag = minLag;
+	for (int lag = minLag + 1; lag <= maxLag; ++lag)
+		if (score(lag) > score(bestLag))
+			bestLag = lag;
+
+	auto period = (double)bestLag;
+
+	if (bestLag > minLag && bestLag < maxLag)
+	{
+		auto y0 = score(bestLag - 1), y1 = score(bestLag), y2 = score(bestLag + 1);
+		auto denom = y0 - 2.0 * y1 + y2;
+
+		if (denom < 0.0)
+			period += jlimit(-0.5, 0.5, 0.5 * (y0 - y2) / denom);
+	}
+
+	return period;
+}
+
+std::vector<double> TrackAnalysisBuilder::trackBeats(double period) const
+{
+	// Dynamic programming beat tracker: every frame's score is its own onset
+	// strength plus the best predecessor roughly one period back, penalised by how
+	// far that gap is from the period. Backtracking from the best end gives the grid.
+	auto numFrames = (int)onsetCurve.size();
+	std::vector<double> cumulative((size_t)numFrames);
+	std::vector<int> backlink((size_t)numFrames, -1);
+
+	auto searchStart = roundToInt(2.0 * period);
+	auto searchEnd = jmax(1, roundToInt(0.5 * period));
+
+	for (int n = 0; n < numFrames; ++n)
+	{
+		auto best = 0.0;
+		auto bestPrev = -1;
+
+		for (int p = jmax(0, n - searchStart); p <= n - searchEnd; ++p)
+		{
+			auto gap = std::log((double)(n - p) / period);
+			auto candidate = cumulative[(size_t)p] - beatTightness * gap * gap;
+
+			if (bestPrev < 0 || candidate > best)
+			{
+				best = candidate;
+				bestPrev = p;
+			}
+		}
+
+		cumulative[(size_t)n] = onsetCurve[(size_t)n] + (bestPrev >= 0 ? best : 0.0);
+		backlink[(size_t)n] = bestPrev;
+	}
+
+	// The last beat is the best-scoring frame within a period of the end.
+	auto last = numFrames - 1;
+	for (int n = jmax(0, numFrames - roundToInt(period)); n < numFrames; ++n)
+		if (cumulative[(size_t)n] > cumulative[(size_t)last])
+			last = n;
+
+	std::vector<int> beatFrames;
+	for (auto n = last; n >= 0; n = backlink[(size_t)n])
+		beatFrames.push_back(n);
+
+	std::reverse(beatFrames.begin(), beatFrames.end());
+
+	std::vector<double> beats;
+	for (auto f : beatFrames)
+		beats.push_back(frameToSeconds(f));
+
+	return beats;
+}
+
+std::vector<int32> TrackAnalysisBuilder::findDownbeats(const std::vector<double>& beats, int barLength) const
+{
+	std::vector<int32> downbeats;
+	auto numBeats = (int)beats.size();
+
+	if (numBeats < 2 * barLength)
+		return downbeats;
+
+	// Kick drums land on the one far more often than anywhere else in the bar, so
+	// pick the bar offset with the most bass energy on it.
+	std::vector<double> scores((size_t)barLength, 0.0);
+
+	for (int i = 0; i < numBeats; ++i)
+	{
+		auto frame = secondsToFrame(beats[(size_t)i]);
+		auto bass = 0.0f;
+
+		for (int f = jmax(0, frame - 1); f <= jmin((int)bassEnergy.size() - 1, frame + 1); ++f)
+			bass = jmax(bass, bassEnergy[(size_t)f]);
+
+		scores[(size_t)(i % barLength)] += std::sqrt((double)bass);
+	}
+
+	auto offset = (int)(std::max_element(scores.begin(), scores.end()) - scores.begin());
+
+	for (int i = offset; i < numBeats; i += barLength)
+		downbeats.push_back(i);
+
+	return downbeats;
+}
+
+std::vector<double> TrackAnalysisBuilder::findSections(const std::vector<double>& beats, const std::vector<int32>& downbeats) const
+{
+	std::vector<double> boundaries;
+	auto numBars = (int)downbeats.size() - 1;
+
+	if (numBars < 2 * sectionWindowBars)
+		return boundaries;
+
+	// Mean loudness per bar, in dB.
+	std::vector<float> barLevels((size_t)numBars);
+
+	for (int bar = 0; bar < numBars; ++bar)
+	{
+		auto start = secondsToFrame(beats[(size_t)downbeats[(size_t)bar]]);
+		auto end = jmax(start + 1, secondsToFrame(beats[(size_t)downbeats[(size_t)bar + 1]]));
+		auto sum = 0.0f;
+
+		for (int f = start; f < end; ++f)
+			sum += energy[(size_t)f];
+
+		barLevels[(size_t)bar] = Decibels::gainToDecibels(sum / (float)(end - start));
+	}
+
+	// Novelty: how different the next few bars are from the previous few. Section
+	// boundaries are the clear peaks, at least one window apart.
+	std::vector<float> novelty((size_t)numBars, 0.0f);
+
+	for (int bar = sectionWindowBars; bar <= numBars - sectionWindowBars; ++bar)
+	{
+		auto before = std::accumulate(barLevels.begin() + bar - sectionWindowBars, barLevels.begin() + bar, 0.0f);
+		auto after = std::accumulate(barLevels.begin() + bar, barLevels.begin() + bar + sectionWindowBars, 0.0f);
+		novelty[(size_t)bar] = std::abs(after - before) / (float)sectionWindowBars;
+	}
+
+	auto lastBoundary = 0;
+
+	for (int bar = sectionWindowBars; bar <= numBars - sectionWindowBars; ++bar)
+	{
+		auto value = novelty[(size_t)bar];
+
+		if (value < sectionThresholdDb || bar - lastBoundary < sectionWindowBars)
+			continue;
+
+		auto isPeak = true;
+		for (int other = jmax(0, bar - sectionWindowBars / 2); other <= jmin(numBars - 1, bar + sectionWindowBars / 2); ++other)
+			if (novelty[(size_t)other] > value)
+				isPeak = false;
+
+		if (isPeak)
+		{
+			boundaries.push_back(beats[(size_t)downbeats[(size_t)bar]]);
+			lastBoundary = bar;
+		}
+	}
+
+	return boundaries;
+}
+
+void TrackAnalysisBuilder::buildWaveform(TrackAnalysis& result) const
+{
+	std::vector<TrackAnalysis::WaveformLevel> levels;
+	std::vector<TrackAnalysis::WaveformPoint> points(baseWaveform);
+
+	// Include the partial point at the very end of the track.
+	if (pendingSamples > 0)
+		points.push_back({ pendingPoint.minimum, pendingPoint.maximum, std::sqrt(pendingPoint.rms / (float)pendingSamples) });
+
+	levels.push_back({ waveformBaseSamples, 0, (int32)points.size() });
+
+	// Each coarser level merges waveformLevelRatio points of the one below, down
+	// to a level that fits comfortably across a screen.
+	while (levels.back().numPoints > 512)
+	{
+		auto previous = levels.back();
+		TrackAnalysis::WaveformLevel level{ previous.samplesPerPoint * waveformLevelRatio, (int32)points.size(),
+											(previous.numPoints + waveformLevelRatio - 1) / waveformLevelRatio };
+
+		for (int32 i = 0; i < level.numPoints; ++i)
+		{
+			auto first = previous.firstPoint + i * waveformLevelRatio;
+			auto last = jmin(first + waveformLevelRatio, previous.firstPoint + previous.numPoints);
+			TrackAnalysis::WaveformPoint merged = points[(size_t)first];
+			auto sumSquares = 0.0f;
+
+			for (auto p = first; p < last; ++p)
+			{
+				merged.minimum = jmin(merged.minimum, points[(size_t)p].minimum);
+				merged.maximum = jmax(merged.maximum, points[(size_t)p].maximum);
+				sumSquares += points[(size_t)p].rms * points[(size_t)p].rms;
+			}
+
+			merged.rms = std::sqrt(sumSquares / (float)(last - first));
+			points.push_back(merged);
+		}
+
+		levels.push_back(level);
+	}
+
+	result.waveformLevels.assign(std::move(levels));
+	result.waveform.assign(std::move(points));
+}
+
+TrackAnalysis::Loudness TrackAnalysisBuilder::measureLoudness() const
+{
+	TrackAnalysis::Loudness loudness;
+	loudness.peak = Decibels::gainToDecibels(samplePeak);
+	loudness.integrated = loudnessMeter.getIntegratedLoudness();
+	loudness.shortTermMax = loudnessMeter.getMaxShortTermLoudness();
+	loudness.range = loudnessMeter.getLoudnessRange();
+	return loudness;
+}
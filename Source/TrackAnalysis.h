@@ -0,0 +1,184 @@
+/*
+  ==============================================================================
+
+    TrackAnalysis.h
+    Created: 17 Oct 2026 1:05:22pm
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "LoudnessMeter.h"
+#include "ChromaExtractor.h"
+#include <vector>
+
+struct AnalysisFrame;
+
+//==============================================================================
+/**
+	Read-only array that either owns its elements or points into memory owned by
+	someone else, such as a memory-mapped cache file. Moving is cheap and keeps
+	the data where it is; copying isn't allowed.
+*/
+template <typename ElementType>
+class TrackSeries
+{
+public:
+	TrackSeries() = default;
+	TrackSeries(TrackSeries&&) = default;
+	TrackSeries& operator=(TrackSeries&&) = default;
+
+	void assign(std::vector<ElementType>&& elements)
+	{
+		owned = std::move(elements);
+		first = owned.data();
+		count = owned.size();
+	}
+
+	void referTo(const ElementType* elements, size_t numElements)
+	{
+		owned.clear();
+		first = elements;
+		count = numElements;
+	}
+
+	const ElementType* begin() const noexcept	{ return first; }
+	const ElementType* end() const noexcept		{ return first + count; }
+	const ElementType* data() const noexcept	{ return first; }
+	size_t size() const noexcept				{ return count; }
+	bool empty() const noexcept					{ return count == 0; }
+
+	const ElementType& operator[](size_t i) const noexcept	{ return first[i]; }
+	const ElementType& front() const noexcept				{ return first[0]; }
+	const ElementType& back() const noexcept				{ return first[count - 1]; }
+
+private:
+	std::vector<ElementType> owned;
+	const ElementType* first = nullptr;
+	size_t count = 0;
+
+	JUCE_DECLARE_NON_COPYABLE(TrackSeries)
+};
+
+//==============================================================================
+/**
+	Everything we know about a whole track after pre-analysis: beat grid,
+	downbeats, energy envelopes, a waveform overview, loudness and key.
+
+	Built once on a worker thread (or mapped straight out of the AnalysisCache)
+	and then only read, so it can be shared between threads behind a
+	shared_ptr. The lookups are plain binary searches, cheap enough to call
+	every frame from the renderer.
+*/
+struct TrackAnalysis
+{
+	enum { numBands = 4 };
+
+	// Waveform overview: one point summarises samplesPerPoint samples of the mono mix.
+	struct WaveformPoint	{ float minimum, maximum, rms; };
+	struct WaveformLevel	{ int32 samplesPerPoint, firstPoint, numPoints; };
+
+	// Per EBU R128, see LoudnessMeter.
+	struct Loudness
+	{
+		float integrated = -100.0f;		// Gated over the whole track, LUFS
+		float shortTermMax = -100.0f;	// Loudest 3 second window, LUFS
+		float range = 0.0f;				// Spread between quiet and loud passages, LU
+		float peak = -100.0f;			// Sample peak, dBFS
+	};
+
+	double sampleRate = 44100.0;
+	double lengthInSeconds = 0.0;
+	double tempo = 0.0;					// BPM, from the median beat interval
+	int beatsPerBar = 4;
+	int key = -1;						// 0..11 major, 12..23 minor, -1 if unknown; see ChromaExtractor
+	float keyConfidence = 0.0f;			// 0..1
+
+	TrackSeries<double> beats;			// Beat times in seconds
+	TrackSeries<int32> downbeats;		// Indices into beats that start a bar
+	TrackSeries<float> energy;			// RMS envelope
+	TrackSeries<float> bandEnergy;		// numBands RMS values per envelope point, low to high
+	double envelopeRate = 0.0;			// Envelope points per second
+	TrackSeries<double> sections;		// Section start times in seconds, the first is always 0
+
+	TrackSeries<WaveformLevel> waveformLevels;	// Finest first
+	TrackSeries<WaveformPoint> waveform;		// Every level's points, back to back
+
+	Loudness loudness;
+
+	// Keeps a memory-mapped cache file alive while the series above point into it.
+	std::shared_ptr<const void> storage;
+
+	/** Continuous beat count at a transport position: 3.25 is a quarter of the way
+		from the 4th beat to the 5th. Extrapolates outside the grid. */
+	double getBeatPosition(double seconds) const noexcept;
+
+	/** Like getBeatPosition(), but counted from the first downbeat so that whole
+		numbers divisible by beatsPerBar land on bar lines. */
+	double getBarAlignedBeatPosition(double seconds) const noexcept;
+
+	/** The inverse of getBeatPosition(): the time of a continuous beat count. */
+	double getBeatTime(double beatPosition) const noexcept;
+
+	/** Local tempo in BPM around a transport position. */
+	double getTempoAt(double seconds) const noexcept;
+
+	float getEnergyAt(double seconds) const noexcept;
+	float getBandEnergyAt(double seconds, int band) const noexcept;
+	int getSectionIndex(double seconds) const noexcept;
+
+	// Upper edges of the envelope bands, in Hz; the last band runs to Nyquist.
+	static constexpr double bandEdges[numBands - 1] = { 150.0, 800.0, 4000.0 };
+};
+
+//==============================================================================
+/**
+	Collects analysis frames for a whole track and turns them into a
+	TrackAnalysis. Feed it every frame from a FeatureExtractor, in order, then
+	call build().
+*/
+class TrackAnalysisBuilder
+{
+public:
+	TrackAnalysisBuilder(double sampleRate, int hopSize, int numChannels);
+
+	void addFrame(const AnalysisFrame& frame);
+
+	/** Feeds raw audio for the waveform overview, loudness and sample peak. Call
+		with the same audio that went into the FeatureExtractor. */
+	void addSamples(const AudioBuffer<float>& buffer, int numSamples);
+
+	std::shared_ptr<TrackAnalysis> build(double lengthInSeconds);
+
+	// Finest waveform resolution, and how much coarser each further level is.
+	enum { waveformBaseSamples = 256, waveformLevelRatio = 4 };
+
+private:
+	double estimateBeatPeriod() const;
+	std::vector<double> trackBeats(double period) const;
+	std::vector<int32> findDownbeats(const std::vector<double>& beats, int beatsPerBar) const;
+	std::vector<double> findSections(const std::vector<double>& beats, const std::vector<int32>& downbeats) const;
+	void buildWaveform(TrackAnalysis& result) const;
+	TrackAnalysis::Loudness measureLoudness() const;
+
+	double frameToSeconds(int frame) const noexcept;
+	int secondsToFrame(double seconds) const noexcept;
+
+	double sampleRate, frameRate;
+	int hopSize;
+
+	std::vector<float> onsetCurve, bassEnergy, energy, bandEnergy;
+	float chromaSum[ChromaExtractor::numPitchClasses] = {};	// Energy-weighted chroma of the whole track, C to B
+
+	std::vector<TrackAnalysis::WaveformPoint> baseWaveform;
+	TrackAnalysis::WaveformPoint pendingPoint{ 0.0f, 0.0f, 0.0f };
+	int pendingSamples = 0;
+	float samplePeak = 0.0f;
+
+	LoudnessMeter loudnessMeter;
+
+	JUCE_DECLARE_NON_COPYABLE(TrackAnalysisBuilder)
+};
@@ -0,0 +1,113 @@
+/*
+  ==============================================================================
+
+    TrackAnalysisJob.cpp
+    Created: 17 Oct 2026 1:48:09pm
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#include "TrackAnalysisJob.h"
+#include "AnalysisCache.h"
+#include "FeatureExtractor.h"
+
+TrackAnalysisJob::TrackAnalysisJob(const File& audioFile, AudioFormatReader* readerToAnalyse,
+								   std::atomic<float>& progressToUpdate, Callback onFinished)
+	: ThreadPoolJob("Track analysis"),
+	  file(audioFile),
+	  reader(readerToAnalyse),
+	  progress(progressToUpdate),
+	  finished(std::move(onFinished))
+{
+}
+
+ThreadPoolJob::JobStatus TrackAnalysisJob::runJob()
+{
+	if (reader == nullptr || reader->lengthInSamples <= 0)
+		return jobHasFinished;
+
+	// A stem set's folder has no one file to hash; its stems are cached one by one instead.
+	if (file.isDirectory())
+	{
+		if (onCacheMiss)
+			onCacheMiss();
+
+		auto analysis = analyse();
+
+		if (analysis != nullptr && !shouldExit() && finished)
+			finished(std::move(analysis));
+
+		return jobHasFinished;
+	}
+
+	auto hash = AnalysisCache::hashFile(file);
+
+	if (shouldExit())
+		return jobHasFinished;
+
+	// A file we couldn't hash can still be analysed, just not cached.
+	auto cacheResult = Result::fail("Couldn't read " + file.getFileName() + " to hash it");
+	std::shared_ptr<TrackAnalysis> analysis;
+
+	if (hash.getSize() > 0)
+		analysis = AnalysisCache::load(file, hash, cacheResult);
+
+	if (analysis == nullptr)
+	{
+		DBG("Analysing " + file.getFileName() + ": " + cacheResult.getErrorMessage());
+
+		if (onCacheMiss)
+			onCacheMiss();
+
+		analysis = analyse();
+
+		if (analysis == nullptr)
+			return jobHasFinished;
+
+		auto saveResult = hash.getSize() > 0 ? AnalysisCache::save(*analysis, file, hash)
+											 : Result::fail("No hash to key it by");
+
+		if (saveResult.failed())
+		{
+			DBG("Couldn't cache analysis: " + saveResult.getErrorMessage());
+
+			if (onSaveFailed)
+				onSaveFailed(saveResult);
+		}
+	}
+
+	if (!shouldExit() && finished)
+		finished(std::move(analysis));
+
+	return jobHasFinished;
+}
+
+std::shared_ptr<TrackAnalysis> TrackAnalysisJob::analyse()
+{
+	auto numChannels = jmin(2, (int)reader->numChannels);
+	auto length = reader->lengthInSamples;
+
+	FeatureExtractor extractor;
+	extractor.prepare(reader->sampleRate, numChannels);
+
+	TrackAnalysisBuilder builder(reader->sampleRate, FeatureExtractor::hopSize, numChannels);
+	FeatureExtractor::FrameCallback addFrame = [&builder](const AnalysisFrame& frame) { builder.addFrame(frame); };
+
+	AudioBuffer<float> buffer(numChannels, samplesPerRead);
+
+	for (int64 position = 0; position < length; position += samplesPerRead)
+	{
+		if (shouldExit())
+			return nullptr;
+
+		auto numSamples = (int)jmin((int64)samplesPerRead, length - position);
+		reader->read(&buffer, 0, numSamples, position, true, numChannels > 1);
+		extractor.process(buffer, numSamples, addFrame);
+		builder.addSamples(buffer, numSamples);
+
+		progress.store((float)(position + numSamples) / (float)length, std::memory_order_relaxed);
+	}
+
+	return builder.build((double)length / reader->sampleRate);
+}
@@ -0,0 +1,62 @@
+/*
+  ==============================================================================
+
+    TrackAnalysisJob.h
+    Created: 17 Oct 2026 1:48:09pm
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "TrackAnalysis.h"
+#include <functional>
+
+//==============================================================================
+/**
+	Decodes a whole file as fast as the disk and decoder allow and runs it
+	through the same FeatureExtractor the live analysis uses, then builds a
+	TrackAnalysis from the result.
+
+	If the AnalysisCache already has the track, the cached analysis is mapped
+	and delivered instead. A fresh analysis is written to the cache, unless
+	it's of a stem set's folder.
+
+	Progress (0..1) is written to an atomic the owner can poll. The finished
+	analysis is handed to the callback on the worker thread; nothing is called
+	if the job is cancelled.
+*/
+class TrackAnalysisJob : public ThreadPoolJob
+{
+public:
+	using Callback = std::function<void(std::shared_ptr<TrackAnalysis>)>;
+
+	/** Takes ownership of the reader, which must be reading audioFile. */
+	TrackAnalysisJob(const File& audioFile, AudioFormatReader* readerToAnalyse,
+					 std::atomic<float>& progressToUpdate, Callback onFinished);
+
+	JobStatus runJob() override;
+
+	/** Called on the worker thread once it's clear the cache can't help, just
+		before the track is analysed, so anything the cached analysis would
+		have brought can be worked out in parallel. */
+	std::function<void()> onCacheMiss;
+
+	/** Called on the worker thread, before the callback, if a fresh analysis
+		couldn't be written to the cache. The analysis is still delivered. */
+	std::function<void(const Result&)> onSaveFailed;
+
+private:
+	std::shared_ptr<TrackAnalysis> analyse();
+
+	File file;
+	std::unique_ptr<AudioFormatReader> reader;
+	std::atomic<float>& progress;
+	Callback finished;
+
+	enum { samplesPerRead = 65536 };
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TrackAnalysisJob)
+};
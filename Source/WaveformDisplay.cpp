@@ -0,0 +1,121 @@
+/*
+  ==============================================================================
+
+    WaveformDisplay.cpp
+    Created: 17 Oct 2026 8:40:17pm
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#include "WaveformDisplay.h"
+
+WaveformDisplay::WaveformDisplay()
+{
+	setOpaque(true);
+	startTimerHz(30);
+}
+
+void WaveformDisplay::setWaveform(std::shared_ptr<const WaveformPyramid> newWaveform)
+{
+	if (newWaveform == waveform)
+		return;
+
+	waveform = std::move(newWaveform);
+	zoom = 1.0;
+	repaint();
+}
+
+Range<double> WaveformDisplay::getVisibleRange() const
+{
+	auto length = waveform->lengthInSamples / waveform->sampleRate;
+	auto span = length * zoom;
+
+	if (span >= length)
+		return { 0.0, length };
+
+	// Keep the playhead a third of the way in, so what's coming up is visible.
+	auto position = getPosition != nullptr ? getPosition() : 0.0;
+	auto start = jlimit(0.0, length - span, position - span / 3.0);
+	return { start, start + span };
+}
+
+void WaveformDisplay::paint(Graphics& g)
+{
+	g.fillAll(Colours::black);
+
+	if (waveform == nullptr)
+		return;
+
+	g.setColour(Colours::grey);
+	g.setFont(12.0f);
+
+	if (!waveform->isComplete())
+	{
+		g.drawText("Summarising waveform: " + String(roundToInt(waveform->getProgress() * 100.0f)) + "%",
+			getLocalBounds(), Justification::centred);
+		return;
+	}
+
+	auto visible = getVisibleRange();
+	auto width = getWidth();
+	auto centre = getHeight() * 0.5f;
+	auto halfHeight = getHeight() * 0.5f - 1.0f;
+	auto samplesPerPixel = visible.getLength() * waveform->sampleRate / width;
+	auto firstSample = visible.getStart() * waveform->sampleRate;
+
+	for (int x = 0; x < width; ++x)
+	{
+		auto start = (int64)(firstSample + x * samplesPerPixel);
+		auto end = (int64)(firstSample + (x + 1) * samplesPerPixel);
+
+		if (start >= waveform->lengthInSamples)
+			break;
+
+		auto point = waveform->getRange(start, end);
+
+		g.setColour(Colours::steelblue);
+		g.drawVerticalLine(x, centre - point.maximum * halfHeight, centre - point.minimum * halfHeight + 1.0f);
+
+		g.setColour(Colours::lightblue);
+		g.drawVerticalLine(x, centre - point.rms * halfHeight, centre + point.rms * halfHeight + 1.0f);
+	}
+
+	if (getPosition != nullptr)
+	{
+		auto x = (float)((getPosition() - visible.getStart()) / visible.getLength() * width);
+		g.setColour(Colours::white);
+		g.drawVerticalLine(roundToInt(x), 0.0f, (float)getHeight());
+	}
+
+	if (zoom < 1.0)
+		g.drawText(String(visible.getLength(), 1) + " s", getLocalBounds().reduced(4, 2), Justification::topRight);
+}
+
+void WaveformDisplay::mouseDown(const MouseEvent& e)
+{
+	if (waveform == nullptr || !waveform->isComplete() || onSeek == nullptr)
+		return;
+
+	auto visible = getVisibleRange();
+	onSeek(visible.getStart() + visible.getLength() * e.position.x / getWidth());
+}
+
+void WaveformDisplay::mouseWheelMove(const MouseEvent&, const MouseWheelDetails& wheel)
+{
+	if (waveform == nullptr)
+		return;
+
+	auto length = waveform->lengthInSamples / waveform->sampleRate;
+	auto minZoom = jmin(1.0, minVisibleSeconds / length);
+
+	zoom = jlimit(minZoom, 1.0, zoom * std::pow(0.5, wheel.deltaY * 4.0));
+	repaint();
+}
+
+void WaveformDisplay::timerCallback()
+{
+	// The playhead moves, and an incomplete waveform shows its progress.
+	if (waveform != nullptr && isShowing())
+		repaint();
+}
@@ -0,0 +1,58 @@
+/*
+  ==============================================================================
+
+    WaveformDisplay.h
+    Created: 17 Oct 2026 8:40:17pm
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "WaveformPyramid.h"
+#include <functional>
+
+//==============================================================================
+/**
+	Draws the current track's waveform from its WaveformPyramid, with the
+	playhead. Each column is one getRange() lookup, so drawing costs the same
+	at any zoom.
+
+	The mouse wheel zooms from the whole track down to a couple of seconds
+	around the playhead; clicking seeks there.
+*/
+class WaveformDisplay : public Component,
+						private Timer
+{
+public:
+	WaveformDisplay();
+
+	/** Shows a new track's waveform, or nothing for nullptr. Resets the zoom. */
+	void setWaveform(std::shared_ptr<const WaveformPyramid> newWaveform);
+	const std::shared_ptr<const WaveformPyramid>& getWaveform() const noexcept { return waveform; }
+
+	// Playback position in seconds, polled for the playhead.
+	std::function<double()> getPosition;
+	// Called with the position clicked on, in seconds.
+	std::function<void(double)> onSeek;
+
+	void paint(Graphics& g) override;
+	void mouseDown(const MouseEvent& e) override;
+	void mouseWheelMove(const MouseEvent& e, const MouseWheelDetails& wheel) override;
+
+	// Shortest span the zoom goes down to, in seconds.
+	static constexpr double minVisibleSeconds = 2.0;
+
+private:
+	void timerCallback() override;
+
+	/** The span of the track shown, in seconds: all of it, or a window that follows the playhead. */
+	Range<double> getVisibleRange() const;
+
+	std::shared_ptr<const WaveformPyramid> waveform;
+	double zoom = 1.0;		// Fraction of the track shown
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WaveformDisplay)
+};
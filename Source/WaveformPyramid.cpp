@@ -0,0 +1,220 @@
+/*
+  ==============================================================================
+
+    WaveformPyramid.cpp
+    Created: 17 Oct 2026 8:12:40pm
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#include "WaveformPyramid.h"
+#include "MeterKernels.h"
+
+//==============================================================================
+class WaveformPyramid::SummariseJob : public ThreadPoolJob
+{
+public:
+	SummariseJob(std::shared_ptr<WaveformPyramid> pyramidToFill, AudioFormatReader* readerToUse)
+		: ThreadPoolJob("Waveform"), pyramid(std::move(pyramidToFill)), reader(readerToUse)
+	{
+	}
+
+	JobStatus runJob() override
+	{
+		AudioBuffer<float> buffer(jlimit(1, 2, (int)reader->numChannels), chunkSamples);
+
+		while (!shouldExit() && !pyramid->cancelled.load())
+		{
+			auto chunk = pyramid->nextChunk++;
+
+			if (chunk >= pyramid->numChunks)
+				break;
+
+			pyramid->summariseChunk(*reader, buffer, chunk);
+			pyramid->finishChunk();
+		}
+
+		return jobHasFinished;
+	}
+
+private:
+	std::shared_ptr<WaveformPyramid> pyramid;
+	std::unique_ptr<AudioFormatReader> reader;
+};
+
+//==============================================================================
+WaveformPyramid::WaveformPyramid(double rate, int64 length)
+	: sampleRate(rate),
+	  lengthInSamples(length),
+	  startTime(Time::getMillisecondCounterHiRes())
+{
+	int64 samplesPerPoint = baseSamples;
+
+	// Like the TrackAnalysis overview: coarser and coarser until a level fits across a screen.
+	for (;;)
+	{
+		auto numPoints = (lengthInSamples + samplesPerPoint - 1) / samplesPerPoint;
+		levels.push_back({ samplesPerPoint, std::vector<Point>((size_t)numPoints) });
+
+		if (samplesPerPoint <= chunkSamples)
+			numChunkLevels = (int)levels.size();
+
+		if (numPoints <= maxCoarsestPoints)
+			break;
+
+		samplesPerPoint *= levelRatio;
+	}
+
+	numChunks = (int)((lengthInSamples + chunkSamples - 1) / chunkSamples);
+}
+
+WaveformPyramid::WaveformPyramid(const TrackAnalysis& analysis)
+	: sampleRate(analysis.sampleRate),
+	  lengthInSamples((int64)(analysis.lengthInSeconds * analysis.sampleRate + 0.5)),
+	  startTime(Time::getMillisecondCounterHiRes())
+{
+	for (auto& level : analysis.waveformLevels)
+	{
+		auto* first = analysis.waveform.begin() + level.firstPoint;
+		levels.push_back({ level.samplesPerPoint, std::vector<Point>(first, first + level.numPoints) });
+	}
+
+	numChunkLevels = (int)levels.size();
+	numChunks = chunksDone = 1;
+	complete = true;
+}
+
+std::shared_ptr<WaveformPyramid> WaveformPyramid::create(ThreadPool& pool, int numJobs,
+														 const std::function<AudioFormatReader*()>& createReader)
+{
+	std::unique_ptr<AudioFormatReader> firstReader(createReader());
+
+	if (firstReader == nullptr || firstReader->lengthInSamples <= 0)
+		return nullptr;
+
+	std::shared_ptr<WaveformPyramid> pyramid(new WaveformPyramid(firstReader->sampleRate, firstReader->lengthInSamples));
+	pool.addJob(new SummariseJob(pyramid, firstReader.release()), true);
+
+	// More jobs than chunks would only sit idle.
+	numJobs = jmin(numJobs, pyramid->numChunks);
+
+	for (int i = 1; i < numJobs; ++i)
+		if (auto* reader = createReader())
+			pool.addJob(new SummariseJob(pyramid, reader), true);
+
+	return pyramid;
+}
+
+std::shared_ptr<WaveformPyramid> WaveformPyramid::fromAnalysis(const TrackAnalysis& analysis)
+{
+	if (analysis.waveformLevels.empty() || analysis.sampleRate <= 0.0 || analysis.lengthInSeconds <= 0.0)
+		return nullptr;
+
+	return std::shared_ptr<WaveformPyramid>(new WaveformPyramid(analysis));
+}
+
+void WaveformPyramid::summariseChunk(AudioFormatReader& reader, AudioBuffer<float>& buffer, int chunk)
+{
+	auto startSample = (int64)chunk * chunkSamples;
+	auto numSamples = (int)jmin((int64)chunkSamples, lengthInSamples - startSample);
+
+	reader.read(&buffer, 0, numSamples, startSample, true, true);
+
+	// Mono mix, in place in the left channel.
+	auto* mono = buffer.getWritePointer(0);
+
+	if (buffer.getNumChannels() > 1)
+	{
+		FloatVectorOperations::add(mono, buffer.getReadPointer(1), numSamples);
+		FloatVectorOperations::multiply(mono, 0.5f, numSamples);
+	}
+
+	auto& kernels = MeterKernels::get();
+	auto* point = levels[0].points.data() + startSample / baseSamples;
+
+	for (int i = 0; i < numSamples; i += baseSamples, ++point)
+	{
+		auto num = jmin((int)baseSamples, numSamples - i);
+		auto range = FloatVectorOperations::findMinAndMax(mono + i, num);
+
+		*point = { range.getStart(), range.getEnd(), std::sqrt(kernels.sumSquares(mono + i, num) / (float)num) };
+	}
+
+	// A chunk is a whole number of points on these levels, so no other job touches them.
+	for (int level = 1; level < numChunkLevels; ++level)
+	{
+		auto samplesPerPoint = levels[(size_t)level].samplesPerPoint;
+		mergeLevel(level, startSample / samplesPerPoint, (startSample + numSamples + samplesPerPoint - 1) / samplesPerPoint);
+	}
+}
+
+void WaveformPyramid::mergeLevel(int level, int64 firstPoint, int64 endPoint)
+{
+	auto& below = levels[(size_t)level - 1].points;
+	auto& points = levels[(size_t)level].points;
+	auto numBelow = (int64)below.size();
+
+	for (auto p = firstPoint; p < endPoint; ++p)
+	{
+		auto first = p * levelRatio;
+		auto last = jmin(first + levelRatio, numBelow);
+		auto merged = below[(size_t)first];
+		auto sumSquares = 0.0f;
+
+		for (auto i = first; i < last; ++i)
+		{
+			merged.minimum = jmin(merged.minimum, below[(size_t)i].minimum);
+			merged.maximum = jmax(merged.maximum, below[(size_t)i].maximum);
+			sumSquares += below[(size_t)i].rms * below[(size_t)i].rms;
+		}
+
+		merged.rms = std::sqrt(sumSquares / (float)(last - first));
+		points[(size_t)p] = merged;
+	}
+}
+
+void WaveformPyramid::finishChunk()
+{
+	// The job that finishes the last chunk sees everyone else's and does the rest.
+	if (++chunksDone != numChunks || cancelled.load())
+		return;
+
+	for (auto level = numChunkLevels; level < (int)levels.size(); ++level)
+		mergeLevel(level, 0, (int64)levels[(size_t)level].points.size());
+
+	buildTime = (Time::getMillisecondCounterHiRes() - startTime) * 0.001;
+	complete.store(true, std::memory_order_release);
+}
+
+WaveformPyramid::Point WaveformPyramid::getRange(int64 startSample, int64 endSample) const noexcept
+{
+	jassert(isComplete());
+
+	startSample = jlimit((int64)0, lengthInSamples - 1, startSample);
+	endSample = jlimit(startSample + 1, lengthInSamples, endSample);
+
+	// Coarsest level with a point no longer than the range.
+	auto level = (int)levels.size() - 1;
+
+	while (level > 0 && levels[(size_t)level].samplesPerPoint > endSample - startSample)
+		--level;
+
+	auto& points = levels[(size_t)level].points;
+	auto samplesPerPoint = levels[(size_t)level].samplesPerPoint;
+	auto first = startSample / samplesPerPoint;
+	auto last = (endSample - 1) / samplesPerPoint;
+
+	auto result = points[(size_t)first];
+	auto sumSquares = 0.0f;
+
+	for (auto p = first; p <= last; ++p)
+	{
+		result.minimum = jmin(result.minimum, points[(size_t)p].minimum);
+		result.maximum = jmax(result.maximum, points[(size_t)p].maximum);
+		sumSquares += points[(size_t)p].rms * points[(size_t)p].rms;
+	}
+
+	result.rms = std::sqrt(sumSquares / (float)(last - first + 1));
+	return result;
+}
@@ -0,0 +1,107 @@
+/*
+  ==============================================================================
+
+    WaveformPyramid.h
+    Created: 17 Oct 2026 8:12:40pm
+    Author:  ClintonK
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "TrackAnalysis.h"
+#include <functional>
+#include <vector>
+
+//==============================================================================
+/**
+	Min/max/RMS summaries of a track's mono mix at several zoom levels, so a
+	waveform can be drawn at any scale without going back to the samples.
+
+	The finest level has one point per baseSamples samples and each further
+	level is levelRatio times coarser. create() splits the track into chunks
+	and summarises them on a thread pool: every job has its own reader and
+	keeps claiming the next chunk until none are left. A chunk is a whole
+	number of points on every level up to chunkSamples, so each job also
+	builds those levels for its own chunks; only the few levels coarser than
+	a chunk are left for whichever job finishes last.
+
+	A track the AnalysisCache already has doesn't need any of that:
+	fromAnalysis() takes the coarser overview its TrackAnalysis carries.
+
+	Nothing may be read until isComplete(). After that it never changes and
+	can be shared between threads.
+*/
+class WaveformPyramid
+{
+public:
+	using Point = TrackAnalysis::WaveformPoint;
+
+	enum
+	{
+		baseSamples = 64,
+		levelRatio = 4,
+		chunkSamples = baseSamples * 4096,	// levelRatio^6 base points
+		maxCoarsestPoints = 512
+	};
+
+	/** Starts summarising a track on the pool with numJobs jobs, each reading
+		through its own reader from createReader. Returns nullptr if there's
+		nothing to read. The pyramid is filled in the background from then on. */
+	static std::shared_ptr<WaveformPyramid> create(ThreadPool& pool, int numJobs,
+												   const std::function<AudioFormatReader*()>& createReader);
+
+	/** A pyramid that's complete straight away, copied from the waveform levels
+		of a track's analysis. Its finest level is the analysis's, one point per
+		TrackAnalysisBuilder::waveformBaseSamples. Returns nullptr if the
+		analysis has no waveform. */
+	static std::shared_ptr<WaveformPyramid> fromAnalysis(const TrackAnalysis& analysis);
+
+	bool isComplete() const noexcept		{ return complete.load(std::memory_order_acquire); }
+	float getProgress() const noexcept		{ return (float)chunksDone.load() / (float)numChunks; }
+	/** Stops the jobs at their next chunk. The pyramid is never completed. */
+	void cancel() noexcept					{ cancelled = true; }
+
+	/** Min, max and RMS of the samples in [startSample, endSample), taken from
+		the coarsest level that still has at least one point in that range. */
+	Point getRange(int64 startSample, int64 endSample) const noexcept;
+
+	int getNumLevels() const noexcept							{ return (int)levels.size(); }
+	int64 getSamplesPerPoint(int level) const noexcept			{ return levels[(size_t)level].samplesPerPoint; }
+	const std::vector<Point>& getPoints(int level) const noexcept	{ return levels[(size_t)level].points; }
+
+	const double sampleRate;
+	const int64 lengthInSamples;
+
+	// Time from create() until complete, in seconds. For judging pool sizes.
+	double getBuildTime() const noexcept	{ return buildTime.load(); }
+
+private:
+	WaveformPyramid(double sampleRate, int64 lengthInSamples);
+	explicit WaveformPyramid(const TrackAnalysis& analysis);
+
+	class SummariseJob;
+
+	void summariseChunk(AudioFormatReader& reader, AudioBuffer<float>& buffer, int chunk);
+	void mergeLevel(int level, int64 firstPoint, int64 endPoint);
+	void finishChunk();
+
+	struct Level
+	{
+		int64 samplesPerPoint;
+		std::vector<Point> points;
+	};
+
+	std::vector<Level> levels;
+	int numChunkLevels = 0;		// Levels whose points never straddle a chunk
+	int numChunks = 0;
+
+	std::atomic<int> nextChunk{ 0 }, chunksDone{ 0 };
+	std::atomic<bool> complete{ false }, cancelled{ false };
+	std::atomic<double> buildTime{ 0.0 };
+	const double startTime;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WaveformPyramid)
+};
@@ -24,7 +24,7 @@
 
 #include <map>
 
-#include "../JuceLibraryCode/JuceHeader.h"
+#include <JuceHeader.h>
 
 //==============================================================================
 /**